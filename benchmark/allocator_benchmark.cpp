@@ -0,0 +1,99 @@
+#include "sqlite_wrapper/allocator.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <benchmark/benchmark.h>
+
+#include <sqlite3.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+namespace
+{
+  constexpr std::int64_t row_count{1'000};
+
+  constexpr auto select_sql{R"(SELECT "Id", "Data" FROM "Test" WHERE "Id" BETWEEN ? AND ? + 10)"sv};
+
+  /**
+   * Configures the allocator selected by state.range(0), 0 = allocator_kind::sqlite_default,
+   * 1 = allocator_kind::thread_caches, 2 = allocator_kind::memory_resource with \p resource.
+   */
+  void configure_allocator(const benchmark::State& state, std::pmr::memory_resource& resource)
+  {
+    (void)::sqlite3_shutdown();
+
+    switch (state.range(0))
+    {
+      case 1:
+        sqlite_wrapper::configure_allocator({.kind = sqlite_wrapper::allocator_kind::thread_caches});
+        break;
+      case 2:
+        sqlite_wrapper::configure_allocator({.kind = sqlite_wrapper::allocator_kind::memory_resource, .resource = &resource});
+        break;
+      default:
+        sqlite_wrapper::configure_allocator({.kind = sqlite_wrapper::allocator_kind::sqlite_default});
+        break;
+    }
+  }
+
+  /**
+   * Prepares, steps through and finalizes a statement per iteration, the allocations of parsing and of the statement
+   * dominate like in applications not caching prepared statements.
+   */
+  void prepare_and_step(benchmark::State& state)
+  {
+    std::pmr::synchronized_pool_resource resource;
+
+    configure_allocator(state, resource);
+
+    const auto metrics_before{sqlite_wrapper::get_allocator_metrics()};
+
+    {
+      const auto database{sqlite_wrapper::open(":memory:")};
+
+      sqlite_wrapper::execute_no_data(database.get(), R"(CREATE TABLE "Test" ("Id" INTEGER PRIMARY KEY, "Data" TEXT))");
+      sqlite_wrapper::execute_no_data(database.get(), "BEGIN");
+
+      for (std::int64_t id{0}; id < row_count; ++id)
+      {
+        sqlite_wrapper::execute_no_data(database.get(), R"(INSERT INTO "Test" VALUES (?, printf('data %d', random())))", id);
+      }
+
+      sqlite_wrapper::execute_no_data(database.get(), "COMMIT");
+
+      std::int64_t id{0};
+
+      for ([[maybe_unused]] auto _ : state)
+      {
+        const auto stmt{sqlite_wrapper::create_prepared_statement(database.get(), select_sql)};
+
+        sqlite_wrapper::reset_and_rebind_prepared_statement(stmt.get(), id, id);
+
+        while (sqlite_wrapper::step(stmt.get()))
+        {
+          benchmark::DoNotOptimize(::sqlite3_column_text(stmt.get(), 1));
+        }
+
+        id = (id + 1) % row_count;
+      }
+    }
+
+    const auto metrics_after{sqlite_wrapper::get_allocator_metrics()};
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(metrics_after.allocations - metrics_before.allocations), benchmark::Counter::kAvgIterations);
+    state.counters["cached"] = benchmark::Counter(
+        static_cast<double>(metrics_after.cached_allocations - metrics_before.cached_allocations),
+        benchmark::Counter::kAvgIterations);
+
+    // the resource is destroyed next, later benchmarks use the allocator of SQLite again
+    (void)::sqlite3_shutdown();
+    sqlite_wrapper::configure_allocator({.kind = sqlite_wrapper::allocator_kind::sqlite_default});
+  }
+  BENCHMARK(prepare_and_step)->ArgName("allocator")->Arg(0)->Arg(1)->Arg(2);
+}  // unnamed namespace
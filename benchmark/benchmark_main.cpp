@@ -0,0 +1,31 @@
+#include "sqlite_wrapper/compile_options.h"
+#include "sqlite_wrapper/format.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+auto main(int argc, char** argv) -> int
+{
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+  {
+    return 1;
+  }
+
+  std::string compile_options;
+  for (const auto& option : sqlite_wrapper::get_compile_options())
+  {
+    compile_options += (compile_options.empty() ? "" : " ") + option;
+  }
+
+  benchmark::AddCustomContext("sqlite_version", std::string{sqlite_wrapper::get_sqlite_version()});
+  benchmark::AddCustomContext("sqlite_threading_mode", sqlite_wrapper::format("{}", sqlite_wrapper::get_threading_mode()));
+  benchmark::AddCustomContext("sqlite_compile_options", compile_options);
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  return 0;
+}
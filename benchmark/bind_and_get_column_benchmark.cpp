@@ -0,0 +1,167 @@
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+using namespace std::string_view_literals;
+
+namespace
+{
+  constexpr auto create_table_sql{
+      R"(CREATE TABLE "Bench" ("Int" INTEGER NOT NULL, "Double" REAL NOT NULL, "String" TEXT NOT NULL, "Blob" BLOB NOT NULL,
+         "OptInt" INTEGER, "OptDouble" REAL, "OptString" TEXT, "OptBlob" BLOB))"sv};
+  constexpr auto insert_sql{
+      R"(INSERT INTO "Bench" ("Int", "Double", "String", "Blob", "OptInt", "OptDouble", "OptString", "OptBlob")
+         VALUES (?, ?, ?, ?, ?, ?, ?, ?))"sv};
+  constexpr auto select_sql{R"(SELECT * FROM "Bench")"sv};
+
+  using row_type = std::tuple<std::int64_t, double, std::string, sqlite_wrapper::byte_vector, std::optional<std::int64_t>,
+                              std::optional<double>, std::optional<std::string>, std::optional<sqlite_wrapper::byte_vector>>;
+
+  constexpr auto column_count{static_cast<std::int64_t>(std::tuple_size_v<row_type>)};
+
+  auto make_row(std::int64_t value) -> row_type
+  {
+    const std::string text{"some text of moderate length"};
+    const sqlite_wrapper::byte_vector blob(32, std::byte{0x5a});
+
+    return {value, static_cast<double>(value) / 3.0, text, blob, value, std::nullopt, text, std::nullopt};
+  }
+
+  auto set_up_database(std::size_t row_count) -> sqlite_wrapper::database
+  {
+    auto database{sqlite_wrapper::open(":memory:")};
+
+    sqlite_wrapper::execute_no_data(database.get(), create_table_sql);
+
+    const auto stmt{sqlite_wrapper::create_prepared_statement(database.get(), insert_sql)};
+
+    for (std::size_t i{0}; i < row_count; ++i)
+    {
+      const auto [int_value, double_value, string_value, blob_value, opt_int, opt_double, opt_string, opt_blob] =
+          make_row(static_cast<std::int64_t>(i));
+
+      sqlite_wrapper::reset_and_rebind_prepared_statement(stmt.get(), int_value, double_value, string_value, blob_value, opt_int,
+                                                          opt_double, opt_string, opt_blob);
+      (void)sqlite_wrapper::step(stmt.get());
+    }
+
+    return database;
+  }
+
+  /**
+   * Binds one full row of parameters per iteration, without executing the statement.
+   */
+  void bind_row(benchmark::State& state)
+  {
+    const auto database{set_up_database(0)};
+    const auto stmt{sqlite_wrapper::create_prepared_statement(database.get(), insert_sql)};
+    const auto [int_value, double_value, string_value, blob_value, opt_int, opt_double, opt_string, opt_blob] = make_row(4711);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+      sqlite_wrapper::reset_and_rebind_prepared_statement(stmt.get(), int_value, double_value, string_value, blob_value, opt_int,
+                                                          opt_double, opt_string, opt_blob);
+    }
+
+    state.SetItemsProcessed(state.iterations() * column_count);
+  }
+  BENCHMARK(bind_row);
+
+  /**
+   * Binds a range of integer parameters per iteration, without executing the statement.
+   */
+  void bind_int64_range(benchmark::State& state)
+  {
+    const auto database{set_up_database(0)};
+    const auto parameter_count{static_cast<std::size_t>(state.range(0))};
+
+    std::string sql{"SELECT ?"};
+    for (std::size_t i{1}; i < parameter_count; ++i)
+    {
+      sql += ", ?";
+    }
+
+    const auto stmt{sqlite_wrapper::create_prepared_statement(database.get(), sql)};
+    const std::vector<std::int64_t> values(parameter_count, 4711);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+      sqlite_wrapper::reset_and_rebind_prepared_statement(stmt.get(), values);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(bind_int64_range)->Arg(8)->Arg(64)->Arg(512);
+
+  /**
+   * Decodes all columns of the current result row per iteration, without stepping.
+   */
+  void get_row(benchmark::State& state)
+  {
+    const auto database{set_up_database(1)};
+    const auto stmt{sqlite_wrapper::create_prepared_statement(database.get(), select_sql)};
+
+    if (!sqlite_wrapper::step(stmt.get()))
+    {
+      state.SkipWithError("no result row");
+      return;
+    }
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+      benchmark::DoNotOptimize(sqlite_wrapper::get_row<row_type>(stmt.get()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * column_count);
+  }
+  BENCHMARK(get_row);
+
+  /**
+   * Decodes only the integer column of the current result row per iteration, without stepping.
+   */
+  void get_int64_column(benchmark::State& state)
+  {
+    const auto database{set_up_database(1)};
+    const auto stmt{sqlite_wrapper::create_prepared_statement(database.get(), R"(SELECT "Int" FROM "Bench")"sv)};
+
+    if (!sqlite_wrapper::step(stmt.get()))
+    {
+      state.SkipWithError("no result row");
+      return;
+    }
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+      benchmark::DoNotOptimize(sqlite_wrapper::get_row<std::tuple<std::int64_t>>(stmt.get()));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(get_int64_column);
+
+  /**
+   * Full query including stepping through all rows.
+   */
+  void execute_select(benchmark::State& state)
+  {
+    const auto row_count{static_cast<std::size_t>(state.range(0))};
+    const auto database{set_up_database(row_count)};
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+      benchmark::DoNotOptimize(sqlite_wrapper::execute<row_type>(database.get(), select_sql));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) * column_count);
+  }
+  BENCHMARK(execute_select)->Arg(1000);
+}  // unnamed namespace
@@ -0,0 +1,90 @@
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+namespace
+{
+  constexpr std::int64_t row_count{100'000};
+
+  constexpr auto select_sql{R"(SELECT "Data" FROM "Reference" WHERE "Id" = ?)"sv};
+
+  const auto db_file_name{(std::filesystem::temp_directory_path() / "sqlite_wrapper_immutable_benchmark.db").string()};
+
+  void create_reference_database()
+  {
+    std::filesystem::remove(db_file_name);
+
+    const auto database{sqlite_wrapper::open(db_file_name, sqlite_wrapper::open_options::bulk_load())};
+
+    sqlite_wrapper::execute_no_data(database.get(),
+                                    R"(CREATE TABLE "Reference" ("Id" INTEGER PRIMARY KEY, "Data" TEXT NOT NULL))");
+    sqlite_wrapper::execute_no_data(database.get(), "BEGIN");
+
+    const auto stmt{sqlite_wrapper::create_prepared_statement(
+        database.get(), R"(INSERT INTO "Reference" VALUES (?, printf('reference data %d', random())))")};
+
+    for (std::int64_t id{1}; id <= row_count; ++id)
+    {
+      sqlite_wrapper::reset_and_rebind_prepared_statement(stmt.get(), id);
+      (void)sqlite_wrapper::step(stmt.get());
+    }
+
+    sqlite_wrapper::execute_no_data(database.get(), "COMMIT");
+  }
+
+  /**
+   * Opens the reference database as selected by state.range(0), 0 = read_only, 1 = read_only with memory-mapped I/O of
+   * the whole file, 2 = open_immutable().
+   */
+  auto open_reference_database(const benchmark::State& state) -> sqlite_wrapper::database
+  {
+    const auto file_size{static_cast<std::int64_t>(std::filesystem::file_size(db_file_name))};
+
+    switch (state.range(0))
+    {
+      case 1:
+        return sqlite_wrapper::open(
+            db_file_name, {.flags = sqlite_wrapper::open_flags::open_only, .read_only = true, .mmap_size = file_size});
+      case 2:
+        return sqlite_wrapper::open_immutable(db_file_name);
+      default:
+        return sqlite_wrapper::open(db_file_name, {.flags = sqlite_wrapper::open_flags::open_only, .read_only = true});
+    }
+  }
+
+  /**
+   * Looks up random rows by primary key, each lookup is a transaction of its own like in a read-only service.
+   */
+  void reference_lookups(benchmark::State& state)
+  {
+    create_reference_database();
+
+    auto database{open_reference_database(state)};
+
+    const auto stmt{sqlite_wrapper::create_prepared_statement(database.get(), select_sql)};
+    std::uint64_t random{4711};
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+      random = (random * 6364136223846793005U) + 1442695040888963407U;  // NOLINT(readability-magic-numbers)
+
+      sqlite_wrapper::reset_and_rebind_prepared_statement(stmt.get(), static_cast<std::int64_t>(random % row_count) + 1);
+      benchmark::DoNotOptimize(sqlite_wrapper::step(stmt.get()));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    database.reset();
+    std::filesystem::remove(db_file_name);
+  }
+  BENCHMARK(reference_lookups)->ArgName("open")->Arg(0)->Arg(1)->Arg(2);
+}  // unnamed namespace
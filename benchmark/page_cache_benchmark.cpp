@@ -0,0 +1,105 @@
+#include "sqlite_wrapper/page_cache.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <benchmark/benchmark.h>
+
+#include <sqlite3.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+namespace
+{
+  constexpr std::int64_t row_count{1'000'000};
+
+  constexpr auto select_sql{R"(SELECT "Data" FROM "Test" WHERE "Id" = ?)"sv};
+
+  const auto db_file_name{(std::filesystem::temp_directory_path() / "sqlite_wrapper_page_cache_benchmark.db").string()};
+
+  /**
+   * Configures the page cache selected by state.range(0), 0 = page_cache_kind::sqlite_default, 1 = page_cache_kind::slabs
+   * with normal pages, 2 = page_cache_kind::slabs with huge pages.
+   */
+  void configure_page_cache(const benchmark::State& state)
+  {
+    (void)::sqlite3_shutdown();
+
+    switch (state.range(0))
+    {
+      case 1:
+        sqlite_wrapper::configure_page_cache({.huge_pages = sqlite_wrapper::huge_pages::none});
+        break;
+      case 2:
+        sqlite_wrapper::configure_page_cache({.huge_pages = sqlite_wrapper::huge_pages::explicit_first});
+        break;
+      default:
+        sqlite_wrapper::configure_page_cache({.kind = sqlite_wrapper::page_cache_kind::sqlite_default});
+        break;
+    }
+
+    sqlite_wrapper::reset_page_cache_metrics();
+  }
+
+  /**
+   * Looks up random rows of a database that fits into the page cache, after a first pass all pages are hits and the
+   * lookups are dominated by the page cache and its TLB misses.
+   */
+  void cached_lookups(benchmark::State& state)
+  {
+    configure_page_cache(state);
+
+    std::filesystem::remove(db_file_name);
+
+    {
+      const auto database{sqlite_wrapper::open(db_file_name)};
+
+      sqlite_wrapper::execute_no_data(database.get(), "PRAGMA cache_size = -1048576");  // 1 GiB
+      sqlite_wrapper::execute_no_data(database.get(), R"(CREATE TABLE "Test" ("Id" INTEGER PRIMARY KEY, "Data" TEXT))");
+      sqlite_wrapper::execute_no_data(database.get(), "BEGIN");
+
+      const auto insert{sqlite_wrapper::create_prepared_statement(
+          database.get(), R"(INSERT INTO "Test" VALUES (?, printf('data %d', random())))")};
+
+      for (std::int64_t id{1}; id <= row_count; ++id)
+      {
+        sqlite_wrapper::reset_and_rebind_prepared_statement(insert.get(), id);
+        (void)sqlite_wrapper::step(insert.get());
+      }
+
+      sqlite_wrapper::execute_no_data(database.get(), "COMMIT");
+
+      const auto stmt{sqlite_wrapper::create_prepared_statement(database.get(), select_sql)};
+      std::uint64_t random{4711};
+
+      // the read transaction keeps the page cache valid between the lookups
+      sqlite_wrapper::execute_no_data(database.get(), "BEGIN");
+
+      for ([[maybe_unused]] auto _ : state)
+      {
+        random = (random * 6364136223846793005U) + 1442695040888963407U;  // NOLINT(readability-magic-numbers)
+
+        sqlite_wrapper::reset_and_rebind_prepared_statement(stmt.get(), static_cast<std::int64_t>(random % row_count) + 1);
+        benchmark::DoNotOptimize(sqlite_wrapper::step(stmt.get()));
+      }
+
+      sqlite_wrapper::reset_prepared_statement(stmt.get());
+      sqlite_wrapper::execute_no_data(database.get(), "COMMIT");
+    }
+
+    const auto metrics{sqlite_wrapper::get_page_cache_metrics()};
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["hit_ratio"] = metrics.hit_ratio();
+    state.counters["huge_page_slabs"] = static_cast<double>(metrics.huge_page_slabs);
+
+    (void)::sqlite3_shutdown();
+    sqlite_wrapper::configure_page_cache({.kind = sqlite_wrapper::page_cache_kind::sqlite_default});
+
+    std::filesystem::remove(db_file_name);
+  }
+  BENCHMARK(cached_lookups)->ArgName("page_cache")->Arg(0)->Arg(1)->Arg(2);
+}  // unnamed namespace
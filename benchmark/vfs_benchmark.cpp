@@ -0,0 +1,216 @@
+#include "sqlite_wrapper/compressed_vfs.h"
+#include "sqlite_wrapper/io_uring_vfs.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/prefetch_vfs.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+using namespace std::string_view_literals;
+
+namespace
+{
+  constexpr std::int64_t row_count{20'000};
+
+  constexpr auto create_table_sql{R"(CREATE TABLE "Bench" ("Id" INTEGER PRIMARY KEY, "Data" TEXT NOT NULL))"sv};
+  // text that compresses about as well as typical row data
+  constexpr auto insert_sql{R"(INSERT INTO "Bench" ("Data")
+                               VALUES (printf('%d, some text that is similar in all rows, %d', random(), random())))"sv};
+  constexpr auto select_sql{R"(SELECT "Data" FROM "Bench" WHERE "Id" = ?)"sv};
+
+  const auto db_file_name{(std::filesystem::temp_directory_path() / "sqlite_wrapper_vfs_benchmark.db").string()};
+
+  void remove_database_files()
+  {
+    std::filesystem::remove(db_file_name);
+    std::filesystem::remove(db_file_name + "-wal");
+    std::filesystem::remove(db_file_name + "-shm");
+  }
+
+  /**
+   * Returns the VFS selected by state.range(0), 0 = default, 1 = io_uring, 2 = prefetch, 3 = compressed, or nullopt if it is
+   * not supported.
+   */
+  auto get_vfs(benchmark::State& state) -> std::optional<std::string>
+  {
+    switch (state.range(0))
+    {
+      case 1:
+        if (!sqlite_wrapper::is_io_uring_supported())
+        {
+          state.SkipWithError("io_uring is not supported");
+          return std::nullopt;
+        }
+
+        sqlite_wrapper::register_io_uring_vfs();
+        return std::string{sqlite_wrapper::io_uring_vfs_name};
+      case 2:
+        sqlite_wrapper::register_prefetch_vfs();
+        return std::string{sqlite_wrapper::prefetch_vfs_name};
+      case 3:
+        sqlite_wrapper::register_compressed_vfs();
+        return std::string{sqlite_wrapper::compressed_vfs_name};
+      default:
+        return std::string{};
+    }
+  }
+
+  auto open_database(const std::string& vfs) -> sqlite_wrapper::database
+  {
+    // a small page cache, so most reads go to the file
+    return sqlite_wrapper::open(db_file_name, {.journal = sqlite_wrapper::journal_mode::wal,
+                                               .synchronous = sqlite_wrapper::synchronous_mode::normal,
+                                               .cache_size = -64,
+                                               .vfs = vfs});
+  }
+
+  void fill_table(const sqlite_wrapper::db_with_location& database)
+  {
+    sqlite_wrapper::execute_no_data(database, create_table_sql);
+    sqlite_wrapper::execute_no_data(database, "BEGIN");
+
+    for (std::int64_t i{0}; i < row_count; ++i)
+    {
+      sqlite_wrapper::execute_no_data(database, insert_sql);
+    }
+
+    sqlite_wrapper::execute_no_data(database, "COMMIT");
+  }
+
+  /**
+   * Reports the compression ratio as counter if the database file is written by the compressing VFS.
+   */
+  void report_compression(benchmark::State& state, const sqlite_wrapper::db_with_location& database, const std::string& vfs)
+  {
+    if (vfs != sqlite_wrapper::compressed_vfs_name)
+    {
+      return;
+    }
+
+    std::ignore = sqlite_wrapper::execute_one_row<std::tuple<std::int64_t, std::int64_t, std::int64_t>>(
+        database, "PRAGMA wal_checkpoint(TRUNCATE)");
+
+    state.counters["compression_ratio"] = sqlite_wrapper::get_compression_stats(db_file_name).ratio();
+  }
+
+  /**
+   * Reads random rows of a database that is much larger than the page cache, see get_vfs() for state.range(0).
+   */
+  void random_reads(benchmark::State& state)
+  {
+    const auto vfs{get_vfs(state)};
+
+    if (!vfs)
+    {
+      return;
+    }
+
+    remove_database_files();
+
+    auto database{open_database(*vfs)};
+
+    fill_table(database.get());
+
+    {
+      // the statement stays active after its last step, the checkpoint in report_compression() requires it finalized
+      const auto stmt{sqlite_wrapper::create_prepared_statement(database.get(), select_sql)};
+      std::uint64_t random{4711};
+
+      for ([[maybe_unused]] auto _ : state)
+      {
+        random = (random * 6364136223846793005U) + 1442695040888963407U;  // NOLINT(readability-magic-numbers)
+
+        sqlite_wrapper::reset_and_rebind_prepared_statement(stmt.get(), static_cast<std::int64_t>(random % row_count) + 1);
+        benchmark::DoNotOptimize(sqlite_wrapper::step(stmt.get()));
+      }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    report_compression(state, database.get(), *vfs);
+
+    database.reset();
+    remove_database_files();
+  }
+  BENCHMARK(random_reads)->ArgName("vfs")->Arg(0)->Arg(1)->Arg(2)->Arg(3);
+
+  /**
+   * Reads all rows of a database that is much larger than the page cache like an export, see get_vfs() for state.range(0).
+   */
+  void full_scan(benchmark::State& state)
+  {
+    const auto vfs{get_vfs(state)};
+
+    if (!vfs)
+    {
+      return;
+    }
+
+    remove_database_files();
+
+    auto database{open_database(*vfs)};
+
+    fill_table(database.get());
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+      benchmark::DoNotOptimize(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(
+          database.get(), R"(SELECT SUM(LENGTH("Data")) FROM "Bench")"));
+    }
+
+    state.SetItemsProcessed(state.iterations() * row_count);
+    report_compression(state, database.get(), *vfs);
+
+    database.reset();
+    remove_database_files();
+  }
+  BENCHMARK(full_scan)->ArgName("vfs")->Arg(0)->Arg(1)->Arg(2)->Arg(3);
+
+  /**
+   * Commits one small transaction per iteration in WAL mode, see get_vfs() for state.range(0).
+   */
+  void commits(benchmark::State& state)
+  {
+    const auto vfs{get_vfs(state)};
+
+    if (!vfs)
+    {
+      return;
+    }
+
+    remove_database_files();
+
+    auto database{open_database(*vfs)};
+
+    sqlite_wrapper::execute_no_data(database.get(), create_table_sql);
+
+    const auto stmt{sqlite_wrapper::create_prepared_statement(database.get(), insert_sql)};
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+      sqlite_wrapper::execute_no_data(database.get(), "BEGIN");
+
+      for (int i{0}; i < 10; ++i)
+      {
+        sqlite_wrapper::reset_and_rebind_prepared_statement(stmt.get());
+        (void)sqlite_wrapper::step(stmt.get());
+      }
+
+      sqlite_wrapper::execute_no_data(database.get(), "COMMIT");
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    report_compression(state, database.get(), *vfs);
+
+    database.reset();
+    remove_database_files();
+  }
+  BENCHMARK(commits)->ArgName("vfs")->Arg(0)->Arg(1)->Arg(2)->Arg(3);
+}  // unnamed namespace
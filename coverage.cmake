@@ -5,10 +5,14 @@ add_custom_target(sqlite_wrapper.run_all_tests
         COMMAND echo "--------------------------------------------------------------------------------"
         COMMAND echo "test_runner_mocked"
         COMMAND ./test_runner_mocked
+        COMMAND echo "--------------------------------------------------------------------------------"
+        COMMAND echo "test_runner_configuration"
+        COMMAND ./test_runner_configuration
         WORKING_DIRECTORY ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}
         USES_TERMINAL)
 
-add_dependencies(sqlite_wrapper.run_all_tests sqlite_wrapper::test_runner sqlite_wrapper::test_runner_mocked)
+add_dependencies(sqlite_wrapper.run_all_tests sqlite_wrapper::test_runner sqlite_wrapper::test_runner_mocked
+                 sqlite_wrapper::test_runner_configuration)
 
 if (CMAKE_BUILD_TYPE STREQUAL "Debug")
   find_program(GCOVR NAMES gcovr)
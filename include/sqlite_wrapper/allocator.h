@@ -0,0 +1,69 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+
+#include <cstdint>
+#include <memory_resource>
+#include <source_location>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Memory allocators SQLite can be configured with, see configure_allocator().
+   */
+  enum class allocator_kind : unsigned
+  {
+    sqlite_default = 0,  ///< the allocator SQLite used before the first call of configure_allocator()
+    thread_caches,       ///< blocks in size classes cached per thread, backed by std::malloc()
+    memory_resource      ///< allocator_options::resource
+  };
+
+  /**
+   * Settings of configure_allocator().
+   */
+  struct allocator_options
+  {
+    allocator_kind kind{allocator_kind::thread_caches};
+
+    /**
+     * Resource of allocator_kind::memory_resource, must be thread-safe like std::pmr::synchronized_pool_resource and
+     * outlive the use of SQLite up to sqlite3_shutdown().
+     */
+    std::pmr::memory_resource* resource{};
+  };
+
+  /**
+   * Statistics of the allocators of configure_allocator() of all threads, allocator_kind::sqlite_default is not counted.
+   */
+  struct allocator_metrics
+  {
+    std::uint64_t allocations{};         ///< blocks allocated by SQLite
+    std::uint64_t frees{};               ///< blocks freed by SQLite
+    std::uint64_t reallocations{};       ///< blocks resized by SQLite, incl. the ones that kept their place
+    std::uint64_t cached_allocations{};  ///< blocks, incl. moved ones, taken from the cache of the thread, see thread_caches
+    std::uint64_t failed_allocations{};  ///< allocations and reallocations that ran out of memory
+    std::int64_t bytes_in_use{};         ///< usable bytes of all blocks allocated and not freed
+  };
+
+  /**
+   * Replaces the memory allocator of SQLite with SQLITE_CONFIG_MALLOC, see https://www.sqlite.org/c3ref/mem_methods.html .
+   *
+   * allocator_kind::thread_caches rounds allocations of up to 16 KiB to size classes with four classes per power of two.
+   * Freed blocks are kept in a list per size class of the freeing thread, up to 256 KiB per class, and reused by its next
+   * allocation of the class without any locking. Larger blocks and the caches of exited threads go back to std::free().
+   *
+   * SQLite must not be initialized yet, so the function must be called before the first connection is opened, or after
+   * all connections are closed and sqlite3_shutdown() is called.
+   *
+   * @param options allocator to use
+   * @param loc caller location
+   * @throws sqlite_error with sqlite_errc::misuse if an option is invalid or SQLite is already initialized
+   */
+  SQLITE_WRAPPER_EXPORT void configure_allocator(const allocator_options& options = {},
+                                                 const std::source_location& loc = std::source_location::current());
+
+  /**
+   * Returns the statistics of the allocators since the start of the process.
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_allocator_metrics() -> allocator_metrics;
+}  // namespace sqlite_wrapper
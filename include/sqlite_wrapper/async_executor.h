@@ -0,0 +1,157 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <array>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Priority of a task of an async_executor, a worker always takes the oldest task of the highest priority.
+   */
+  enum class task_priority : unsigned
+  {
+    high = 0,  ///< latency-critical work
+    normal,    ///< default
+    low        ///< bulk work like exports, only runs when no other task is queued
+  };
+
+  /**
+   * Settings of an async_executor.
+   */
+  struct async_executor_options
+  {
+    static constexpr std::size_t default_thread_count{4};
+
+    std::size_t thread_count{default_thread_count};  ///< number of worker threads with their own connection, must be > 0
+
+    /**
+     * Options of the connection of each worker, no_mutex is always set.
+     */
+    open_options connection_options{open_options{.flags = open_flags::open_only, .read_only = true}};
+  };
+
+  /**
+   * Thread pool executing database work off the calling thread, each worker thread owns one connection.
+   *
+   * Tasks are queued by priority and run by the first free worker, the caller gets a std::future for the result. Low
+   * priority tasks wait as long as there are tasks of a higher priority, so latency-critical reads are not queued behind
+   * bulk exports.
+   */
+  class async_executor
+  {
+   public:
+    /**
+     * A task executed on the connection of a worker thread.
+     */
+    using task = std::move_only_function<void(::sqlite3*)>;
+
+    /**
+     * Opens a connection for each worker and starts the workers.
+     *
+     * @param file_name name of the database file incl. an absolute or relative path
+     * @param options settings of the executor
+     * @param loc caller location
+     * @throws sqlite_error in case an option is invalid or a connection can not be opened
+     */
+    SQLITE_WRAPPER_EXPORT explicit async_executor(const std::string& file_name, const async_executor_options& options = {},
+                                                  const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Executes all queued tasks and stops the workers, no tasks must be submitted anymore.
+     */
+    SQLITE_WRAPPER_EXPORT ~async_executor();
+
+    async_executor(const async_executor&) = delete;
+    async_executor(async_executor&&) = delete;
+    auto operator=(const async_executor&) -> async_executor& = delete;
+    auto operator=(async_executor&&) -> async_executor& = delete;
+
+    /**
+     * Queues a function that is called with the connection of a worker thread, can be called from any thread.
+     *
+     * @param function function to call, must not keep the connection
+     * @param priority priority of the task
+     * @returns future for the result or exception of \p function
+     */
+    template <std::invocable<::sqlite3*> Function>
+    [[nodiscard]] auto submit(Function&& function, task_priority priority = task_priority::normal)
+        -> std::future<std::invoke_result_t<Function, ::sqlite3*>>
+    {
+      std::packaged_task<std::invoke_result_t<Function, ::sqlite3*>(::sqlite3*)> packaged_task{
+          std::forward<Function>(function)};
+      auto future{packaged_task.get_future()};
+
+      enqueue(task{std::move(packaged_task)}, priority);
+
+      return future;
+    }
+
+    [[nodiscard]] auto thread_count() const noexcept -> std::size_t
+    {
+      return m_workers.size();
+    }
+
+   private:
+    SQLITE_WRAPPER_EXPORT void enqueue(task new_task, task_priority priority);
+
+    void run(::sqlite3* database) noexcept;
+
+    std::vector<database> m_connections;
+
+    std::mutex m_mutex;
+    std::condition_variable m_task_available;
+    std::array<std::deque<task>, 3> m_tasks;  // one queue per task_priority
+    bool m_stopping{false};
+
+    std::vector<std::thread> m_workers;
+  };
+
+  /**
+   * Executes a SQL statement on a worker of \p executor.
+   *
+   * @tparam Row std::tuple of the column types
+   * @param executor executor to run the statement on
+   * @param priority priority of the statement
+   * @param sql SQL statement to execute (can contain placeholders)
+   * @param params 0 to n parameters that are bound to the placeholders in \p sql, they are copied, so data referred to by
+   *   views or pointers must stay valid until the returned future is ready
+   * @returns future for all result rows or the sqlite_error of the statement
+   */
+  template <row_type Row>
+  [[nodiscard]] auto async_execute(async_executor& executor, task_priority priority, std::string sql,
+                                   const binding_type auto&... params) -> std::future<std::vector<Row>>
+  {
+    return executor.submit(
+        [sql = std::move(sql), params = std::tuple<std::decay_t<decltype(params)>...>{params...}](::sqlite3* database)
+        { return std::apply([&](const auto&... values) { return execute<Row>(database, sql, values...); }, params); },
+        priority);
+  }
+
+  /**
+   * Executes a SQL statement with task_priority::normal on a worker of \p executor, see above.
+   */
+  template <row_type Row>
+  [[nodiscard]] auto async_execute(async_executor& executor, std::string sql, const binding_type auto&... params)
+      -> std::future<std::vector<Row>>
+  {
+    return async_execute<Row>(executor, task_priority::normal, std::move(sql), params...);
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/raii.h"
+
+#include <chrono>
+#include <functional>
+#include <source_location>
+#include <stop_token>
+#include <string>
+
+extern "C"
+{
+  struct sqlite3_backup;
+}
+
+namespace sqlite_wrapper
+{
+  /**
+   * State of a backup after a step.
+   */
+  struct backup_progress
+  {
+    int remaining{};   ///< pages still to be copied
+    int page_count{};  ///< pages of the source database
+
+    /**
+     * Returns the fraction of pages copied, 0.0 to 1.0 .
+     */
+    [[nodiscard]] auto fraction() const noexcept -> double
+    {
+      return (page_count > 0) ? (static_cast<double>(page_count - remaining) / static_cast<double>(page_count)) : 0.0;
+    }
+  };
+
+  /**
+   * Settings of a backup.
+   */
+  struct backup_options
+  {
+    static constexpr int default_pages_per_step{100};
+    static constexpr std::chrono::milliseconds default_busy_timeout{5000};
+
+    /**
+     * Pages copied per step, a negative value copies all in one step, must not be 0.
+     */
+    int pages_per_step{default_pages_per_step};
+
+    /**
+     * Pause between steps, the source is not locked during the pause so writers can make progress.
+     */
+    std::chrono::milliseconds sleep_between_steps{};
+
+    /**
+     * How long run() retries steps while the source or destination is locked by another connection, 0 fails on the first
+     * lock.
+     */
+    std::chrono::milliseconds busy_timeout{default_busy_timeout};
+
+    std::string source_schema{"main"};
+    std::string destination_schema{"main"};
+
+    /**
+     * Called after each step, returning false cancels the backup.
+     */
+    std::function<bool(const backup_progress&)> progress{};
+  };
+
+  /**
+   * Online backup of a database into another one with the SQLite backup API, see https://www.sqlite.org/backup.html .
+   *
+   * The source database stays usable during the backup, it is only locked while a step copies its pages. If the source is
+   * written through another connection the backup restarts with the next step, writes through the source connection
+   * are copied along. The destination must not be used until the backup is finished.
+   */
+  class backup
+  {
+   public:
+    /**
+     * Starts a backup, no pages are copied yet.
+     *
+     * @param source database to copy from
+     * @param destination database to copy to, its content is replaced
+     * @param options settings of the backup
+     * @throws sqlite_error with sqlite_errc::misuse if pages_per_step is 0, or in case SQLite returns an error, like if
+     *   \p destination has an open transaction
+     */
+    SQLITE_WRAPPER_EXPORT backup(const db_with_location& source, const db_with_location& destination,
+                                 backup_options options = {});
+
+    /**
+     * Finishes the backup if that was not done, errors are ignored.
+     */
+    SQLITE_WRAPPER_EXPORT ~backup();
+
+    backup(const backup&) = delete;
+    backup(backup&&) = delete;
+    auto operator=(const backup&) -> backup& = delete;
+    auto operator=(backup&&) -> backup& = delete;
+
+    /**
+     * Copies up to pages_per_step pages.
+     *
+     * @returns true if all pages are copied, false if there are pages left or the source or destination was locked
+     * @throws sqlite_error in case SQLite returns an error
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto step(const std::source_location& loc = std::source_location::current()) -> bool;
+
+    /**
+     * Copies pages until all are copied or the backup is canceled, sleeps sleep_between_steps between the steps and
+     * finishes the backup if it is complete. Can be run on a background thread.
+     *
+     * @param stop_token cancels the backup when stop is requested, also during the sleeps
+     * @param loc caller location
+     * @returns true if the backup is complete, false if it was canceled
+     * @throws sqlite_error with sqlite_errc::busy if the source or destination stays locked for longer than busy_timeout,
+     *   or in case SQLite returns an error
+     */
+    SQLITE_WRAPPER_EXPORT auto run(const std::stop_token& stop_token = {},
+                                   const std::source_location& loc = std::source_location::current()) -> bool;
+
+    /**
+     * Releases all resources of the backup, the destination can be used again afterwards.
+     *
+     * @throws sqlite_error in case a step failed
+     */
+    SQLITE_WRAPPER_EXPORT void finish(const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Returns the state after the last step.
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_progress() const noexcept -> backup_progress;
+
+    [[nodiscard]] auto is_done() const noexcept -> bool
+    {
+      return m_done;
+    }
+
+   private:
+    ::sqlite3* m_destination;
+    backup_options m_options;
+    ::sqlite3_backup* m_backup;
+    bool m_done{false};
+    bool m_locked{false};
+  };
+}  // namespace sqlite_wrapper
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/raii.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <source_location>
+
+namespace sqlite_wrapper
+{
+  namespace details
+  {
+    /**
+     * Returns min(initial_delay * multiplier^retry, max_delay) reduced by a random fraction of up to \p jitter.
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_backoff_delay(std::chrono::nanoseconds initial_delay,
+                                                               std::chrono::nanoseconds max_delay, double multiplier,
+                                                               double jitter, int retry, std::minstd_rand& random)
+        -> std::chrono::nanoseconds;
+  }  // namespace details
+
+  /**
+   * Settings of a busy_handler.
+   *
+   * The n-th retry of a busy episode waits min(initial_delay * multiplier^n, max_delay), reduced by a random fraction of
+   * up to \p jitter, so connections waiting for the same lock do not retry in lockstep.
+   */
+  struct busy_handler_options
+  {
+    static constexpr std::chrono::microseconds default_initial_delay{100};
+    static constexpr std::chrono::microseconds default_max_delay{100'000};
+    static constexpr std::chrono::milliseconds default_max_total_wait{5000};
+    static constexpr double default_multiplier{2.0};
+    static constexpr double default_jitter{0.5};
+
+    std::chrono::microseconds initial_delay{default_initial_delay};     ///< wait before the first retry, must be > 0
+    std::chrono::microseconds max_delay{default_max_delay};             ///< upper limit of a single wait, >= initial_delay
+    std::chrono::milliseconds max_total_wait{default_max_total_wait};  ///< SQLITE_BUSY is returned after waiting this long
+    double multiplier{default_multiplier};                               ///< growth of the delay per retry, must be >= 1.0
+    double jitter{default_jitter};                                       ///< random reduction of each delay, 0.0 to 1.0
+  };
+
+  /**
+   * Lock contention seen by a busy_handler, a busy episode starts when a statement first gets SQLITE_BUSY and ends when
+   * it gets the lock or gives up.
+   */
+  struct busy_handler_metrics
+  {
+    std::uint64_t busy_events{};  ///< number of busy episodes
+    std::uint64_t retries{};      ///< number of waits over all busy episodes
+    std::uint64_t give_ups{};     ///< number of busy episodes that ended with SQLITE_BUSY after max_total_wait
+
+    std::chrono::nanoseconds total_wait_time{};  ///< time spent waiting over all busy episodes
+    std::chrono::nanoseconds max_wait_time{};    ///< longest time waited in a single busy episode
+  };
+
+  /**
+   * Busy handler of a database connection that retries with exponential backoff and jitter, installed with
+   * sqlite3_busy_handler().
+   *
+   * It replaces any busy timeout of the connection (like open_options::busy_timeout) and is removed again when
+   * destroyed, so it must be destroyed before the connection is closed. The metrics can be read from any thread.
+   */
+  class busy_handler
+  {
+   public:
+    /**
+     * Installs the handler on \p database.
+     *
+     * @param database connection to install the handler on
+     * @param options backoff settings
+     * @param loc caller location
+     * @throws sqlite_error with sqlite_errc::misuse if an option is invalid
+     */
+    SQLITE_WRAPPER_EXPORT explicit busy_handler(::sqlite3* database, const busy_handler_options& options = {},
+                                                const std::source_location& loc = std::source_location::current());
+
+    SQLITE_WRAPPER_EXPORT ~busy_handler();
+
+    busy_handler(const busy_handler&) = delete;
+    busy_handler(busy_handler&&) = delete;
+    auto operator=(const busy_handler&) -> busy_handler& = delete;
+    auto operator=(busy_handler&&) -> busy_handler& = delete;
+
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_metrics() const noexcept -> busy_handler_metrics;
+
+    [[nodiscard]] auto options() const noexcept -> const busy_handler_options&
+    {
+      return m_options;
+    }
+
+   private:
+    static auto on_busy(void* handler, int count) noexcept -> int;
+
+    [[nodiscard]] auto next_delay(int count) -> std::chrono::nanoseconds;
+
+    ::sqlite3* m_database;
+    busy_handler_options m_options;
+
+    // only used by the thread that currently holds the connection
+    std::minstd_rand m_random;
+    std::chrono::nanoseconds m_episode_wait_time{};
+
+    std::atomic<std::uint64_t> m_busy_events{};
+    std::atomic<std::uint64_t> m_retries{};
+    std::atomic<std::uint64_t> m_give_ups{};
+    std::atomic<std::int64_t> m_total_wait_time_ns{};
+    std::atomic<std::int64_t> m_max_wait_time_ns{};
+  };
+}  // namespace sqlite_wrapper
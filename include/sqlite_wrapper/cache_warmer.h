@@ -0,0 +1,146 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/raii.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <source_location>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sqlite_wrapper
+{
+  /**
+   * State of warming the caches of a database.
+   */
+  struct warm_progress
+  {
+    std::size_t objects{};         ///< tables and indexes to warm
+    std::size_t objects_warmed{};  ///< tables and indexes read completely
+    std::uint64_t pages_warmed{};  ///< pages read incl. interior and overflow pages
+    std::uint64_t bytes_warmed{};  ///< bytes of the pages read
+    bool budget_exhausted{};       ///< true if warming stopped because budget bytes were read
+
+    /**
+     * Returns the fraction of tables and indexes read completely, 0.0 to 1.0 .
+     */
+    [[nodiscard]] auto fraction() const noexcept -> double
+    {
+      return (objects > 0) ? (static_cast<double>(objects_warmed) / static_cast<double>(objects)) : 1.0;
+    }
+  };
+
+  /**
+   * Settings of warm() and cache_warmer.
+   */
+  struct warm_options
+  {
+    static constexpr std::uint64_t default_budget{256ULL * 1024 * 1024};
+    static constexpr std::uint64_t default_progress_pages{1024};
+
+    /**
+     * Names of the tables and indexes to warm in this order, all tables and indexes of the schema if empty.
+     */
+    std::vector<std::string> objects{};
+
+    std::uint64_t budget{default_budget};  ///< most bytes of pages read, must be > 0
+    std::string schema{"main"};
+
+    std::uint64_t progress_pages{default_progress_pages};  ///< pages read between calls of progress, must be > 0
+
+    /**
+     * Called after each table or index and every progress_pages pages, returning false cancels warming.
+     */
+    std::function<bool(const warm_progress&)> progress{};
+  };
+
+  /**
+   * Reads all pages of tables and indexes into the page cache of the connection and the page cache of the OS.
+   *
+   * Each object is walked with the dbstat virtual table, see https://www.sqlite.org/dbstat.html, which reads the B-tree
+   * from the root to the leaves and follows overflow chains, in the order given until budget bytes are read. Pages beyond
+   * the cache size of the connection (PRAGMA cache_size) only stay in the OS page cache. Warming runs in read transactions
+   * of the connection, writers are not blocked in WAL mode.
+   *
+   * @param database connection whose caches are warmed
+   * @param options settings of warming
+   * @param stop_token cancels warming when stop is requested
+   * @returns state after the last page read
+   * @throws sqlite_error with sqlite_errc::misuse if an option is invalid, SQLite is compiled without
+   *   SQLITE_ENABLE_DBSTAT_VTAB, the schema is unknown or an object is not a table or index of it, or in case SQLite returns
+   *   an error
+   */
+  SQLITE_WRAPPER_EXPORT auto warm(const db_with_location& database, const warm_options& options = {},
+                                  const std::stop_token& stop_token = {}) -> warm_progress;
+
+  /**
+   * Warms the OS page cache of a database file on a background thread, for example while a service starts.
+   *
+   * The warmer opens its own read-only connection and calls warm() with it, so the pages end up in the OS page cache
+   * shared by all connections and processes, while the page caches of other connections stay empty. The progress can be
+   * read from any thread, wait() returns when warming is done.
+   */
+  class cache_warmer
+  {
+   public:
+    /**
+     * Opens a read-only connection to the database file and starts warming on a background thread.
+     *
+     * @param file_name name of the existing database file incl. an absolute or relative path
+     * @param options settings of warming, progress is called on the background thread
+     * @param loc caller location
+     * @throws sqlite_error with sqlite_errc::misuse if an option is invalid, or in case the file can not be opened
+     */
+    SQLITE_WRAPPER_EXPORT explicit cache_warmer(const std::string& file_name, warm_options options = {},
+                                                const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Cancels warming and waits for the background thread.
+     */
+    SQLITE_WRAPPER_EXPORT ~cache_warmer();
+
+    cache_warmer(const cache_warmer&) = delete;
+    cache_warmer(cache_warmer&&) = delete;
+    auto operator=(const cache_warmer&) -> cache_warmer& = delete;
+    auto operator=(cache_warmer&&) -> cache_warmer& = delete;
+
+    /**
+     * Waits until warming is done or canceled.
+     *
+     * @returns state after the last page read
+     * @throws sqlite_error in case warming failed
+     */
+    SQLITE_WRAPPER_EXPORT auto wait() -> warm_progress;
+
+    /**
+     * Requests warming to stop after the next progress_pages pages, wait() returns afterwards.
+     */
+    SQLITE_WRAPPER_EXPORT void cancel() noexcept;
+
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto is_done() const -> bool;
+
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_progress() const -> warm_progress;
+
+   private:
+    void run(const std::stop_token& stop_token) noexcept;
+
+    sqlite_wrapper::database m_connection;
+    warm_options m_options;
+    std::source_location m_location;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_finished;
+    warm_progress m_progress;
+    std::exception_ptr m_error;
+    bool m_done{false};
+
+    std::jthread m_thread;
+  };
+}  // namespace sqlite_wrapper
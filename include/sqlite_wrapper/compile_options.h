@@ -0,0 +1,75 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/format.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Threading mode SQLite was compiled with, see SQLITE_THREADSAFE.
+   */
+  enum class threading_mode : unsigned
+  {
+    single_thread = 0,  ///< SQLITE_THREADSAFE=0, no mutexes at all, must not be used from more than one thread
+    serialized = 1,     ///< SQLITE_THREADSAFE=1, connections can be shared between threads
+    multi_thread = 2    ///< SQLITE_THREADSAFE=2, a connection must not be used by more than one thread at a time
+  };
+
+  /**
+   * Returns the version of the SQLite library in use, like "3.46.1".
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_sqlite_version() noexcept -> std::string_view;
+
+  /**
+   * Returns the compile time options of the SQLite library in use, without the "SQLITE_" prefix, like "THREADSAFE=2".
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_compile_options() -> std::vector<std::string>;
+
+  /**
+   * Checks if a compile time option was used to build the SQLite library in use.
+   *
+   * @param option name of the option with or without the "SQLITE_" prefix, like "DEFAULT_MEMSTATUS=0" or "OMIT_DEPRECATED"
+   * @returns true if the option was used
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto is_compile_option_used(const std::string& option) noexcept -> bool;
+
+  /**
+   * Returns the threading mode the SQLite library in use was compiled with.
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_threading_mode() noexcept -> threading_mode;
+}  // namespace sqlite_wrapper
+
+namespace SQLITEWRAPPER_FORMAT_NAMESPACE_NAME
+{
+  template <>
+  // NOLINTNEXTLINE(cert-dcl58-cpp) modification of 'std' namespace can result in undefined behavior
+  struct formatter<sqlite_wrapper::threading_mode> : sqlite_wrapper::empty_format_spec
+  {
+    template <typename FmtContext>
+    static auto format(sqlite_wrapper::threading_mode mode, FmtContext& ctx)
+    {
+      using namespace std::string_view_literals;
+      std::string_view mode_str{};
+
+      switch (mode)
+      {
+        case sqlite_wrapper::threading_mode::single_thread:
+          mode_str = "single_thread"sv;
+          break;
+        case sqlite_wrapper::threading_mode::serialized:
+          mode_str = "serialized"sv;
+          break;
+        case sqlite_wrapper::threading_mode::multi_thread:
+          mode_str = "multi_thread"sv;
+          break;
+        default:
+          return SQLITEWRAPPER_FORMAT_NAMESPACE::format_to(ctx.out(), "<unknown ({})>", sqlite_wrapper::to_underlying(mode));
+      }
+      return SQLITEWRAPPER_FORMAT_NAMESPACE::format_to(ctx.out(), "{}", mode_str);
+    }
+  };
+}  // namespace SQLITEWRAPPER_FORMAT_NAMESPACE_NAME
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+
+#include <cstdint>
+#include <source_location>
+#include <string>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Name of the compressing VFS, to be used as open_options::vfs after register_compressed_vfs().
+   */
+  inline constexpr auto compressed_vfs_name{"sqlite_wrapper_compressed"};
+
+  /**
+   * Name of the read-only variant of the compressing VFS for shipped images, see register_compressed_vfs().
+   */
+  inline constexpr auto compressed_read_only_vfs_name{"sqlite_wrapper_compressed_ro"};
+
+  /**
+   * Settings of the compressing VFS.
+   */
+  struct compressed_vfs_options
+  {
+    static constexpr int default_compression_level{3};
+
+    int compression_level{default_compression_level};  ///< zstd compression level, from ZSTD_minCLevel() to ZSTD_maxCLevel()
+  };
+
+  /**
+   * Sizes of a database file written by the compressing VFS.
+   */
+  struct compression_stats
+  {
+    std::uint64_t logical_size{};   ///< size of the database as SQLite sees it, page count * page size
+    std::uint64_t physical_size{};  ///< size of the file on disk incl. page map and unused space
+
+    /**
+     * Returns logical_size / physical_size, > 1.0 if the file is smaller than the database.
+     */
+    [[nodiscard]] auto ratio() const noexcept -> double
+    {
+      return (physical_size > 0) ? (static_cast<double>(logical_size) / static_cast<double>(physical_size)) : 0.0;
+    }
+  };
+
+  /**
+   * Registers two VFS that store each page of main database files compressed with zstd, see https://www.sqlite.org/vfs.html.
+   *
+   * The file starts with a header and a directory of page map chunks, the page map holds location and size of each
+   * compressed page. A page that does not compress is stored as is. A page rewritten with a compressed size that does not
+   * fit into its old place is appended, the old place is not reused. VACUUM INTO another file compacts the database.
+   * Journals, WALs and temporary files are stored uncompressed, so the compressed files keep SQLite's crash safety.
+   *
+   * compressed_vfs_name reads and writes, changes of the page map are written before locks are released, so other
+   * connections and processes reload it when they take a lock. compressed_read_only_vfs_name opens database files read-only
+   * and immutable, without any locking or change detection, for images that do not change while they are used. Images must
+   * not be in WAL mode, as the WAL is ignored.
+   *
+   * Files written by the VFS can only be read by it, and the page size can not be changed once a page is written. The
+   * page map holds up to 2'064'384 pages, 8 GiB with 4096 byte pages.
+   *
+   * The VFS wraps the default VFS, which must not be the io_uring VFS. Registering again changes the options of files
+   * opened afterwards.
+   *
+   * @param options settings of the VFS
+   * @param loc caller location
+   * @throws sqlite_error with sqlite_errc::misuse if an option is invalid or the default VFS is the io_uring VFS
+   */
+  SQLITE_WRAPPER_EXPORT void register_compressed_vfs(const compressed_vfs_options& options = {},
+                                                     const std::source_location& loc = std::source_location::current());
+
+  /**
+   * Returns the sizes of a database file written by the compressing VFS.
+   *
+   * @param file_name path of the database file
+   * @param loc caller location
+   * @throws sqlite_error with sqlite_errc::cantopen if the file can not be read, or sqlite_errc::notadb if it is not
+   *   written by the compressing VFS
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_compression_stats(
+      const std::string& file_name, const std::source_location& loc = std::source_location::current()) -> compression_stats;
+}  // namespace sqlite_wrapper
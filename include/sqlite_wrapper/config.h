@@ -17,3 +17,17 @@
 #else  // ignore SQLITE_WRAPPER_EXPORT when building or using sqlite_wrapper_static
 #  define SQLITE_WRAPPER_EXPORT
 #endif
+
+// success paths of binding and column access are either inline in the headers or exported from the library
+#ifdef SQLITE_WRAPPER_INLINE_HOT_PATH
+#  define SQLITE_WRAPPER_HOT_PATH_API inline
+#else
+#  define SQLITE_WRAPPER_HOT_PATH_API SQLITE_WRAPPER_EXPORT
+#endif
+
+// allows empty members to take no space, MSVC ignores the standard attribute
+#ifdef _MSC_VER
+#  define SQLITE_WRAPPER_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#  define SQLITE_WRAPPER_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/raii.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <source_location>
+#include <string>
+#include <vector>
+
+namespace sqlite_wrapper
+{
+  class connection_pool;
+
+  /**
+   * Settings of a connection_pool.
+   */
+  struct connection_pool_options
+  {
+    static constexpr std::size_t default_reader_count{4};
+
+    std::size_t reader_count{default_reader_count};  ///< number of read-only connections, must be > 0
+
+    /**
+     * Options of all connections, the pool always uses journal_mode::wal and no_mutex and opens the readers with read_only.
+     */
+    open_options connection_options{open_options::read_mostly()};
+  };
+
+  /**
+   * Usage statistics of a connection_pool, wait and busy times are summed up over all checkouts.
+   */
+  struct connection_pool_metrics
+  {
+    std::size_t reader_count{};
+    std::size_t readers_in_use{};
+    bool writer_in_use{};
+
+    std::uint64_t reader_checkouts{};
+    std::uint64_t writer_checkouts{};
+    std::uint64_t timeouts{};
+
+    std::chrono::nanoseconds reader_wait_time{};  ///< time spent waiting for a free reader
+    std::chrono::nanoseconds writer_wait_time{};  ///< time spent waiting for the writer
+    std::chrono::nanoseconds max_wait_time{};     ///< longest wait for a reader or the writer
+
+    std::chrono::nanoseconds reader_busy_time{};  ///< time readers were checked out, only counts returned connections
+    std::chrono::nanoseconds writer_busy_time{};  ///< time the writer was checked out, only counts returned connections
+    std::chrono::nanoseconds lifetime{};          ///< time since the pool was created
+
+    /**
+     * Returns the fraction of the lifetime the readers were checked out, 0.0 to 1.0 .
+     */
+    [[nodiscard]] auto reader_utilization() const noexcept -> double
+    {
+      const auto available{static_cast<double>(lifetime.count()) * static_cast<double>(reader_count)};
+
+      return (available > 0.0) ? (static_cast<double>(reader_busy_time.count()) / available) : 0.0;
+    }
+
+    /**
+     * Returns the fraction of the lifetime the writer was checked out, 0.0 to 1.0 .
+     */
+    [[nodiscard]] auto writer_utilization() const noexcept -> double
+    {
+      return (lifetime.count() > 0) ? (static_cast<double>(writer_busy_time.count()) / static_cast<double>(lifetime.count()))
+                                    : 0.0;
+    }
+  };
+
+  /**
+   * RAII-guard for a connection checked out of a connection_pool, returns the connection to the pool when destroyed.
+   * Must not outlive the pool.
+   */
+  class pooled_connection
+  {
+   public:
+    SQLITE_WRAPPER_EXPORT ~pooled_connection();
+
+    pooled_connection(const pooled_connection&) = delete;
+    auto operator=(const pooled_connection&) -> pooled_connection& = delete;
+
+    SQLITE_WRAPPER_EXPORT pooled_connection(pooled_connection&& other) noexcept;
+    SQLITE_WRAPPER_EXPORT auto operator=(pooled_connection&& other) noexcept -> pooled_connection&;
+
+    /**
+     * Returns the database handle, nullptr if moved from.
+     */
+    [[nodiscard]] auto get() const noexcept -> ::sqlite3*
+    {
+      return m_handle;
+    }
+
+    [[nodiscard]] auto is_writer() const noexcept -> bool
+    {
+      return m_is_writer;
+    }
+
+   private:
+    friend class connection_pool;
+
+    pooled_connection(connection_pool* pool, ::sqlite3* handle, std::size_t index, bool is_writer) noexcept;
+
+    void release() noexcept;
+
+    connection_pool* m_pool;
+    ::sqlite3* m_handle;
+    std::size_t m_index;
+    bool m_is_writer;
+    std::chrono::steady_clock::time_point m_checkout_time;
+  };
+
+  /**
+   * Thread-safe pool of one writer and N read-only connections to a database file in WAL mode.
+   *
+   * Readers never block the writer and each other in WAL mode, so read throughput scales with the number of readers.
+   * All writes must go through the single writer connection, checked out with checkout_writer().
+   */
+  class connection_pool
+  {
+   public:
+    static constexpr std::chrono::milliseconds default_checkout_timeout{5000};
+
+    /**
+     * Opens or creates the database file, switches it to WAL mode and opens the connections.
+     *
+     * @param file_name name of the database file to open or create incl. an absolute or relative path
+     * @param options settings of the pool
+     * @param loc caller location
+     * @throws sqlite_error if a connection can not be opened or the database does not support WAL mode (like :memory:)
+     */
+    SQLITE_WRAPPER_EXPORT explicit connection_pool(const std::string& file_name, const connection_pool_options& options = {},
+                                                   const std::source_location& loc = std::source_location::current());
+
+    SQLITE_WRAPPER_EXPORT ~connection_pool();
+
+    connection_pool(const connection_pool&) = delete;
+    connection_pool(connection_pool&&) = delete;
+    auto operator=(const connection_pool&) -> connection_pool& = delete;
+    auto operator=(connection_pool&&) -> connection_pool& = delete;
+
+    /**
+     * Checks out a read-only connection, waits up to \p timeout for one to become available.
+     *
+     * @throws sqlite_error with sqlite_errc::busy on timeout
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto checkout_reader(
+        std::chrono::milliseconds timeout = default_checkout_timeout,
+        const std::source_location& loc = std::source_location::current()) -> pooled_connection;
+
+    /**
+     * Checks out the writer connection, waits up to \p timeout for it to become available.
+     *
+     * @throws sqlite_error with sqlite_errc::busy on timeout
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto checkout_writer(
+        std::chrono::milliseconds timeout = default_checkout_timeout,
+        const std::source_location& loc = std::source_location::current()) -> pooled_connection;
+
+    /**
+     * Checks out a read-only connection, waits up to \p timeout for one to become available.
+     *
+     * @returns the connection or std::nullopt on timeout
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto try_checkout_reader(std::chrono::milliseconds timeout = {})
+        -> std::optional<pooled_connection>;
+
+    /**
+     * Checks out the writer connection, waits up to \p timeout for it to become available.
+     *
+     * @returns the connection or std::nullopt on timeout
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto try_checkout_writer(std::chrono::milliseconds timeout = {})
+        -> std::optional<pooled_connection>;
+
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_metrics() const -> connection_pool_metrics;
+
+    [[nodiscard]] auto file_name() const noexcept -> const std::string&
+    {
+      return m_file_name;
+    }
+
+   private:
+    friend class pooled_connection;
+
+    [[nodiscard]] auto checkout(bool is_writer, std::chrono::milliseconds timeout) -> std::optional<pooled_connection>;
+
+    void check_in(std::size_t index, bool is_writer, std::chrono::steady_clock::time_point checkout_time) noexcept;
+
+    std::string m_file_name;
+    std::chrono::steady_clock::time_point m_created;
+
+    database m_writer;
+    std::vector<database> m_readers;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_reader_available;
+    std::condition_variable m_writer_available;
+    std::vector<std::size_t> m_free_readers;  // indices into m_readers
+    bool m_writer_free{true};
+    connection_pool_metrics m_metrics;
+  };
+}  // namespace sqlite_wrapper
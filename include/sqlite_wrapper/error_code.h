@@ -0,0 +1,117 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/format.h"
+
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+// forward declarations of sqlite3 (pimpl) types
+extern "C"
+{
+  struct sqlite3;
+}
+
+namespace sqlite_wrapper
+{
+  /**
+   * SQLite (extended) result codes, see https://www.sqlite.org/rescode.html .
+   * Extended result codes not listed here can still be stored, as they are all valid values of the underlying type.
+   */
+  enum class sqlite_errc : int
+  {
+    ok = 0,
+    error = 1,
+    internal = 2,
+    perm = 3,
+    abort = 4,
+    busy = 5,
+    locked = 6,
+    nomem = 7,
+    readonly = 8,
+    interrupt = 9,
+    ioerr = 10,
+    corrupt = 11,
+    notfound = 12,
+    full = 13,
+    cantopen = 14,
+    protocol = 15,
+    empty = 16,
+    schema = 17,
+    toobig = 18,
+    constraint = 19,
+    mismatch = 20,
+    misuse = 21,
+    nolfs = 22,
+    auth = 23,
+    format = 24,
+    range = 25,
+    notadb = 26,
+    notice = 27,
+    warning = 28,
+    row = 100,
+    done = 101,
+
+    busy_recovery = busy | (1 << 8),
+    busy_snapshot = busy | (2 << 8),
+    busy_timeout = busy | (3 << 8),
+    locked_sharedcache = locked | (1 << 8),
+    locked_vtab = locked | (2 << 8),
+    constraint_check = constraint | (1 << 8),
+    constraint_commithook = constraint | (2 << 8),
+    constraint_foreignkey = constraint | (3 << 8),
+    constraint_function = constraint | (4 << 8),
+    constraint_notnull = constraint | (5 << 8),
+    constraint_primarykey = constraint | (6 << 8),
+    constraint_trigger = constraint | (7 << 8),
+    constraint_unique = constraint | (8 << 8),
+    constraint_vtab = constraint | (9 << 8),
+    constraint_rowid = constraint | (10 << 8),
+    constraint_pinned = constraint | (11 << 8),
+    constraint_datatype = constraint | (12 << 8)
+  };
+
+  /**
+   * Returns the primary result code of an (extended) result code, like sqlite_errc::busy for sqlite_errc::busy_snapshot.
+   */
+  [[nodiscard]] constexpr auto primary_code(sqlite_errc code) noexcept -> sqlite_errc
+  {
+    constexpr auto primary_code_mask{0xff};
+
+    return static_cast<sqlite_errc>(to_underlying(code) & primary_code_mask);
+  }
+
+  /**
+   * Returns the english description SQLite has for an (extended) result code, see sqlite3_errstr().
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_error_string(sqlite_errc code) noexcept -> std::string_view;
+
+  /**
+   * Error category for sqlite_errc, allows to use sqlite_errc as std::error_code.
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto sqlite_category() noexcept -> const std::error_category&;
+
+  [[nodiscard]] inline auto make_error_code(sqlite_errc code) noexcept -> std::error_code
+  {
+    return {to_underlying(code), sqlite_category()};
+  }
+
+  namespace details
+  {
+    /**
+     * Converts a result code returned from SQLite into the extended result code stored in the database connection if it
+     * belongs to \p result.
+     *
+     * @param database database handle the result code belongs to, may be nullptr
+     * @param result result code returned by an SQLite function
+     * @returns the extended result code if available, \p result otherwise
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto to_sqlite_errc(::sqlite3* database, int result) noexcept -> sqlite_errc;
+  }  // namespace details
+}  // namespace sqlite_wrapper
+
+template <>
+struct std::is_error_code_enum<sqlite_wrapper::sqlite_errc> : std::true_type
+{
+};
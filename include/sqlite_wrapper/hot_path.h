@@ -0,0 +1,201 @@
+#pragma once
+
+/**
+ * Success paths of parameter binding and column access.
+ *
+ * If SQLITE_WRAPPER_INLINE_HOT_PATH is defined this header is included by sqlite_wrapper.h and all functions are inline,
+ * otherwise it is only included by sqlite_wrapper.cpp and the functions are exported from the library.
+ * The error paths always stay out of line in sqlite_wrapper.cpp.
+ */
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/error_code.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace sqlite_wrapper::details
+{
+  [[noreturn]] SQLITE_WRAPPER_EXPORT void throw_bind_error(const stmt_with_location& stmt, int index, std::string_view type,
+                                                           int error);
+
+  [[noreturn]] SQLITE_WRAPPER_EXPORT void throw_column_type_error(const stmt_with_location& stmt, int index, int type,
+                                                                  int expected_type);
+
+  [[noreturn]] SQLITE_WRAPPER_EXPORT void throw_column_nullptr_error(const stmt_with_location& stmt, int index,
+                                                                     std::string_view function_name);
+
+  SQLITE_WRAPPER_HOT_PATH_API void bind_value(const stmt_with_location& stmt, int index)
+  {
+    if (const auto result{::sqlite3_bind_null(stmt.value, index)}; result != SQLITE_OK) [[unlikely]]
+    {
+      throw_bind_error(stmt, index, "null", result);
+    }
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API void bind_value(const stmt_with_location& stmt, int index, std::int64_t value)
+  {
+    if (const auto result{::sqlite3_bind_int64(stmt.value, index, value)}; result != SQLITE_OK) [[unlikely]]
+    {
+      throw_bind_error(stmt, index, "int64", result);
+    }
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API void bind_value(const stmt_with_location& stmt, int index, double value)
+  {
+    if (const auto result{::sqlite3_bind_double(stmt.value, index, value)}; result != SQLITE_OK) [[unlikely]]
+    {
+      throw_bind_error(stmt, index, "double", result);
+    }
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API void bind_value(const stmt_with_location& stmt, int index, std::string_view value)
+  {
+    if (const auto result{::sqlite3_bind_text64(stmt.value, index, value.data(), value.size(), nullptr, SQLITE_UTF8)};
+        result != SQLITE_OK) [[unlikely]]
+    {
+      throw_bind_error(stmt, index, "string", result);
+    }
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API void bind_value(const stmt_with_location& stmt, int index, const_byte_span value)
+  {
+    if (const auto result{::sqlite3_bind_blob64(stmt.value, index, value.data(), value.size(), nullptr)}; result != SQLITE_OK)
+        [[unlikely]]
+    {
+      throw_bind_error(stmt, index, "BLOB", result);
+    }
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API auto try_bind_value(const stmt_with_location& stmt, int index) noexcept -> sqlite_errc
+  {
+    return static_cast<sqlite_errc>(::sqlite3_bind_null(stmt.value, index));
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API auto try_bind_value(const stmt_with_location& stmt, int index, std::int64_t value) noexcept
+      -> sqlite_errc
+  {
+    return static_cast<sqlite_errc>(::sqlite3_bind_int64(stmt.value, index, value));
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API auto try_bind_value(const stmt_with_location& stmt, int index, double value) noexcept -> sqlite_errc
+  {
+    return static_cast<sqlite_errc>(::sqlite3_bind_double(stmt.value, index, value));
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API auto try_bind_value(const stmt_with_location& stmt, int index, std::string_view value) noexcept
+      -> sqlite_errc
+  {
+    return static_cast<sqlite_errc>(::sqlite3_bind_text64(stmt.value, index, value.data(), value.size(), nullptr, SQLITE_UTF8));
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API auto try_bind_value(const stmt_with_location& stmt, int index, const_byte_span value) noexcept
+      -> sqlite_errc
+  {
+    return static_cast<sqlite_errc>(::sqlite3_bind_blob64(stmt.value, index, value.data(), value.size(), nullptr));
+  }
+
+  /**
+   * Checks a column in a "ready to be returned row", in a prepared statement, to have the expected type.
+   *
+   * @param stmt statement
+   * @param index index of column to check (0 based)
+   * @param expected_type expected column type
+   * @param maybe_null indicates if NULL is allowed.
+   *
+   * @throws sqlite_error exception if expected_type does not match the actual columns type.
+   * @returns true if the type matches, false if, and only if, it is NULL AND maybe_null is true.
+   */
+  [[nodiscard]] inline auto check_null_and_column_type(const stmt_with_location& stmt, int index, int expected_type,
+                                                       bool maybe_null) -> bool
+  {
+    const auto type{::sqlite3_column_type(stmt.value, index)};
+
+    if (type == expected_type) [[likely]]
+    {
+      return true;
+    }
+
+    if ((type == SQLITE_NULL) && maybe_null)
+    {
+      return false;
+    }
+
+    throw_column_type_error(stmt, index, type, expected_type);
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API auto get_column(const stmt_with_location& stmt, int index, std::int64_t& value, bool maybe_null)
+      -> bool
+  {
+    if (!check_null_and_column_type(stmt, index, SQLITE_INTEGER, maybe_null))
+    {
+      return false;
+    }
+
+    value = ::sqlite3_column_int64(stmt.value, index);
+
+    return true;
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API auto get_column(const stmt_with_location& stmt, int index, double& value, bool maybe_null) -> bool
+  {
+    if (!check_null_and_column_type(stmt, index, SQLITE_FLOAT, maybe_null))
+    {
+      return false;
+    }
+
+    value = ::sqlite3_column_double(stmt.value, index);
+
+    return true;
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API auto get_column(const stmt_with_location& stmt, int index, std::string& value, bool maybe_null)
+      -> bool
+  {
+    if (!check_null_and_column_type(stmt, index, SQLITE_TEXT, maybe_null))
+    {
+      return false;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto* str{reinterpret_cast<const char*>(::sqlite3_column_text(stmt.value, index))};
+    const auto length{static_cast<std::size_t>(::sqlite3_column_bytes(stmt.value, index))};
+
+    if (str == nullptr) [[unlikely]]
+    {
+      throw_column_nullptr_error(stmt, index, "sqlite3_column_text()");
+    }
+
+    value.assign(str, length);
+
+    return true;
+  }
+
+  SQLITE_WRAPPER_HOT_PATH_API auto get_column(const stmt_with_location& stmt, int index, byte_vector& value, bool maybe_null)
+      -> bool
+  {
+    if (!check_null_and_column_type(stmt, index, SQLITE_BLOB, maybe_null))
+    {
+      return false;
+    }
+
+    const auto* data{static_cast<const std::byte*>(::sqlite3_column_blob(stmt.value, index))};
+    const auto length{static_cast<std::size_t>(::sqlite3_column_bytes(stmt.value, index))};
+
+    if (data == nullptr) [[unlikely]]
+    {
+      throw_column_nullptr_error(stmt, index, "sqlite3_column_blob()");
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    value.assign(data, data + length);
+
+    return true;
+  }
+}  // namespace sqlite_wrapper::details
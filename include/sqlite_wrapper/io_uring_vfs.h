@@ -0,0 +1,67 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+
+#include <cstddef>
+#include <source_location>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Name of the io_uring VFS, to be used as open_options::vfs after register_io_uring_vfs().
+   */
+  inline constexpr auto io_uring_vfs_name{"sqlite_wrapper_io_uring"};
+
+  /**
+   * Settings of the io_uring VFS.
+   */
+  struct io_uring_vfs_options
+  {
+    static constexpr unsigned default_queue_depth{64};
+    static constexpr std::size_t default_max_batch_size{1024 * 1024};
+
+    unsigned queue_depth{default_queue_depth};  ///< entries of the io_uring of each thread, from 1 to 4096
+
+    /**
+     * Bytes of writes that are buffered per file before they are submitted together, must be > 0. Buffered writes are
+     * always submitted before any other operation on the file, like a sync, lock change or read.
+     */
+    std::size_t max_batch_size{default_max_batch_size};
+
+    /**
+     * Opens database files with O_DIRECT, bypassing the page cache of the OS. Page-aligned reads and writes go through an
+     * aligned buffer pool, others and file systems without O_DIRECT support use buffered I/O. Pages must be at least
+     * 4096 bytes to benefit.
+     */
+    bool direct_io{false};
+  };
+
+  /**
+   * Returns true if this is Linux and the kernel allows to use io_uring.
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto is_io_uring_supported() noexcept -> bool;
+
+  /**
+   * Registers a VFS that reads and writes database, journal and WAL files through io_uring, see
+   * https://www.sqlite.org/vfs.html .
+   *
+   * The VFS wraps the default unix VFS, which still does locking, shared memory, syncs and all other files. Writes are
+   * buffered per file and submitted as one batch, so the frames of a WAL commit take one system call. Memory-mapped I/O
+   * is not used for files read through io_uring. Every thread gets its own io_uring.
+   *
+   * As with the unix VFS, database files must not be opened and closed by other means while a connection uses them,
+   * closing another file descriptor of a database file releases the POSIX locks of the process. All connections of a
+   * process to a database file should therefore use the same VFS.
+   *
+   * Registering again changes the options of files opened afterwards, queue_depth only of threads that did not use the VFS
+   * yet.
+   *
+   * @param options settings of the VFS
+   * @param make_default true to make it the default VFS of all connections opened afterwards
+   * @param loc caller location
+   * @throws sqlite_error with sqlite_errc::misuse if an option is invalid, or sqlite_errc::error if io_uring is not
+   *   supported, see is_io_uring_supported()
+   */
+  SQLITE_WRAPPER_EXPORT void register_io_uring_vfs(const io_uring_vfs_options& options = {}, bool make_default = false,
+                                                   const std::source_location& loc = std::source_location::current());
+}  // namespace sqlite_wrapper
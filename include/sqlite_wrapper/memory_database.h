@@ -0,0 +1,60 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/raii.h"
+
+#include <source_location>
+#include <string>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Opens an in-memory database using the "memdb" VFS.
+   *
+   * A shared database is visible to all connections of the process that open the same name and lives as long as at
+   * least one of them is open. Other than shared-cache databases it uses the normal file locking, so connections can read
+   * concurrently. A private database is only visible to the returned connection.
+   *
+   * @param name name of the database, must not contain '/', '?' or '#' and not be empty if \p shared, a private database
+   *   without name is opened as ":memory:"
+   * @param shared true to share the database with other connections opening the same name
+   * @param options settings of the connection, uri and open_or_create are always set, journal_mode::wal is not supported
+   * @param loc caller location
+   * @returns a database handle in a RAII guard
+   * @throws sqlite_error with sqlite_errc::misuse in case the name or an option is invalid, or in case SQLite returns an
+   *   error
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto open_memory(const std::string& name = {}, bool shared = false,
+                                                       open_options options = {},
+                                                       const std::source_location& loc = std::source_location::current())
+      -> database;
+
+  /**
+   * Copies the whole "main" database of \p source into \p destination with the online backup API, replacing all content
+   * of \p destination, see backup for a copy in steps.
+   *
+   * @param source database to copy from
+   * @param destination database to copy to, must not be used by another thread during the copy
+   * @throws sqlite_error with sqlite_errc::busy if \p source or \p destination stays locked by another connection for
+   *   longer than backup_options::default_busy_timeout, or in case SQLite returns an error, like if \p destination has
+   *   an open transaction
+   */
+  SQLITE_WRAPPER_EXPORT void copy_database(const db_with_location& source, const db_with_location& destination);
+
+  /**
+   * Opens an in-memory database, see open_memory(), and preloads it with the content of a database file.
+   *
+   * @param file_name name of the existing database file to load, it is opened read-only
+   * @param name name of the in-memory database
+   * @param shared true to share the in-memory database with other connections opening the same name
+   * @param options settings of the connection to the in-memory database
+   * @param loc caller location
+   * @returns a database handle in a RAII guard
+   * @throws sqlite_error in case the file can not be opened or read, the name or an option is invalid or SQLite returns an
+   *   error
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto open_memory_from_file(
+      const std::string& file_name, const std::string& name = {}, bool shared = false, open_options options = {},
+      const std::source_location& loc = std::source_location::current()) -> database;
+}  // namespace sqlite_wrapper
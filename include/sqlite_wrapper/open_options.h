@@ -0,0 +1,209 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <source_location>
+#include <string>
+#include <string_view>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Values of PRAGMA journal_mode, see https://www.sqlite.org/pragma.html#pragma_journal_mode .
+   */
+  enum class journal_mode : unsigned
+  {
+    delete_file = 0,  ///< DELETE, rollback journal is deleted at the end of each transaction (SQLite default)
+    truncate,         ///< TRUNCATE, rollback journal is truncated instead of deleted
+    persist,          ///< PERSIST, rollback journal header is zeroed instead of deleted
+    memory,           ///< MEMORY, rollback journal is kept in memory
+    wal,              ///< WAL, write-ahead log, readers do not block the writer and vice versa
+    off               ///< OFF, no rollback journal, ROLLBACK is undefined and a crash can corrupt the database
+  };
+
+  /**
+   * Values of PRAGMA synchronous, see https://www.sqlite.org/pragma.html#pragma_synchronous .
+   */
+  enum class synchronous_mode : unsigned
+  {
+    off = 0,     ///< no syncs at all
+    normal = 1,  ///< sync at critical moments, durable in WAL mode except for the last transactions after power loss
+    full = 2,    ///< sync on every commit (SQLite default)
+    extra = 3    ///< like full and also syncs the directory after deleting a rollback journal
+  };
+
+  /**
+   * Values of PRAGMA temp_store, see https://www.sqlite.org/pragma.html#pragma_temp_store .
+   */
+  enum class temp_store_mode : unsigned
+  {
+    use_default = 0,  ///< as defined by SQLITE_TEMP_STORE at compile time
+    file = 1,         ///< temporary tables and indices are stored in files
+    memory = 2        ///< temporary tables and indices are stored in memory
+  };
+
+  /**
+   * Lookaside memory allocator of a connection, see SQLITE_DBCONFIG_LOOKASIDE .
+   */
+  struct lookaside_config
+  {
+    int slot_size{};   ///< size of each slot in bytes, a multiple of 8, 0 disables lookaside
+    int slot_count{};  ///< number of slots, 0 disables lookaside
+  };
+
+  /**
+   * Settings of a database connection that are applied by open(), unset values keep the SQLite defaults.
+   */
+  struct open_options
+  {
+    open_flags flags{open_flags::open_or_create};
+
+    bool read_only{false};  ///< SQLITE_OPEN_READONLY, requires open_flags::open_only
+    bool no_mutex{false};   ///< SQLITE_OPEN_NOMUTEX, connection must not be used by more than one thread at a time
+    bool uri{false};        ///< SQLITE_OPEN_URI, file name is interpreted as URI like "file:data.db?mode=ro"
+    bool memory{false};     ///< SQLITE_OPEN_MEMORY, database is held in memory, file name is only used for shared cache
+
+    std::optional<journal_mode> journal{};
+    std::optional<synchronous_mode> synchronous{};
+    std::optional<std::int64_t> cache_size{};  ///< PRAGMA cache_size, pages if positive, KiB if negative
+    std::optional<std::int64_t> mmap_size{};   ///< PRAGMA mmap_size in bytes, 0 disables memory-mapped I/O
+    std::optional<temp_store_mode> temp_store{};
+    std::optional<std::chrono::milliseconds> busy_timeout{};  ///< see sqlite3_busy_timeout()
+    std::optional<std::uint32_t> page_size{};  ///< power of two from 512 to 65536, only changes new databases or after VACUUM
+    std::optional<lookaside_config> lookaside{};
+    std::string vfs{};  ///< name of a registered VFS like io_uring_vfs_name, empty for the default VFS
+
+    /**
+     * Fastest possible writes for loading a new database in one go, a crash during loading may corrupt the database.
+     */
+    [[nodiscard]] static constexpr auto bulk_load() -> open_options
+    {
+      constexpr std::int64_t cache_size_kib{-256 * 1024};
+
+      return {.journal = journal_mode::off,
+              .synchronous = synchronous_mode::off,
+              .cache_size = cache_size_kib,
+              .temp_store = temp_store_mode::memory};
+    }
+
+    /**
+     * WAL mode with a large cache and memory-mapped I/O for workloads dominated by reads.
+     */
+    [[nodiscard]] static constexpr auto read_mostly() -> open_options
+    {
+      constexpr std::int64_t cache_size_kib{-64 * 1024};
+      constexpr std::int64_t mmap_size_bytes{256 * 1024 * 1024};
+      constexpr std::chrono::milliseconds timeout{5000};
+
+      return {.journal = journal_mode::wal,
+              .synchronous = synchronous_mode::normal,
+              .cache_size = cache_size_kib,
+              .mmap_size = mmap_size_bytes,
+              .temp_store = temp_store_mode::memory,
+              .busy_timeout = timeout};
+    }
+
+    /**
+     * WAL mode where every commit is durable, for transactional workloads with concurrent writers.
+     */
+    [[nodiscard]] static constexpr auto durable_oltp() -> open_options
+    {
+      constexpr std::int64_t cache_size_kib{-16 * 1024};
+      constexpr std::chrono::milliseconds timeout{5000};
+
+      return {.journal = journal_mode::wal,
+              .synchronous = synchronous_mode::full,
+              .cache_size = cache_size_kib,
+              .busy_timeout = timeout};
+    }
+  };
+
+  /**
+   * Checks options for invalid values and combinations without opening a database.
+   *
+   * @param options options to check
+   * @param loc caller location
+   * @throws sqlite_error with sqlite_errc::misuse describing the first problem found
+   */
+  SQLITE_WRAPPER_EXPORT void validate(const open_options& options,
+                                      const std::source_location& loc = std::source_location::current());
+
+  /**
+   * Opens or creates a database file and applies all options, either all options are applied or no database is returned.
+   *
+   * @param file_name name of the database file to open or create incl. an absolute or relative path
+   * @param options flags and settings of the connection, see validate()
+   * @param loc caller location
+   * @returns a database handle in a RAII guard
+   * @throws sqlite_error in case an option is invalid, SQLite returns an error or an option does not take effect (like
+   *   journal_mode::wal for an in-memory database)
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto open(const std::string& file_name, const open_options& options,
+                                                const std::source_location& loc = std::source_location::current()) -> database;
+
+  /**
+   * Opens a database file read-only with the URI parameter immutable=1, see https://www.sqlite.org/uri.html#uriimmutable .
+   *
+   * SQLite takes no locks and does not check for changes of an immutable database, so lookups skip the shared lock and
+   * the change counter check of each transaction. Memory-mapped I/O is set to the file size by default, so all processes
+   * opening the same file read it from the same pages of the OS page cache. The file must not be changed while any
+   * connection has it open, else queries return wrong results or fail with SQLITE_CORRUPT. A database in WAL mode must be
+   * checkpointed first, as the WAL is ignored.
+   *
+   * @param file_name name of the existing database file incl. an absolute or relative path, it is converted to a URI
+   * @param options settings of the connection, flags, read_only and uri are always set, mmap_size defaults to the file size
+   *   limited by SQLITE_MAX_MMAP_SIZE
+   * @param loc caller location
+   * @returns a database handle in a RAII guard
+   * @throws sqlite_error in case the file does not exist, an option is invalid or SQLite returns an error
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto open_immutable(const std::string& file_name, open_options options = {},
+                                                          const std::source_location& loc = std::source_location::current())
+      -> database;
+}  // namespace sqlite_wrapper
+
+namespace SQLITEWRAPPER_FORMAT_NAMESPACE_NAME
+{
+  template <>
+  // NOLINTNEXTLINE(cert-dcl58-cpp) modification of 'std' namespace can result in undefined behavior
+  struct formatter<sqlite_wrapper::journal_mode> : sqlite_wrapper::empty_format_spec
+  {
+    template <typename FmtContext>
+    static auto format(sqlite_wrapper::journal_mode mode, FmtContext& ctx)
+    {
+      using namespace std::string_view_literals;
+      std::string_view mode_str{};
+
+      switch (mode)
+      {
+        case sqlite_wrapper::journal_mode::delete_file:
+          mode_str = "delete"sv;
+          break;
+        case sqlite_wrapper::journal_mode::truncate:
+          mode_str = "truncate"sv;
+          break;
+        case sqlite_wrapper::journal_mode::persist:
+          mode_str = "persist"sv;
+          break;
+        case sqlite_wrapper::journal_mode::memory:
+          mode_str = "memory"sv;
+          break;
+        case sqlite_wrapper::journal_mode::wal:
+          mode_str = "wal"sv;
+          break;
+        case sqlite_wrapper::journal_mode::off:
+          mode_str = "off"sv;
+          break;
+        default:
+          return SQLITEWRAPPER_FORMAT_NAMESPACE::format_to(ctx.out(), "<unknown ({})>", sqlite_wrapper::to_underlying(mode));
+      }
+      return SQLITEWRAPPER_FORMAT_NAMESPACE::format_to(ctx.out(), "{}", mode_str);
+    }
+  };
+}  // namespace SQLITEWRAPPER_FORMAT_NAMESPACE_NAME
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Page caches SQLite can be configured with, see configure_page_cache().
+   */
+  enum class page_cache_kind : unsigned
+  {
+    sqlite_default = 0,  ///< the page cache SQLite used before the first call of configure_page_cache()
+    slabs                ///< pages in slabs of huge pages with a memory budget shared by all connections
+  };
+
+  /**
+   * How slabs of page_cache_kind::slabs are backed by huge pages, always by normal memory on other systems than Linux.
+   */
+  enum class huge_pages : unsigned
+  {
+    none = 0,        ///< normal pages of the system
+    transparent,     ///< normal pages the kernel is asked to back with transparent huge pages, see madvise(MADV_HUGEPAGE)
+    explicit_first   ///< explicit huge pages of the hugetlbfs pool (MAP_HUGETLB), transparent if the pool is empty
+  };
+
+  /**
+   * Settings of configure_page_cache().
+   */
+  struct page_cache_options
+  {
+    static constexpr std::size_t default_budget{1024ULL * 1024 * 1024};
+    static constexpr std::size_t default_slab_size{2ULL * 1024 * 1024};
+    static constexpr std::size_t slab_alignment{64ULL * 1024};
+
+    page_cache_kind kind{page_cache_kind::slabs};
+
+    /**
+     * Most bytes of slabs of all page caches, must be > 0. A page cache at the budget reuses its least recently used
+     * page, only if it has none is another slab allocated beyond the budget. Pages of in-memory and temporary databases
+     * are never reused, their page caches take slabs beyond the budget once it is used up.
+     */
+    std::size_t budget{default_budget};
+
+    /**
+     * Most bytes allocated at once for the pages of a page cache, must be a multiple of slab_alignment, 2 MiB matches a
+     * huge page on x86-64. The first slab of a page cache has slab_alignment bytes and every further one twice as many up
+     * to slab_size, so small page caches and those of in-memory and temporary databases do not take a whole slab.
+     */
+    std::size_t slab_size{default_slab_size};
+
+    sqlite_wrapper::huge_pages huge_pages{sqlite_wrapper::huge_pages::explicit_first};
+  };
+
+  /**
+   * Statistics of the page caches of configure_page_cache() of all connections.
+   */
+  struct page_cache_metrics
+  {
+    std::uint64_t fetches{};            ///< lookups of pages by SQLite
+    std::uint64_t hits{};               ///< lookups of pages in the cache
+    std::uint64_t creations{};          ///< pages added for lookups of pages not in the cache
+    std::uint64_t evictions{};          ///< unpinned pages reused for other pages
+    std::uint64_t slabs{};              ///< slabs allocated
+    std::uint64_t huge_page_slabs{};    ///< slabs of explicit huge pages
+    std::uint64_t over_budget_slabs{};  ///< slabs allocated beyond the budget
+    std::int64_t bytes_reserved{};      ///< bytes of slabs in use, not reset by reset_page_cache_metrics()
+
+    /**
+     * Returns the fraction of lookups found in the cache, 0.0 to 1.0 .
+     */
+    [[nodiscard]] auto hit_ratio() const noexcept -> double
+    {
+      return (fetches > 0) ? (static_cast<double>(hits) / static_cast<double>(fetches)) : 0.0;
+    }
+  };
+
+  /**
+   * Replaces the page cache of SQLite with SQLITE_CONFIG_PCACHE2, see https://www.sqlite.org/c3ref/pcache_methods2.html .
+   *
+   * page_cache_kind::slabs is meant for large cache sizes (PRAGMA cache_size) where TLB misses of the page cache show. The
+   * pages of a page cache are carved from slabs of up to slab_size bytes backed by huge pages, so a TLB entry covers 2 MiB of
+   * pages instead of 4 KiB, and are found with an open-addressing hash table of the page numbers. Unpinned pages are kept
+   * in least recently used order and reused once the cache size of the connection or the budget of all page caches is
+   * reached. Slabs are returned to the system when their page cache is destroyed or shrunk without pages left, for
+   * example by sqlite3_db_release_memory().
+   *
+   * SQLite must not be initialized yet, so the function must be called before the first connection is opened, or after
+   * all connections are closed and sqlite3_shutdown() is called.
+   *
+   * @param options page cache to use
+   * @param loc caller location
+   * @throws sqlite_error with sqlite_errc::misuse if an option is invalid or SQLite is already initialized
+   */
+  SQLITE_WRAPPER_EXPORT void configure_page_cache(const page_cache_options& options = {},
+                                                  const std::source_location& loc = std::source_location::current());
+
+  /**
+   * Returns the statistics of the page caches since the start of the process or the last reset_page_cache_metrics().
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_page_cache_metrics() noexcept -> page_cache_metrics;
+
+  SQLITE_WRAPPER_EXPORT void reset_page_cache_metrics() noexcept;
+}  // namespace sqlite_wrapper
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Name of the prefetching VFS, to be used as open_options::vfs after register_prefetch_vfs().
+   */
+  inline constexpr auto prefetch_vfs_name{"sqlite_wrapper_prefetch"};
+
+  /**
+   * Settings of the prefetching VFS.
+   */
+  struct prefetch_vfs_options
+  {
+    static constexpr unsigned default_trigger_reads{4};
+    static constexpr std::size_t default_min_window{128 * 1024};
+    static constexpr std::size_t default_max_window{4 * 1024 * 1024};
+
+    unsigned trigger_reads{default_trigger_reads};  ///< forward reads in a row before prefetching starts, must be > 0
+
+    std::size_t min_window{default_min_window};  ///< bytes prefetched ahead when a scan is detected, must be > 0
+
+    /**
+     * Most bytes prefetched ahead, must be >= min_window. The window doubles each time a scan consumed half of it and
+     * falls back to min_window on a read that is not a forward read.
+     */
+    std::size_t max_window{default_max_window};
+  };
+
+  /**
+   * Statistics of all database files opened with the prefetching VFS.
+   */
+  struct prefetch_vfs_metrics
+  {
+    std::uint64_t reads{};             ///< reads of database pages
+    std::uint64_t sequential_reads{};  ///< reads that continued a forward scan
+    std::uint64_t prefetches{};        ///< windows requested from the OS
+    std::uint64_t prefetched_bytes{};  ///< bytes requested from the OS
+    std::uint64_t hits{};              ///< reads of prefetched bytes
+    std::uint64_t misses{};            ///< reads of bytes that were not prefetched
+
+    /**
+     * Returns the fraction of reads that were prefetched, 0.0 to 1.0 .
+     */
+    [[nodiscard]] auto hit_ratio() const noexcept -> double
+    {
+      return (reads > 0) ? (static_cast<double>(hits) / static_cast<double>(reads)) : 0.0;
+    }
+  };
+
+  /**
+   * Registers a VFS that detects forward scans of database files and asks the OS to read ahead the next pages with
+   * posix_fadvise(POSIX_FADV_WILLNEED), so they are in the page cache when SQLite reads them one page at a time.
+   *
+   * The VFS wraps the default VFS, only reads of main database files are observed, per file handle and so per connection.
+   * Reads that jump backwards or further than the current window ahead stop the prefetching until trigger_reads forward
+   * reads follow again. Prefetching is only done on Linux, elsewhere the VFS only counts reads.
+   *
+   * A prefetched window is only a hint, the OS reads it asynchronously and may drop it again under memory pressure. The
+   * VFS keeps a read-only file descriptor per database file, which is shared with the other VFS of sqlite_wrapper and
+   * closed with the last file, see register_io_uring_vfs() for the consequences on POSIX locks.
+   *
+   * Registering again changes the options of files opened afterwards. The default VFS at the first registration is the
+   * wrapped one, it must not be the io_uring VFS.
+   *
+   * @param options settings of the VFS
+   * @param make_default true to make it the default VFS of all connections opened afterwards
+   * @param loc caller location
+   * @throws sqlite_error with sqlite_errc::misuse if an option is invalid or the default VFS is the io_uring VFS
+   */
+  SQLITE_WRAPPER_EXPORT void register_prefetch_vfs(const prefetch_vfs_options& options = {}, bool make_default = false,
+                                                   const std::source_location& loc = std::source_location::current());
+
+  /**
+   * Returns the statistics of the prefetching VFS since the start of the process or the last reset_prefetch_vfs_metrics().
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_prefetch_vfs_metrics() noexcept -> prefetch_vfs_metrics;
+
+  SQLITE_WRAPPER_EXPORT void reset_prefetch_vfs_metrics() noexcept;
+}  // namespace sqlite_wrapper
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <source_location>
+#include <string>
+
+namespace sqlite_wrapper
+{
+  /**
+   * How deserialize() uses the given database image.
+   */
+  enum class deserialize_mode : unsigned
+  {
+    copy = 0,       ///< the image is copied, the database can be written and grows as needed
+    read_only_copy, ///< the image is copied, the database is read-only
+    read_only_view  ///< the image is used in place without a copy, the database is read-only
+  };
+
+  /**
+   * Returns the content of a database as it would be stored in a database file, see
+   * https://www.sqlite.org/c3ref/serialize.html .
+   *
+   * @param database connection to serialize a database of
+   * @param schema name of the database, like "main" or the name of an attached database
+   * @param loc caller location
+   * @returns a copy of the database image
+   * @throws sqlite_error in case the schema does not exist or SQLite returns an error
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto serialize(::sqlite3* database, const std::string& schema = "main",
+                                                     const std::source_location& loc = std::source_location::current())
+      -> byte_vector;
+
+  /**
+   * Replaces a database with an in-memory database that has the given image as its content, see
+   * https://www.sqlite.org/c3ref/deserialize.html .
+   *
+   * With deserialize_mode::read_only_view no page is copied or read from a file, \p image can be a prebuilt database
+   * image or a memory mapped database file. The memory of \p image must stay valid and unchanged until the database is
+   * closed or replaced.
+   *
+   * @param database connection to replace a database of, the database must not be in use by a transaction or backup
+   * @param image database image as returned by serialize() or as stored in a database file
+   * @param mode how \p image is used
+   * @param schema name of the database, like "main" or the name of an attached database
+   * @param loc caller location
+   * @throws sqlite_error in case SQLite returns an error
+   */
+  SQLITE_WRAPPER_EXPORT void deserialize(::sqlite3* database, const_byte_span image,
+                                         deserialize_mode mode = deserialize_mode::copy, const std::string& schema = "main",
+                                         const std::source_location& loc = std::source_location::current());
+}  // namespace sqlite_wrapper
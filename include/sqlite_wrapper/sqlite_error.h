@@ -1,9 +1,11 @@
 #pragma once
 
 #include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/error_code.h"
 #include "sqlite_wrapper/raii.h"
 
 #include <cstdint>
+#include <memory>
 #include <source_location>
 #include <stacktrace>
 #include <stdexcept>
@@ -20,8 +22,55 @@ namespace sqlite_wrapper
 #endif
   }
 
+  /**
+   * Enables or disables the capturing of stack traces in exceptions thrown by the current thread.
+   * Capturing is disabled by default and has no effect if stack traces are not supported (see ENABLE_STACK_TRACES).
+   */
+  SQLITE_WRAPPER_EXPORT void set_stack_trace_capture(bool enabled) noexcept;
+
+  /**
+   * Returns true if stack traces are supported and capturing is enabled for the current thread.
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto is_stack_trace_capture_enabled() noexcept -> bool;
+
+  /**
+   * Returns the current stack trace, or an empty one if capturing is disabled for the current thread.
+   */
   [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_stack_trace([[maybe_unused]] std::uint16_t skip = 0) noexcept -> std::stacktrace;
 
+  /**
+   * Enables or disables capturing of stack traces for the current thread for its lifetime and restores the previous
+   * setting afterwards.
+   */
+  class scoped_stack_trace_capture
+  {
+   public:
+    explicit scoped_stack_trace_capture(bool enabled) noexcept : m_previous{is_stack_trace_capture_enabled()}
+    {
+      set_stack_trace_capture(enabled);
+    }
+
+    ~scoped_stack_trace_capture()
+    {
+      set_stack_trace_capture(m_previous);
+    }
+
+    scoped_stack_trace_capture(const scoped_stack_trace_capture&) = delete;
+    scoped_stack_trace_capture(scoped_stack_trace_capture&&) = delete;
+
+    auto operator=(const scoped_stack_trace_capture&) -> scoped_stack_trace_capture& = delete;
+    auto operator=(scoped_stack_trace_capture&&) -> scoped_stack_trace_capture& = delete;
+
+   private:
+    bool m_previous;
+  };
+
+  /**
+   * Exception thrown by all throwing functions of sqlite_wrapper.
+   *
+   * The error message and the SQL text are copied when thrown, the full message returned by what() is only formatted on
+   * first access.
+   */
   class sqlite_error : public std::runtime_error
   {
    public:
@@ -40,22 +89,36 @@ namespace sqlite_wrapper
                  std::stacktrace&& stacktrace = get_stack_trace(1))
         : sqlite_error(what, db_with_location{nullptr, loc}, error, std::move(stacktrace))
     {
+      m_location = loc;  // db_with_location does not record it if SQLITE_WRAPPER_STRIP_LOCATION is defined
     }
 
     SQLITE_WRAPPER_EXPORT ~sqlite_error() override = default;
 
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto what() const noexcept -> const char* override;
     [[nodiscard]] SQLITE_WRAPPER_EXPORT auto where() const -> const std::source_location&;
     [[nodiscard]] SQLITE_WRAPPER_EXPORT auto stack_trace() const -> const std::stacktrace&;
 
-    SQLITE_WRAPPER_EXPORT sqlite_error(const sqlite_error& other) = default;
-    SQLITE_WRAPPER_EXPORT sqlite_error(sqlite_error&& other) = default;
+    /**
+     * Returns the primary result code, sqlite_errc::ok if the error was not reported by SQLite.
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto code() const noexcept -> sqlite_errc;
+
+    /**
+     * Returns the extended result code if the database connection provided one, the primary result code otherwise.
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto extended_code() const noexcept -> sqlite_errc;
 
+    // no move operations, a moved-from exception must still return a valid what(), so moving copies the shared message
+    SQLITE_WRAPPER_EXPORT sqlite_error(const sqlite_error& other) = default;
     SQLITE_WRAPPER_EXPORT auto operator=(const sqlite_error& other) -> sqlite_error& = default;
-    SQLITE_WRAPPER_EXPORT auto operator=(sqlite_error&& other) -> sqlite_error& = default;
 
    private:
+    struct message_data;
+
     std::source_location m_location;
     std::stacktrace m_stacktrace;
+    sqlite_errc m_extended_code;
+    std::shared_ptr<message_data> m_message_data;  // shared by copies, as exceptions must be copyable without throwing
   };
 
 }  // namespace sqlite_wrapper
@@ -2,6 +2,7 @@
 
 #include "sqlite_wrapper/concepts.h"
 #include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/error_code.h"
 #include "sqlite_wrapper/format.h"
 #include "sqlite_wrapper/raii.h"
 #include "sqlite_wrapper/sqlite_error.h"
@@ -10,6 +11,7 @@
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <expected>
 #include <limits>
 #include <optional>
 #include <ranges>
@@ -127,11 +129,12 @@ namespace sqlite_wrapper
     [[nodiscard]] SQLITE_WRAPPER_EXPORT auto create_prepared_statement(const db_with_location& database, std::string_view sql)
         -> statement;
 
-    SQLITE_WRAPPER_EXPORT void bind_value(const stmt_with_location& stmt, int index);  // null-value
-    SQLITE_WRAPPER_EXPORT void bind_value(const stmt_with_location& stmt, int index, std::int64_t value);
-    SQLITE_WRAPPER_EXPORT void bind_value(const stmt_with_location& stmt, int index, double value);
-    SQLITE_WRAPPER_EXPORT void bind_value(const stmt_with_location& stmt, int index, std::string_view value);
-    SQLITE_WRAPPER_EXPORT void bind_value(const stmt_with_location& stmt, int index, const_byte_span value);
+    // defined in hot_path.h, inline if SQLITE_WRAPPER_INLINE_HOT_PATH is defined
+    SQLITE_WRAPPER_HOT_PATH_API void bind_value(const stmt_with_location& stmt, int index);  // null-value
+    SQLITE_WRAPPER_HOT_PATH_API void bind_value(const stmt_with_location& stmt, int index, std::int64_t value);
+    SQLITE_WRAPPER_HOT_PATH_API void bind_value(const stmt_with_location& stmt, int index, double value);
+    SQLITE_WRAPPER_HOT_PATH_API void bind_value(const stmt_with_location& stmt, int index, std::string_view value);
+    SQLITE_WRAPPER_HOT_PATH_API void bind_value(const stmt_with_location& stmt, int index, const_byte_span value);
 
     void bind_value(const stmt_with_location& stmt, int index, const integral_binding_type auto& param)
     {
@@ -174,11 +177,15 @@ namespace sqlite_wrapper
       index++;
     }
 
-    SQLITE_WRAPPER_EXPORT auto get_column(const stmt_with_location& stmt, int index, std::int64_t& value, bool maybe_null)
+    // defined in hot_path.h, inline if SQLITE_WRAPPER_INLINE_HOT_PATH is defined
+    SQLITE_WRAPPER_HOT_PATH_API auto get_column(const stmt_with_location& stmt, int index, std::int64_t& value, bool maybe_null)
+        -> bool;
+    SQLITE_WRAPPER_HOT_PATH_API auto get_column(const stmt_with_location& stmt, int index, double& value, bool maybe_null)
+        -> bool;
+    SQLITE_WRAPPER_HOT_PATH_API auto get_column(const stmt_with_location& stmt, int index, std::string& value, bool maybe_null)
+        -> bool;
+    SQLITE_WRAPPER_HOT_PATH_API auto get_column(const stmt_with_location& stmt, int index, byte_vector& value, bool maybe_null)
         -> bool;
-    SQLITE_WRAPPER_EXPORT auto get_column(const stmt_with_location& stmt, int index, double& value, bool maybe_null) -> bool;
-    SQLITE_WRAPPER_EXPORT auto get_column(const stmt_with_location& stmt, int index, std::string& value, bool maybe_null) -> bool;
-    SQLITE_WRAPPER_EXPORT auto get_column(const stmt_with_location& stmt, int index, byte_vector& value, bool maybe_null) -> bool;
 
     void get_column(const stmt_with_location& stmt, int index, basic_database_type auto& value)
     {
@@ -205,6 +212,71 @@ namespace sqlite_wrapper
 
     SQLITE_WRAPPER_EXPORT void clear_bindings(const stmt_with_location& stmt);
 
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto try_create_prepared_statement(const db_with_location& database,
+                                                                           std::string_view sql) noexcept
+        -> std::expected<statement, sqlite_errc>;
+
+    // defined in hot_path.h, inline if SQLITE_WRAPPER_INLINE_HOT_PATH is defined
+    [[nodiscard]] SQLITE_WRAPPER_HOT_PATH_API auto try_bind_value(const stmt_with_location& stmt, int index) noexcept
+        -> sqlite_errc;  // null-value
+    [[nodiscard]] SQLITE_WRAPPER_HOT_PATH_API auto try_bind_value(const stmt_with_location& stmt, int index,
+                                                                  std::int64_t value) noexcept -> sqlite_errc;
+    [[nodiscard]] SQLITE_WRAPPER_HOT_PATH_API auto try_bind_value(const stmt_with_location& stmt, int index,
+                                                                  double value) noexcept -> sqlite_errc;
+    [[nodiscard]] SQLITE_WRAPPER_HOT_PATH_API auto try_bind_value(const stmt_with_location& stmt, int index,
+                                                                  std::string_view value) noexcept -> sqlite_errc;
+    [[nodiscard]] SQLITE_WRAPPER_HOT_PATH_API auto try_bind_value(const stmt_with_location& stmt, int index,
+                                                                  const_byte_span value) noexcept -> sqlite_errc;
+
+    [[nodiscard]] auto try_bind_value(const stmt_with_location& stmt, int index, const integral_binding_type auto& param) noexcept
+        -> sqlite_errc
+    {
+      return try_bind_value(stmt, index, static_cast<std::int64_t>(param));
+    }
+
+    [[nodiscard]] auto try_bind_value(const stmt_with_location& stmt, int index,
+                                      const null_binding_type auto& /*unused*/) noexcept -> sqlite_errc
+    {
+      return try_bind_value(stmt, index);
+    }
+
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    [[nodiscard]] auto try_bind_value(const stmt_with_location& stmt, int index, const optional_binding_type auto& param) noexcept
+        -> sqlite_errc
+    {
+      if (param.has_value())
+      {
+        return try_bind_value(stmt, index, param.value());
+      }
+
+      return try_bind_value(stmt, index, std::nullopt);
+    }
+
+    [[nodiscard]] auto try_bind_value_and_increment_index(const stmt_with_location& stmt, int& index,
+                                                          const multi_binding_type auto& param_list) -> sqlite_errc
+    {
+      for (const auto& param : param_list)
+      {
+        if (const auto error{try_bind_value(stmt, index, param)}; error != sqlite_errc::ok)
+        {
+          return error;
+        }
+        index++;
+      }
+
+      return sqlite_errc::ok;
+    }
+
+    [[nodiscard]] auto try_bind_value_and_increment_index(const stmt_with_location& stmt, int& index,
+                                                          const single_binding_type auto& param) -> sqlite_errc
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-array-to-pointer-decay,hicpp-no-array-decay)
+      const auto error{try_bind_value(stmt, index, param)};
+      index++;
+
+      return error;
+    }
+
     [[nodiscard]] SQLITE_WRAPPER_EXPORT auto sqlite_type_to_string(int type) -> std::string;
   }  // namespace details
 
@@ -217,6 +289,22 @@ namespace sqlite_wrapper
     open_only            ///< Only open already existing database file
   };
 
+  namespace details
+  {
+    /**
+     * Opens a database file with sqlite3_open_v2().
+     *
+     * @param file_name name of the database file to open
+     * @param sqlite_flags combination of SQLITE_OPEN_* flags
+     * @param vfs name of the VFS to use, empty for the default VFS
+     * @param loc caller location
+     * @returns a database handle in a RAII guard
+     * @throws sqlite_error in case SQLite returns an error or an invalid handle
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto open(const std::string& file_name, int sqlite_flags, const std::string& vfs,
+                                                  const std::source_location& loc) -> database;
+  }  // namespace details
+
   /**
    * Opens or creates a database file.
    *
@@ -274,6 +362,51 @@ namespace sqlite_wrapper
    */
   [[nodiscard]] SQLITE_WRAPPER_EXPORT auto step(const stmt_with_location& stmt) -> bool;
 
+  /**
+   * Creates a new prepared statement and binds given parameters, without throwing on SQLite errors.
+   *
+   * @param database database handle
+   * @param sql SQL statement to prepare (can contain placeholders)
+   * @param params 0 to n parameters that are bound to the placeholders in \p sql
+   * @returns a prepared statement handle in a RAII guard or the extended result code of the first failed SQLite call
+   */
+  [[nodiscard]] auto try_create_prepared_statement(const db_with_location& database, std::string_view sql,
+                                                   const binding_type auto&... params) -> std::expected<statement, sqlite_errc>
+  {
+    auto stmt{details::try_create_prepared_statement(database, sql)};
+
+    if (!stmt)
+    {
+      return stmt;
+    }
+
+    // "false-positive" triggered by empty parameter pack NOLINTNEXTLINE(misc-const-correctness)
+    [[maybe_unused]] int index{1};
+    sqlite_errc error{sqlite_errc::ok};
+
+    const auto bind{[&](const binding_type auto& param) -> bool
+                    {
+                      error = details::try_bind_value_and_increment_index({stmt->get(), database.location}, index, param);
+                      return error == sqlite_errc::ok;
+                    }};
+
+    // stops at the first failed binding
+    if (!(bind(params) && ...))
+    {
+      return std::unexpected(error);
+    }
+
+    return stmt;
+  }
+
+  /**
+   * Executes a prepared statement or advances to the next result row of one, without throwing on SQLite errors.
+   *
+   * @param stmt handle to the prepared statement
+   * @returns true if there is a result row, false if there is none or the extended result code in case SQLite returns an error
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto try_step(const stmt_with_location& stmt) noexcept -> std::expected<bool, sqlite_errc>;
+
   /**
    * Resets a prepared statement so it can be executed agan with a call to \ref step or \ref get_rows
    *
@@ -340,6 +473,39 @@ namespace sqlite_wrapper
     return get_rows<Row>(stmt, std::numeric_limits<std::size_t>::max());
   }
 
+  namespace details
+  {
+    template <row_type Row>
+    [[nodiscard]] auto try_get_rows(const stmt_with_location& stmt, std::size_t limit, std::size_t expected_minimum)
+        -> std::expected<std::vector<Row>, sqlite_errc>
+    {
+      std::vector<Row> rows;
+      if (const auto new_capacity{std::min(expected_minimum, limit)}; new_capacity > 0)
+      {
+        rows.reserve(new_capacity);
+      }
+
+      while (rows.size() < limit)
+      {
+        const auto has_row{try_step(stmt)};
+
+        if (!has_row)
+        {
+          return std::unexpected(has_row.error());
+        }
+
+        if (!*has_row)
+        {
+          break;
+        }
+
+        rows.emplace_back(get_row<Row>(stmt));
+      }
+
+      return rows;
+    }
+  }  // namespace details
+
   void execute_no_data(const db_with_location& database, std::string_view sql, const binding_type auto&... params)
   {
     const auto stmt{create_prepared_statement(database, sql, params...)};
@@ -356,15 +522,15 @@ namespace sqlite_wrapper
   {
     const auto stmt{create_prepared_statement(database, sql, params...)};
 
-    const auto result{get_rows<Row>({&stmt, database.location}, 1, 1)};
+    auto result{get_rows<Row>({stmt.get(), database.location}, 1, 1)};
 
     if (const auto size{result.size()}; (size != 1) || step({stmt.get(), database.location}))
     {
       throw sqlite_error(sqlite_wrapper::format("expected exactly one row but found {}", (size == 0) ? "none" : "more"),
-                         {&stmt, database.location});
+                         {stmt.get(), database.location});
     }
 
-    return std::move(result[0]);
+    return std::move(result.front());
   }
 
   struct row_limit
@@ -399,6 +565,80 @@ namespace sqlite_wrapper
   {
     return execute<Row>(database, row_limit{}, sql, params...);
   }
+
+  /**
+   * Executes an SQL statement that must not return any data, without throwing on SQLite errors.
+   *
+   * @param database database handle
+   * @param sql SQL statement to execute (can contain placeholders)
+   * @param params 0 to n parameters that are bound to the placeholders in \p sql
+   * @returns nothing on success, the extended result code in case SQLite returns an error or sqlite_errc::row in case the
+   *          statement returned data
+   */
+  [[nodiscard]] auto try_execute_no_data(const db_with_location& database, std::string_view sql,
+                                         const binding_type auto&... params) -> std::expected<void, sqlite_errc>
+  {
+    const auto stmt{try_create_prepared_statement(database, sql, params...)};
+
+    if (!stmt)
+    {
+      return std::unexpected(stmt.error());
+    }
+
+    const auto has_row{try_step({stmt->get(), database.location})};
+
+    if (!has_row)
+    {
+      return std::unexpected(has_row.error());
+    }
+
+    if (*has_row)
+    {
+      return std::unexpected(sqlite_errc::row);
+    }
+
+    return {};
+  }
+
+  /**
+   * Executes an SQL statement and returns the result rows, without throwing on SQLite errors.
+   *
+   * @param database database handle
+   * @param limit maximum number of rows to return and expected minimum used to reserve memory
+   * @param sql SQL statement to execute (can contain placeholders)
+   * @param params 0 to n parameters that are bound to the placeholders in \p sql
+   * @returns the result rows or the extended result code in case SQLite returns an error
+   * @throws sqlite_error only in case a column does not match the type requested in \p Row, which is a usage error
+   */
+  template <row_type Row>
+  [[nodiscard]] auto try_execute(const db_with_location& database, const row_limit& limit, std::string_view sql,
+                                 const binding_type auto&... params) -> std::expected<std::vector<Row>, sqlite_errc>
+  {
+    const auto stmt{try_create_prepared_statement(database, sql, params...)};
+
+    if (!stmt)
+    {
+      return std::unexpected(stmt.error());
+    }
+
+    return details::try_get_rows<Row>({stmt->get(), database.location}, limit.limit, limit.expected_minimum);
+  }
+
+  /**
+   * Executes an SQL statement and returns all result rows, without throwing on SQLite errors.
+   *
+   * @param database database handle
+   * @param sql SQL statement to execute (can contain placeholders)
+   * @param params 0 to n parameters that are bound to the placeholders in \p sql
+   * @returns the result rows or the extended result code in case SQLite returns an error
+   * @throws sqlite_error only in case a column does not match the type requested in \p Row, which is a usage error
+   */
+  template <row_type Row>
+  [[nodiscard]] auto try_execute(const db_with_location& database, std::string_view sql, const binding_type auto&... params)
+      -> std::expected<std::vector<Row>, sqlite_errc>
+  {
+    return try_execute<Row>(database, row_limit{}, sql, params...);
+  }
 }  // namespace sqlite_wrapper
 
 namespace SQLITEWRAPPER_FORMAT_NAMESPACE_NAME
@@ -428,3 +668,7 @@ namespace SQLITEWRAPPER_FORMAT_NAMESPACE_NAME
     }
   };
 }  // namespace SQLITEWRAPPER_FORMAT_NAMESPACE_NAME
+
+#ifdef SQLITE_WRAPPER_INLINE_HOT_PATH
+#  include "sqlite_wrapper/hot_path.h"
+#endif
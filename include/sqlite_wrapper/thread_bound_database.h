@@ -0,0 +1,108 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/raii.h"
+
+#include <atomic>
+#include <source_location>
+#include <string>
+#include <thread>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Returns true if thread_bound_database checks the calling thread on each access, which is the case if NDEBUG is not
+   * defined.
+   */
+  [[nodiscard]] consteval auto are_thread_ownership_checks_enabled() -> bool
+  {
+#ifdef NDEBUG
+    return false;
+#else
+    return true;
+#endif
+  }
+
+  namespace details
+  {
+    [[noreturn]] SQLITE_WRAPPER_EXPORT void throw_not_owner(std::thread::id owner, const std::source_location& loc);
+  }  // namespace details
+
+  /**
+   * Database connection that is owned by exactly one thread at a time.
+   *
+   * Opened with SQLITE_OPEN_NOMUTEX the connection does not lock its mutex on every call into SQLite, instead the
+   * wrapper makes sure only the owning thread uses it: every get() checks the calling thread if
+   * are_thread_ownership_checks_enabled(). Ownership can be handed to another thread with transfer_ownership().
+   */
+  class thread_bound_database
+  {
+   public:
+    /**
+     * Takes ownership of \p database, the calling thread becomes the owner.
+     */
+    SQLITE_WRAPPER_EXPORT explicit thread_bound_database(database&& database) noexcept;
+
+    /**
+     * Returns the database handle.
+     *
+     * @throws sqlite_error with sqlite_errc::misuse if the calling thread is not the owner and
+     *   are_thread_ownership_checks_enabled()
+     */
+    [[nodiscard]] auto get(const std::source_location& loc = std::source_location::current()) const -> ::sqlite3*
+    {
+      if constexpr (are_thread_ownership_checks_enabled())
+      {
+        if (const auto owner{m_owner.load(std::memory_order_acquire)}; owner != std::this_thread::get_id()) [[unlikely]]
+        {
+          details::throw_not_owner(owner, loc);
+        }
+      }
+
+      return m_database.get();
+    }
+
+    /**
+     * Returns the id of the owning thread, a default constructed id if it was transferred to nobody.
+     */
+    [[nodiscard]] auto owner() const noexcept -> std::thread::id
+    {
+      return m_owner.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Hands the connection over to another thread, which may use it after it was handed over, e.g. through a queue.
+     * The connection can be transferred to nobody (std::thread::id{}) and later be taken by any thread.
+     *
+     * @param new_owner id of the new owning thread
+     * @param loc caller location
+     * @throws sqlite_error with sqlite_errc::misuse if the calling thread is neither the owner nor the connection
+     *   unowned
+     */
+    SQLITE_WRAPPER_EXPORT void transfer_ownership(std::thread::id new_owner = std::this_thread::get_id(),
+                                                  const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Releases the connection from the owner check, the calling thread must be the owner.
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto release(const std::source_location& loc = std::source_location::current())
+        -> database;
+
+   private:
+    database m_database;
+    std::atomic<std::thread::id> m_owner;
+  };
+
+  /**
+   * Opens a database with SQLITE_OPEN_NOMUTEX, the calling thread becomes the owner.
+   *
+   * @param file_name name of the database file to open or create incl. an absolute or relative path
+   * @param options settings of the connection, no_mutex is always set
+   * @param loc caller location
+   * @throws sqlite_error in case an option is invalid or SQLite returns an error
+   */
+  [[nodiscard]] SQLITE_WRAPPER_EXPORT auto open_thread_bound(const std::string& file_name, open_options options = {},
+                                                             const std::source_location& loc = std::source_location::current())
+      -> thread_bound_database;
+}  // namespace sqlite_wrapper
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/raii.h"
+
+#include <array>
+#include <cstddef>
+#include <source_location>
+#include <vector>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Locking behavior of BEGIN, see https://www.sqlite.org/lang_transaction.html .
+   */
+  enum class transaction_mode : unsigned
+  {
+    deferred = 0,  ///< locks are acquired by the first read or write
+    immediate,     ///< the write lock is acquired by BEGIN, so later writes can not fail with SQLITE_BUSY
+    exclusive      ///< like immediate, other connections in rollback journal mode can not read either
+  };
+
+  class transaction;
+  class savepoint;
+
+  /**
+   * Prepared BEGIN, COMMIT, ROLLBACK and SAVEPOINT statements of one connection, reused by all transaction and savepoint
+   * guards of the connection so they are only parsed once.
+   *
+   * Must be destroyed before the connection is closed and must only be used by one thread at a time, like the connection.
+   */
+  class transaction_statements
+  {
+   public:
+    /**
+     * Prepares the statements for transactions, statements for savepoints are prepared when first used.
+     *
+     * @param database connection the statements are prepared for
+     * @param loc caller location
+     * @throws sqlite_error in case SQLite returns an error
+     */
+    SQLITE_WRAPPER_EXPORT explicit transaction_statements(::sqlite3* database,
+                                                          const std::source_location& loc = std::source_location::current());
+
+    [[nodiscard]] auto database() const noexcept -> ::sqlite3*
+    {
+      return m_database;
+    }
+
+    /**
+     * Returns the number of active savepoint guards.
+     */
+    [[nodiscard]] auto savepoint_depth() const noexcept -> std::size_t
+    {
+      return m_savepoint_depth;
+    }
+
+   private:
+    friend class transaction;
+    friend class savepoint;
+
+    struct savepoint_statements
+    {
+      statement begin;
+      statement release;
+      statement rollback_to;
+    };
+
+    [[nodiscard]] auto get_savepoint_statements(std::size_t depth, const std::source_location& loc)
+        -> const savepoint_statements&;
+
+    ::sqlite3* m_database;
+    std::array<statement, 3> m_begin;  // one per transaction_mode
+    statement m_commit;
+    statement m_rollback;
+    std::vector<savepoint_statements> m_savepoints;  // one per nesting depth
+    std::size_t m_savepoint_depth{0};
+  };
+
+  /**
+   * RAII-guard for a transaction, it has to be committed explicitly and is rolled back when destroyed otherwise.
+   */
+  class transaction
+  {
+   public:
+    /**
+     * Begins a transaction.
+     *
+     * @param statements prepared statements of the connection, must outlive the guard
+     * @param mode locking behavior
+     * @param loc caller location
+     * @throws sqlite_error in case SQLite returns an error, like SQLITE_BUSY or a transaction is already active
+     */
+    SQLITE_WRAPPER_EXPORT explicit transaction(transaction_statements& statements,
+                                               transaction_mode mode = transaction_mode::deferred,
+                                               const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Rolls back the transaction if it is neither committed nor rolled back, errors are ignored.
+     */
+    SQLITE_WRAPPER_EXPORT ~transaction();
+
+    transaction(const transaction&) = delete;
+    transaction(transaction&&) = delete;
+    auto operator=(const transaction&) -> transaction& = delete;
+    auto operator=(transaction&&) -> transaction& = delete;
+
+    /**
+     * Commits the transaction, it stays active if the commit fails with SQLITE_BUSY and can be committed again.
+     *
+     * @throws sqlite_error in case SQLite returns an error or with sqlite_errc::misuse if the transaction is not active
+     */
+    SQLITE_WRAPPER_EXPORT void commit(const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Rolls back the transaction.
+     *
+     * @throws sqlite_error in case SQLite returns an error or with sqlite_errc::misuse if the transaction is not active
+     */
+    SQLITE_WRAPPER_EXPORT void rollback(const std::source_location& loc = std::source_location::current());
+
+    [[nodiscard]] auto is_active() const noexcept -> bool
+    {
+      return m_active;
+    }
+
+   private:
+    transaction_statements& m_statements;
+    bool m_active{false};
+  };
+
+  /**
+   * RAII-guard for a savepoint, it has to be released explicitly and is rolled back when destroyed otherwise.
+   *
+   * Savepoints can be nested inside a transaction or other savepoints and must be released or rolled back in reverse
+   * order. Outside of a transaction the outermost savepoint starts a deferred transaction.
+   */
+  class savepoint
+  {
+   public:
+    /**
+     * Starts a savepoint.
+     *
+     * @param statements prepared statements of the connection, must outlive the guard
+     * @param loc caller location
+     * @throws sqlite_error in case SQLite returns an error
+     */
+    SQLITE_WRAPPER_EXPORT explicit savepoint(transaction_statements& statements,
+                                             const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Rolls back to and releases the savepoint if it is neither released nor rolled back, errors are ignored.
+     */
+    SQLITE_WRAPPER_EXPORT ~savepoint();
+
+    savepoint(const savepoint&) = delete;
+    savepoint(savepoint&&) = delete;
+    auto operator=(const savepoint&) -> savepoint& = delete;
+    auto operator=(savepoint&&) -> savepoint& = delete;
+
+    /**
+     * Releases the savepoint, its changes become part of the enclosing savepoint or transaction.
+     *
+     * @throws sqlite_error in case SQLite returns an error or with sqlite_errc::misuse if the savepoint is not active or
+     *   not the innermost one
+     */
+    SQLITE_WRAPPER_EXPORT void release(const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Undoes all changes since the savepoint was started and releases it.
+     *
+     * @throws sqlite_error in case SQLite returns an error or with sqlite_errc::misuse if the savepoint is not active or
+     *   not the innermost one
+     */
+    SQLITE_WRAPPER_EXPORT void rollback(const std::source_location& loc = std::source_location::current());
+
+    [[nodiscard]] auto is_active() const noexcept -> bool
+    {
+      return m_active;
+    }
+
+   private:
+    void check_innermost(const std::source_location& loc) const;
+
+    transaction_statements& m_statements;
+    std::size_t m_depth;
+    bool m_active{false};
+  };
+}  // namespace sqlite_wrapper
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/error_code.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/transaction.h"
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <source_location>
+#include <type_traits>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Returns true for SQLITE_BUSY and SQLITE_LOCKED incl. their extended codes like SQLITE_BUSY_SNAPSHOT, which are resolved
+   * by running the whole transaction again.
+   */
+  [[nodiscard]] constexpr auto is_transient_error(sqlite_errc code) noexcept -> bool
+  {
+    const auto primary{primary_code(code)};
+
+    return (primary == sqlite_errc::busy) || (primary == sqlite_errc::locked);
+  }
+
+  /**
+   * Settings of run_in_transaction(), the n-th retry waits min(initial_delay * multiplier^n, max_delay) reduced by a
+   * random fraction of up to jitter.
+   */
+  struct retry_policy
+  {
+    static constexpr std::size_t default_max_attempts{5};
+    static constexpr std::chrono::microseconds default_initial_delay{1000};
+    static constexpr std::chrono::microseconds default_max_delay{100'000};
+    static constexpr double default_multiplier{2.0};
+    static constexpr double default_jitter{0.5};
+
+    std::size_t max_attempts{default_max_attempts};  ///< attempts incl. the first one, must be > 0
+    std::chrono::microseconds initial_delay{default_initial_delay};
+    std::chrono::microseconds max_delay{default_max_delay};
+    double multiplier{default_multiplier};
+    double jitter{default_jitter};
+    transaction_mode mode{transaction_mode::immediate};  ///< immediate avoids SQLITE_BUSY when a read upgrades to a write
+
+    /**
+     * Decides on the extended error code if a failed attempt is retried.
+     */
+    bool (*is_retryable)(sqlite_errc) noexcept {&is_transient_error};
+  };
+
+  /**
+   * Statistics of run_in_transaction(), summed up over all calls that were given the same instance.
+   */
+  struct retry_metrics
+  {
+    std::uint64_t transactions{};  ///< calls of run_in_transaction()
+    std::uint64_t attempts{};      ///< attempts over all calls
+    std::uint64_t retries{};       ///< attempts that failed with a retryable error and were run again
+    std::uint64_t give_ups{};      ///< calls that failed after max_attempts attempts
+
+    std::chrono::nanoseconds wasted_time{};   ///< time spent in attempts that failed with a retryable error
+    std::chrono::nanoseconds backoff_time{};  ///< time spent waiting between attempts
+  };
+
+  namespace details
+  {
+    /**
+     * Returns true if the attempt that failed with \p error is retried and waits before the next attempt.
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto prepare_retry(const sqlite_error& error, std::size_t attempt,
+                                                           std::chrono::steady_clock::time_point attempt_start,
+                                                           const retry_policy& policy, retry_metrics* metrics) -> bool;
+
+    SQLITE_WRAPPER_EXPORT void validate(const retry_policy& policy, const std::source_location& loc);
+  }  // namespace details
+
+  /**
+   * Runs \p function in a transaction and commits it, the whole transaction is run again if it fails with an error
+   * accepted by retry_policy::is_retryable.
+   *
+   * @param statements prepared statements of the connection
+   * @param function function called with the connection, must be safe to call again after its changes were rolled back
+   * @param policy retry settings
+   * @param metrics statistics to add to, nullptr to not record any
+   * @param loc caller location
+   * @returns the result of \p function
+   * @throws sqlite_error in case of a non-retryable error, after max_attempts attempts or with sqlite_errc::misuse if the
+   *   policy is invalid, other exceptions thrown by \p function roll back the transaction and are passed on
+   */
+  template <std::invocable<::sqlite3*> Function>
+  auto run_in_transaction(transaction_statements& statements, Function&& function, const retry_policy& policy = {},
+                          retry_metrics* metrics = nullptr,
+                          const std::source_location& loc = std::source_location::current())
+      -> std::invoke_result_t<Function, ::sqlite3*>
+  {
+    details::validate(policy, loc);
+
+    if (metrics != nullptr)
+    {
+      ++metrics->transactions;
+    }
+
+    for (std::size_t attempt{1};; ++attempt)
+    {
+      const auto attempt_start{std::chrono::steady_clock::now()};
+
+      if (metrics != nullptr)
+      {
+        ++metrics->attempts;
+      }
+
+      try
+      {
+        transaction guard{statements, policy.mode, loc};
+
+        if constexpr (std::is_void_v<std::invoke_result_t<Function, ::sqlite3*>>)
+        {
+          std::invoke(function, statements.database());
+          guard.commit(loc);
+          return;
+        }
+        else
+        {
+          auto result{std::invoke(function, statements.database())};
+          guard.commit(loc);
+          return result;
+        }
+      }
+      catch (const sqlite_error& error)
+      {
+        if (!details::prepare_retry(error, attempt, attempt_start, policy, metrics))
+        {
+          throw;
+        }
+      }
+    }
+  }
+
+  /**
+   * Runs \p function in a transaction on \p database, see above, the transaction statements are prepared for this call.
+   */
+  template <std::invocable<::sqlite3*> Function>
+  auto run_in_transaction(::sqlite3* database, Function&& function, const retry_policy& policy = {},
+                          retry_metrics* metrics = nullptr,
+                          const std::source_location& loc = std::source_location::current())
+      -> std::invoke_result_t<Function, ::sqlite3*>
+  {
+    transaction_statements statements{database, loc};
+
+    return run_in_transaction(statements, std::forward<Function>(function), policy, metrics, loc);
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/raii.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <source_location>
+#include <thread>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Settings of a wal_checkpointer, see https://www.sqlite.org/c3ref/wal_checkpoint_v2.html for the checkpoint modes.
+   */
+  struct wal_checkpointer_options
+  {
+    static constexpr int default_passive_frames{1000};
+    static constexpr int default_restart_frames{10'000};
+    static constexpr int default_truncate_frames{100'000};
+    static constexpr std::chrono::milliseconds default_busy_timeout{5000};
+
+    int passive_frames{default_passive_frames};  ///< WAL frames after a commit that trigger a PASSIVE checkpoint, must be > 0
+
+    /**
+     * Frames a PASSIVE checkpoint could not copy as readers still use them, that escalate to a RESTART checkpoint. It waits
+     * for the readers so the next writer starts at the beginning of the WAL file, writers are blocked meanwhile. 0 never
+     * escalates.
+     */
+    int restart_frames{default_restart_frames};
+
+    /**
+     * Frames a PASSIVE checkpoint could not copy that escalate to a TRUNCATE checkpoint, which is like RESTART and also
+     * truncates the WAL file to zero bytes. 0 never escalates.
+     */
+    int truncate_frames{default_truncate_frames};
+
+    std::chrono::milliseconds busy_timeout{default_busy_timeout};  ///< time RESTART and TRUNCATE wait for readers and writers
+  };
+
+  /**
+   * Statistics of a wal_checkpointer.
+   */
+  struct wal_checkpointer_metrics
+  {
+    std::uint64_t commits{};               ///< commits to the WAL seen by the hook
+    std::uint64_t passive_checkpoints{};   ///< PASSIVE checkpoints run
+    std::uint64_t restart_checkpoints{};   ///< RESTART checkpoints run
+    std::uint64_t truncate_checkpoints{};  ///< TRUNCATE checkpoints run
+    std::uint64_t busy_checkpoints{};      ///< RESTART or TRUNCATE checkpoints that timed out waiting for readers or writers
+    std::uint64_t failed_checkpoints{};    ///< checkpoints that failed with another error
+
+    int wal_frames{};           ///< frames in the WAL after the last commit
+    int max_wal_frames{};       ///< most frames in the WAL after a commit
+    int checkpointed_frames{};  ///< frames of the WAL copied into the database after the last checkpoint
+
+    std::chrono::nanoseconds total_checkpoint_time{};
+    std::chrono::nanoseconds max_checkpoint_time{};
+  };
+
+  /**
+   * Runs checkpoints of a database in WAL mode on a background thread instead of on the committing writer.
+   *
+   * Automatic checkpoints of the connection are replaced by a WAL hook, which wakes the background thread after a commit
+   * that leaves at least passive_frames frames in the WAL. The thread runs a PASSIVE checkpoint on its own connection and
+   * escalates to RESTART or TRUNCATE if long readers keep restart_frames or truncate_frames from being copied. Failed
+   * checkpoints are counted and retried after the next commit. Only the "main" database of the connection is checkpointed.
+   *
+   * Writers should have a busy timeout of at least busy_timeout, as they wait for an escalated checkpoint.
+   *
+   * The checkpointer must be destroyed before the connection is closed, the connection's automatic checkpoints are
+   * restored on destruction.
+   */
+  class wal_checkpointer
+  {
+   public:
+    /**
+     * Opens a connection for checkpoints to the database file of \p database, installs the WAL hook and starts the
+     * background thread.
+     *
+     * @param database connection in WAL mode whose commits trigger checkpoints
+     * @param options settings of the checkpointer
+     * @param loc caller location
+     * @throws sqlite_error with sqlite_errc::misuse if an option is invalid or \p database is not a file database in WAL
+     *   mode, or in case SQLite returns an error
+     */
+    SQLITE_WRAPPER_EXPORT explicit wal_checkpointer(::sqlite3* database, const wal_checkpointer_options& options = {},
+                                                    const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Restores automatic checkpoints of the connection and stops the background thread, a running checkpoint is finished.
+     */
+    SQLITE_WRAPPER_EXPORT ~wal_checkpointer();
+
+    wal_checkpointer(const wal_checkpointer&) = delete;
+    wal_checkpointer(wal_checkpointer&&) = delete;
+    auto operator=(const wal_checkpointer&) -> wal_checkpointer& = delete;
+    auto operator=(wal_checkpointer&&) -> wal_checkpointer& = delete;
+
+    /**
+     * Wakes the background thread to run a checkpoint independent of the frames in the WAL.
+     */
+    SQLITE_WRAPPER_EXPORT void request_checkpoint() noexcept;
+
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_metrics() const -> wal_checkpointer_metrics;
+
+   private:
+    static auto on_commit(void* context, ::sqlite3* database, const char* schema, int frames) noexcept -> int;
+
+    /**
+     * Runs a checkpoint and records it in the metrics.
+     *
+     * @returns frames the checkpoint could not copy into the database
+     */
+    auto checkpoint(int mode) noexcept -> int;
+
+    void run() noexcept;
+
+    ::sqlite3* m_database;
+    wal_checkpointer_options m_options;
+    int m_previous_autocheckpoint;
+    sqlite_wrapper::database m_connection;
+
+    std::atomic<std::uint64_t> m_commits{0};
+    std::atomic<int> m_wal_frames{0};
+    std::atomic<int> m_max_wal_frames{0};
+    std::atomic<bool> m_requested{false};
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping{false};
+    wal_checkpointer_metrics m_metrics;
+
+    std::thread m_thread;
+  };
+}  // namespace sqlite_wrapper
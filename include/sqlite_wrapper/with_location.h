@@ -1,11 +1,44 @@
 #pragma once
 
+#include "sqlite_wrapper/config.h"
+
 #include <source_location>
 #include <type_traits>
 #include <utility>
 
 namespace sqlite_wrapper
 {
+  /**
+   * Empty stand-in for std::source_location, converts to a default constructed std::source_location.
+   * Used by with_location if SQLITE_WRAPPER_STRIP_LOCATION is defined.
+   */
+  struct no_location
+  {
+    constexpr no_location() noexcept = default;
+
+    // NOLINTNEXTLINE(hicpp-explicit-conversions)
+    constexpr no_location(const std::source_location& /*unused*/) noexcept {}
+
+    // NOLINTNEXTLINE(hicpp-explicit-conversions)
+    constexpr operator std::source_location() const noexcept
+    {
+      return {};
+    }
+  };
+
+  /**
+   * Returns true if with_location records the callers std::source_location, false if SQLITE_WRAPPER_STRIP_LOCATION is
+   * defined.
+   */
+  [[nodiscard]] consteval auto are_locations_recorded() -> bool
+  {
+#ifdef SQLITE_WRAPPER_STRIP_LOCATION
+    return false;
+#else
+    return true;
+#endif
+  }
+
   /**
    * Wrapper that adds a std::source_location to any type.
    * Useful in cases where one can not have a defaulted std::source_location as the last parameter due to perfect forwarding.
@@ -15,24 +48,27 @@ namespace sqlite_wrapper
    * auto create_prepared_statement(const db_with_location& database, std::string_view sql, const binding_type auto&... params) -> statement
    * @endcode
    *
+   * If SQLITE_WRAPPER_STRIP_LOCATION is defined no location is recorded and with_location has the size of the wrapped type.
+   *
    * @tparam T the type to be wrapped
    */
   template <typename T>
   struct with_location
   {
     using value_type = std::remove_reference_t<T>;
+    using location_type = std::conditional_t<are_locations_recorded(), std::source_location, no_location>;
 
     // NOLINTNEXTLINE(hicpp-explicit-conversions)
-    with_location(const value_type& value, const std::source_location& loc = std::source_location::current())
+    with_location(const value_type& value, const location_type& loc = std::source_location::current())
       : value(value), location(loc)
     {}
 
     // NOLINTNEXTLINE(hicpp-explicit-conversions)
-    with_location(value_type&& value, const std::source_location& loc = std::source_location::current())
+    with_location(value_type&& value, const location_type& loc = std::source_location::current())
       : value(std::move(value)), location(loc)
     {}
 
     value_type value;
-    std::source_location location;
+    SQLITE_WRAPPER_NO_UNIQUE_ADDRESS location_type location;
   };
 }  // namespace sqlite_wrapper
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+#include "sqlite_wrapper/transaction.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <source_location>
+#include <string_view>
+#include <thread>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Settings of a write_batcher.
+   */
+  struct write_batcher_options
+  {
+    static constexpr std::size_t default_max_statements{1000};
+    static constexpr std::chrono::milliseconds default_max_delay{100};
+
+    std::size_t max_statements{default_max_statements};  ///< statements after which the batch is committed, must be > 0
+
+    /**
+     * Time after the first statement of a batch until it is committed by a background thread, 0 commits only after
+     * max_statements or on flush().
+     */
+    std::chrono::milliseconds max_delay{default_max_delay};
+
+    transaction_mode mode{transaction_mode::immediate};  ///< mode of the implicit transactions
+  };
+
+  /**
+   * Statistics of a write_batcher.
+   */
+  struct write_batcher_metrics
+  {
+    std::uint64_t statements{};      ///< statements executed in implicit transactions
+    std::uint64_t commits{};         ///< implicit transactions committed
+    std::uint64_t failed_commits{};  ///< commits that failed, the batch stays open and is committed again later
+  };
+
+  /**
+   * Groups single writes on a connection into implicit transactions, so they do not pay for a sync each.
+   *
+   * Statements executed with execute_no_data() outside of an explicit transaction join an implicit transaction, which is
+   * committed after max_statements statements, max_delay after its first statement or by flush(). At most max_statements
+   * statements or max_delay worth of writes are lost in a crash. Statements inside an explicit transaction are executed
+   * as part of it, flush() has to be called before starting one.
+   *
+   * Any thread may use the write_batcher. If max_delay is not 0 a background thread commits on the same connection, so it
+   * must not be opened with SQLITE_OPEN_NOMUTEX. The batcher must be destroyed before the connection is closed.
+   */
+  class write_batcher
+  {
+   public:
+    /**
+     * @param database connection to batch writes on
+     * @param options settings of the batcher
+     * @param loc caller location
+     * @throws sqlite_error with sqlite_errc::misuse if an option is invalid or the connection has no mutex but a
+     *   background thread is needed, or in case SQLite returns an error
+     */
+    SQLITE_WRAPPER_EXPORT explicit write_batcher(::sqlite3* database, const write_batcher_options& options = {},
+                                                 const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Commits the open batch, errors are ignored, and stops the background thread.
+     */
+    SQLITE_WRAPPER_EXPORT ~write_batcher();
+
+    write_batcher(const write_batcher&) = delete;
+    write_batcher(write_batcher&&) = delete;
+    auto operator=(const write_batcher&) -> write_batcher& = delete;
+    auto operator=(write_batcher&&) -> write_batcher& = delete;
+
+    /**
+     * Executes a SQL statement that returns no data as part of the open batch, begins a new batch if there is none and
+     * commits it if it is full.
+     *
+     * @param sql SQL statement to execute (can contain placeholders)
+     * @param params 0 to n parameters that are bound to the placeholders in \p sql
+     * @throws sqlite_error in case SQLite returns an error or a commit by the background thread failed since the last call
+     */
+    void execute_no_data(std::string_view sql, const binding_type auto&... params)
+    {
+      const std::lock_guard lock{m_mutex};
+
+      const auto batched{begin_statement()};
+
+      try
+      {
+        sqlite_wrapper::execute_no_data(m_database, sql, params...);
+      }
+      catch (...)
+      {
+        statement_failed();
+        throw;
+      }
+
+      if (batched)
+      {
+        end_statement();
+      }
+    }
+
+    /**
+     * Commits the open batch, if any.
+     *
+     * @throws sqlite_error in case SQLite returns an error or a commit by the background thread failed since the last call
+     */
+    SQLITE_WRAPPER_EXPORT void flush(const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Returns the number of statements in the open batch.
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto pending_statements() const -> std::size_t;
+
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_metrics() const -> write_batcher_metrics;
+
+   private:
+    /**
+     * Rethrows a failed background commit and begins a batch if there is none and no explicit transaction.
+     *
+     * @returns true if the statement is part of a batch
+     */
+    SQLITE_WRAPPER_EXPORT auto begin_statement() -> bool;
+
+    SQLITE_WRAPPER_EXPORT void end_statement();
+
+    SQLITE_WRAPPER_EXPORT void statement_failed() noexcept;
+
+    void commit(const std::source_location& loc);
+
+    void run() noexcept;
+
+    ::sqlite3* m_database;
+    write_batcher_options m_options;
+    transaction_statements m_statements;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_batch_started;
+    std::optional<transaction> m_batch;
+    std::chrono::steady_clock::time_point m_deadline;
+    std::size_t m_pending{0};
+    std::exception_ptr m_background_error;
+    bool m_stopping{false};
+    write_batcher_metrics m_metrics;
+
+    std::thread m_committer;
+  };
+}  // namespace sqlite_wrapper
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "sqlite_wrapper/config.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Settings of a write_queue.
+   */
+  struct write_queue_options
+  {
+    static constexpr std::size_t default_max_batch_size{256};
+
+    std::size_t max_batch_size{default_max_batch_size};  ///< maximum number of writes committed together, must be > 0
+
+    /**
+     * Time an open transaction waits for further writes before it is committed, 0 commits as soon as the queue is empty.
+     */
+    std::chrono::microseconds max_batch_delay{};
+
+    open_options connection_options{open_options::durable_oltp()};  ///< options of the writer, no_mutex is always set
+  };
+
+  /**
+   * Statistics of a write_queue.
+   */
+  struct write_queue_metrics
+  {
+    std::uint64_t submitted{};     ///< writes submitted
+    std::uint64_t succeeded{};     ///< writes committed
+    std::uint64_t failed{};        ///< writes that threw or whose transaction failed to commit
+    std::uint64_t transactions{};  ///< transactions committed or rolled back
+    std::size_t largest_batch{};   ///< largest number of writes in one transaction
+
+    /**
+     * Returns the average number of writes per transaction.
+     */
+    [[nodiscard]] auto average_batch_size() const noexcept -> double
+    {
+      return (transactions > 0) ? (static_cast<double>(succeeded + failed) / static_cast<double>(transactions)) : 0.0;
+    }
+  };
+
+  /**
+   * Serializes the writes of many threads through a single writer connection with group commit.
+   *
+   * Producers submit writes from any thread without taking a lock. A dedicated thread executes them in submission order and
+   * commits up to max_batch_size writes in one transaction, so concurrent producers share the cost of a commit instead of
+   * fighting for the database write lock. Every write runs in its own savepoint, a failed write is rolled back on its own
+   * and does not affect the other writes of its transaction. The future of a write becomes ready once its transaction is
+   * committed, or with the exception of the write or the failed commit.
+   */
+  class write_queue
+  {
+   public:
+    /**
+     * A write executed on the writer connection, must not begin or end a transaction.
+     */
+    using write_function = std::move_only_function<void(::sqlite3*)>;
+
+    /**
+     * Opens or creates the database file and starts the writer thread.
+     *
+     * @param file_name name of the database file to open or create incl. an absolute or relative path
+     * @param options settings of the queue
+     * @param loc caller location
+     * @throws sqlite_error in case an option is invalid or SQLite returns an error
+     */
+    SQLITE_WRAPPER_EXPORT explicit write_queue(const std::string& file_name, const write_queue_options& options = {},
+                                               const std::source_location& loc = std::source_location::current());
+
+    /**
+     * Executes all writes submitted so far and stops the writer thread, no writes must be submitted anymore.
+     */
+    SQLITE_WRAPPER_EXPORT ~write_queue();
+
+    write_queue(const write_queue&) = delete;
+    write_queue(write_queue&&) = delete;
+    auto operator=(const write_queue&) -> write_queue& = delete;
+    auto operator=(write_queue&&) -> write_queue& = delete;
+
+    /**
+     * Queues a write, can be called from any thread.
+     *
+     * @param write function executed on the writer connection
+     * @returns future that becomes ready when the write is committed, or holds the exception thrown by \p write or the
+     *   sqlite_error of the failed commit
+     */
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto submit(write_function write) -> std::future<void>;
+
+    /**
+     * Queues a SQL statement that returns no data, can be called from any thread.
+     *
+     * @param sql SQL statement to execute (can contain placeholders)
+     * @param params 0 to n parameters that are bound to the placeholders in \p sql, they are copied, so data referred to by
+     *   views or pointers must stay valid until the returned future is ready
+     * @returns future that becomes ready when the statement is committed, or holds the sqlite_error of the statement or the
+     *   failed commit
+     */
+    template <binding_type... Params>
+    [[nodiscard]] auto submit(std::string sql, const Params&... params) -> std::future<void>
+    {
+      return submit(write_function{[sql = std::move(sql), params = std::tuple<std::decay_t<const Params&>...>{params...}](
+                                       ::sqlite3* database)
+                                   {
+                                     std::apply([&](const auto&... values) { execute_no_data(database, sql, values...); },
+                                                params);
+                                   }});
+    }
+
+    [[nodiscard]] SQLITE_WRAPPER_EXPORT auto get_metrics() const noexcept -> write_queue_metrics;
+
+    [[nodiscard]] auto file_name() const noexcept -> const std::string&
+    {
+      return m_file_name;
+    }
+
+   private:
+    struct node;
+
+    class pending_writes;
+
+    void run() noexcept;
+
+    void run_batch(pending_writes& pending);
+
+    void take_submitted(pending_writes& pending) noexcept;
+
+    auto wait_for_writes(std::chrono::steady_clock::time_point deadline) -> bool;
+
+    std::string m_file_name;
+    write_queue_options m_options;
+
+    database m_database;
+    statement m_begin;
+    statement m_commit;
+    statement m_rollback;
+    statement m_savepoint;
+    statement m_release;
+    statement m_rollback_to;
+
+    // lock-free stack of submitted writes in reverse order, the writer takes all of them at once
+    std::atomic<node*> m_submitted{nullptr};
+
+    // the mutex is only taken to put the writer to sleep and to wake it up
+    std::mutex m_mutex;
+    std::condition_variable m_writes_available;
+    std::atomic<bool> m_writer_waiting{false};
+    std::atomic<bool> m_stopping{false};
+
+    std::atomic<std::uint64_t> m_submitted_count{};
+    std::atomic<std::uint64_t> m_succeeded{};
+    std::atomic<std::uint64_t> m_failed{};
+    std::atomic<std::uint64_t> m_transactions{};
+    std::atomic<std::size_t> m_largest_batch{};
+
+    std::thread m_writer;
+  };
+}  // namespace sqlite_wrapper
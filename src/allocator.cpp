@@ -0,0 +1,559 @@
+#include "sqlite_wrapper/allocator.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <mutex>
+#include <source_location>
+#include <vector>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    /**
+     * Precedes each block, the payload keeps the 16 byte alignment of std::malloc().
+     */
+    struct alignas(16) block_header
+    {
+      std::size_t size;    ///< usable bytes of the payload
+      block_header* next;  ///< next free block of the size class while the block is cached
+    };
+
+    constexpr std::size_t header_size{sizeof(block_header)};
+    constexpr std::size_t max_class_size{16 * 1024};
+    constexpr std::size_t max_cached_bytes{256 * 1024};  ///< per size class and thread
+    constexpr std::size_t size_alignment{8};
+
+    // classes of 16 to 64 bytes in steps of 16, then four classes per power of two: 80, 96, 112, 128, 160, 192, ...
+    constexpr std::size_t small_classes{4};
+    constexpr std::size_t small_class_step{16};
+    constexpr std::size_t small_class_shift{4};
+    constexpr std::size_t classes_per_power{4};
+
+    [[nodiscard]] constexpr auto class_index(std::size_t size) noexcept -> std::size_t
+    {
+      if (size <= small_classes * small_class_step)
+      {
+        return (size == 0) ? 0 : ((size - 1) / small_class_step);
+      }
+
+      // the two bits below the highest bit of size - 1 select the class within its power of two
+      const auto shift{static_cast<std::size_t>(std::bit_width(size - 1)) - 3};
+
+      return small_classes + ((shift - small_class_shift) * classes_per_power) + ((size - 1) >> shift) - classes_per_power;
+    }
+
+    [[nodiscard]] constexpr auto class_size(std::size_t index) noexcept -> std::size_t
+    {
+      if (index < small_classes)
+      {
+        return (index + 1) * small_class_step;
+      }
+
+      const auto shift{((index - small_classes) / classes_per_power) + small_class_shift};
+
+      return (classes_per_power + ((index - small_classes) % classes_per_power) + 1) << shift;
+    }
+
+    constexpr std::size_t class_count{class_index(max_class_size) + 1};
+
+    static_assert(class_size(class_index(max_class_size)) == max_class_size);
+    static_assert(class_size(class_index(65)) == 80);    // NOLINT(readability-magic-numbers)
+    static_assert(class_size(class_index(129)) == 160);  // NOLINT(readability-magic-numbers)
+
+    /**
+     * Returns the usable size of a block for \p size requested bytes.
+     */
+    [[nodiscard]] constexpr auto usable_size(std::size_t size) noexcept -> std::size_t
+    {
+      return (size <= max_class_size) ? class_size(class_index(size))
+                                      : ((size + size_alignment - 1) & ~(size_alignment - 1));
+    }
+
+    struct counters
+    {
+      std::atomic<std::uint64_t> allocations{0};
+      std::atomic<std::uint64_t> frees{0};
+      std::atomic<std::uint64_t> reallocations{0};
+      std::atomic<std::uint64_t> cached_allocations{0};
+      std::atomic<std::uint64_t> failed_allocations{0};
+      std::atomic<std::int64_t> bytes_in_use{0};
+
+      void add_to(allocator_metrics& metrics) const noexcept
+      {
+        metrics.allocations += allocations.load(std::memory_order_relaxed);
+        metrics.frees += frees.load(std::memory_order_relaxed);
+        metrics.reallocations += reallocations.load(std::memory_order_relaxed);
+        metrics.cached_allocations += cached_allocations.load(std::memory_order_relaxed);
+        metrics.failed_allocations += failed_allocations.load(std::memory_order_relaxed);
+        metrics.bytes_in_use += bytes_in_use.load(std::memory_order_relaxed);
+      }
+
+      void move_to(counters& other) noexcept
+      {
+        other.allocations.fetch_add(allocations.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        other.frees.fetch_add(frees.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        other.reallocations.fetch_add(reallocations.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        other.cached_allocations.fetch_add(cached_allocations.exchange(0, std::memory_order_relaxed),
+                                           std::memory_order_relaxed);
+        other.failed_allocations.fetch_add(failed_allocations.exchange(0, std::memory_order_relaxed),
+                                           std::memory_order_relaxed);
+        other.bytes_in_use.fetch_add(bytes_in_use.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+    };
+
+    /**
+     * Free blocks and counters of a thread, trivially destructible so it can still be used while threads or the process
+     * exit.
+     */
+    struct thread_cache
+    {
+      std::array<block_header*, class_count> free_blocks{};
+      std::array<std::size_t, class_count> free_block_count{};
+      sqlite_wrapper::counters counters;
+
+      void release() noexcept
+      {
+        for (std::size_t index{0}; index < class_count; ++index)
+        {
+          while (auto* const block{free_blocks.at(index)})
+          {
+            free_blocks.at(index) = block->next;
+            std::free(block);  // NOLINT(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
+          }
+
+          free_block_count.at(index) = 0;
+        }
+      }
+    };
+
+    /**
+     * All thread caches, never destroyed as SQLite may free memory during the destruction of static objects.
+     */
+    struct cache_registry
+    {
+      std::mutex mutex;
+      std::vector<thread_cache*> caches;
+      sqlite_wrapper::counters exited_threads;  ///< also counts threads whose cache is gone or could not be registered
+    };
+
+    [[nodiscard]] auto get_registry() -> cache_registry&
+    {
+      static auto* const registry{new cache_registry};  // NOLINT(cppcoreguidelines-owning-memory)
+      return *registry;
+    }
+
+    enum class cache_state : unsigned char
+    {
+      unregistered,
+      registered,
+      closed
+    };
+
+    thread_local constinit thread_cache local_cache{};
+    thread_local constinit cache_state local_cache_state{cache_state::unregistered};
+
+    /**
+     * Registers the cache of the thread and releases it when the thread exits.
+     */
+    struct cache_owner
+    {
+      cache_owner()
+      {
+        auto& registry{get_registry()};
+        const std::lock_guard lock{registry.mutex};
+
+        registry.caches.push_back(&local_cache);
+        local_cache_state = cache_state::registered;
+      }
+
+      ~cache_owner()
+      {
+        local_cache.release();
+
+        auto& registry{get_registry()};
+        const std::lock_guard lock{registry.mutex};
+
+        local_cache.counters.move_to(registry.exited_threads);
+        std::erase(registry.caches, &local_cache);
+        local_cache_state = cache_state::closed;
+      }
+
+      cache_owner(const cache_owner&) = delete;
+      cache_owner(cache_owner&&) = delete;
+      auto operator=(const cache_owner&) -> cache_owner& = delete;
+      auto operator=(cache_owner&&) -> cache_owner& = delete;
+    };
+
+    /**
+     * Returns the cache of the thread or nullptr if it has none.
+     */
+    [[nodiscard]] auto get_cache() noexcept -> thread_cache*
+    {
+      if (local_cache_state == cache_state::unregistered) [[unlikely]]
+      {
+        try
+        {
+          thread_local const cache_owner owner;
+        }
+        catch (...)
+        {
+          return nullptr;
+        }
+      }
+
+      return (local_cache_state == cache_state::registered) ? &local_cache : nullptr;
+    }
+
+    [[nodiscard]] auto get_counters(thread_cache* cache) noexcept -> sqlite_wrapper::counters&
+    {
+      return (cache != nullptr) ? cache->counters : get_registry().exited_threads;
+    }
+
+    [[nodiscard]] auto to_header(void* pointer) noexcept -> block_header*
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      return reinterpret_cast<block_header*>(static_cast<std::byte*>(pointer) - header_size);
+    }
+
+    [[nodiscard]] auto to_payload(block_header* header) noexcept -> void*
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      return reinterpret_cast<std::byte*>(header) + header_size;
+    }
+
+    [[nodiscard]] auto to_size(int size) noexcept -> std::size_t
+    {
+      return static_cast<std::size_t>(std::max(size, 1));
+    }
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // allocator_kind::thread_caches
+
+    [[nodiscard]] auto allocate_block(thread_cache* cache, std::size_t size) noexcept -> block_header*
+    {
+      const auto usable{usable_size(size)};
+
+      if ((cache != nullptr) && (usable <= max_class_size))
+      {
+        const auto index{class_index(usable)};
+
+        if (auto* const block{cache->free_blocks.at(index)}; block != nullptr)
+        {
+          cache->free_blocks.at(index) = block->next;
+          --cache->free_block_count.at(index);
+          cache->counters.cached_allocations.fetch_add(1, std::memory_order_relaxed);
+
+          return block;
+        }
+      }
+
+      // NOLINTNEXTLINE(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
+      auto* const block{static_cast<block_header*>(std::malloc(header_size + usable))};
+
+      if (block != nullptr)
+      {
+        block->size = usable;
+      }
+
+      return block;
+    }
+
+    void free_block(thread_cache* cache, block_header* block) noexcept
+    {
+      const auto size{block->size};
+
+      if ((cache != nullptr) && (size <= max_class_size))
+      {
+        const auto index{class_index(size)};
+
+        if ((cache->free_block_count.at(index) + 1) * size <= max_cached_bytes)
+        {
+          block->next = cache->free_blocks.at(index);
+          cache->free_blocks.at(index) = block;
+          ++cache->free_block_count.at(index);
+
+          return;
+        }
+      }
+
+      std::free(block);  // NOLINT(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
+    }
+
+    auto cache_malloc(int size) noexcept -> void*
+    {
+      auto* const cache{get_cache()};
+      auto& counters{get_counters(cache)};
+      auto* const block{allocate_block(cache, to_size(size))};
+
+      if (block == nullptr)
+      {
+        counters.failed_allocations.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+      }
+
+      counters.allocations.fetch_add(1, std::memory_order_relaxed);
+      counters.bytes_in_use.fetch_add(static_cast<std::int64_t>(block->size), std::memory_order_relaxed);
+
+      return to_payload(block);
+    }
+
+    void cache_free(void* pointer) noexcept
+    {
+      if (pointer == nullptr)
+      {
+        return;
+      }
+
+      auto* const cache{get_cache()};
+      auto& counters{get_counters(cache)};
+      auto* const block{to_header(pointer)};
+
+      counters.frees.fetch_add(1, std::memory_order_relaxed);
+      counters.bytes_in_use.fetch_sub(static_cast<std::int64_t>(block->size), std::memory_order_relaxed);
+
+      free_block(cache, block);
+    }
+
+    auto cache_realloc(void* pointer, int size) noexcept -> void*
+    {
+      auto* const cache{get_cache()};
+      auto& counters{get_counters(cache)};
+      auto* const block{to_header(pointer)};
+      const auto new_size{to_size(size)};
+
+      counters.reallocations.fetch_add(1, std::memory_order_relaxed);
+
+      if (usable_size(new_size) == block->size)
+      {
+        return pointer;
+      }
+
+      auto* const new_block{allocate_block(cache, new_size)};
+
+      if (new_block == nullptr)
+      {
+        counters.failed_allocations.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+      }
+
+      std::memcpy(to_payload(new_block), pointer, std::min(block->size, new_block->size));
+
+      counters.bytes_in_use.fetch_add(static_cast<std::int64_t>(new_block->size) - static_cast<std::int64_t>(block->size),
+                                      std::memory_order_relaxed);
+
+      free_block(cache, block);
+
+      return to_payload(new_block);
+    }
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // allocator_kind::memory_resource
+
+    std::pmr::memory_resource* configured_resource{};  // set before SQLite is initialized
+
+    [[nodiscard]] auto allocate_from_resource(std::size_t size) noexcept -> block_header*
+    {
+      const auto usable{(size + size_alignment - 1) & ~(size_alignment - 1)};
+
+      try
+      {
+        auto* const block{static_cast<block_header*>(configured_resource->allocate(header_size + usable, alignof(block_header)))};
+        block->size = usable;
+
+        return block;
+      }
+      catch (...)
+      {
+        return nullptr;
+      }
+    }
+
+    void free_to_resource(block_header* block) noexcept
+    {
+      configured_resource->deallocate(block, header_size + block->size, alignof(block_header));
+    }
+
+    auto resource_malloc(int size) noexcept -> void*
+    {
+      auto& counters{get_counters(get_cache())};
+      auto* const block{allocate_from_resource(to_size(size))};
+
+      if (block == nullptr)
+      {
+        counters.failed_allocations.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+      }
+
+      counters.allocations.fetch_add(1, std::memory_order_relaxed);
+      counters.bytes_in_use.fetch_add(static_cast<std::int64_t>(block->size), std::memory_order_relaxed);
+
+      return to_payload(block);
+    }
+
+    void resource_free(void* pointer) noexcept
+    {
+      if (pointer == nullptr)
+      {
+        return;
+      }
+
+      auto& counters{get_counters(get_cache())};
+      auto* const block{to_header(pointer)};
+
+      counters.frees.fetch_add(1, std::memory_order_relaxed);
+      counters.bytes_in_use.fetch_sub(static_cast<std::int64_t>(block->size), std::memory_order_relaxed);
+
+      free_to_resource(block);
+    }
+
+    auto resource_realloc(void* pointer, int size) noexcept -> void*
+    {
+      auto& counters{get_counters(get_cache())};
+      auto* const block{to_header(pointer)};
+      const auto new_size{to_size(size)};
+
+      counters.reallocations.fetch_add(1, std::memory_order_relaxed);
+
+      if ((new_size <= block->size) && (new_size > block->size / 2))
+      {
+        return pointer;
+      }
+
+      auto* const new_block{allocate_from_resource(new_size)};
+
+      if (new_block == nullptr)
+      {
+        counters.failed_allocations.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+      }
+
+      std::memcpy(to_payload(new_block), pointer, std::min(block->size, new_block->size));
+
+      counters.bytes_in_use.fetch_add(static_cast<std::int64_t>(new_block->size) - static_cast<std::int64_t>(block->size),
+                                      std::memory_order_relaxed);
+
+      free_to_resource(block);
+
+      return to_payload(new_block);
+    }
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // sqlite3_mem_methods shared by both allocators
+
+    auto block_size(void* pointer) noexcept -> int
+    {
+      return (pointer != nullptr) ? static_cast<int>(to_header(pointer)->size) : 0;
+    }
+
+    auto cache_roundup(int size) noexcept -> int
+    {
+      return static_cast<int>(usable_size(to_size(size)));
+    }
+
+    auto resource_roundup(int size) noexcept -> int
+    {
+      return static_cast<int>((to_size(size) + size_alignment - 1) & ~(size_alignment - 1));
+    }
+
+    auto initialize(void* /*data*/) noexcept -> int
+    {
+      return SQLITE_OK;
+    }
+
+    void shutdown(void* /*data*/) noexcept
+    {
+    }
+
+    const ::sqlite3_mem_methods cache_methods{&cache_malloc,   &cache_free, &cache_realloc, &block_size,
+                                              &cache_roundup, &initialize, &shutdown,      nullptr};
+
+    const ::sqlite3_mem_methods resource_methods{&resource_malloc,   &resource_free, &resource_realloc, &block_size,
+                                                 &resource_roundup, &initialize,    &shutdown,         nullptr};
+  }  // unnamed namespace
+
+  void configure_allocator(const allocator_options& options, const std::source_location& loc)
+  {
+    if (to_underlying(options.kind) > to_underlying(allocator_kind::memory_resource))
+    {
+      throw sqlite_error(
+          sqlite_wrapper::format("invalid allocator_options, unknown allocator kind {}", to_underlying(options.kind)),
+          SQLITE_MISUSE, loc);
+    }
+
+    if ((options.kind == allocator_kind::memory_resource) && (options.resource == nullptr))
+    {
+      throw sqlite_error("invalid allocator_options, allocator_kind::memory_resource needs a resource", SQLITE_MISUSE, loc);
+    }
+
+    static std::mutex mutex;
+    static ::sqlite3_mem_methods sqlite_methods{};
+    static bool sqlite_methods_saved{false};
+
+    const std::lock_guard lock{mutex};
+
+    // fails once SQLite is initialized, so nothing is changed while blocks of the current allocator are in use
+    ::sqlite3_mem_methods current_methods{};
+
+    if (const auto result{::sqlite3_config(SQLITE_CONFIG_GETMALLOC, &current_methods)}; result != SQLITE_OK)
+    {
+      throw sqlite_error("configure_allocator() must be called before SQLite is initialized", result, loc);
+    }
+
+    if (!sqlite_methods_saved)
+    {
+      sqlite_methods = current_methods;
+      sqlite_methods_saved = true;
+    }
+
+    const ::sqlite3_mem_methods* methods{&sqlite_methods};
+
+    switch (options.kind)
+    {
+      case allocator_kind::thread_caches:
+        methods = &cache_methods;
+        break;
+      case allocator_kind::memory_resource:
+        configured_resource = options.resource;
+        methods = &resource_methods;
+        break;
+      default:
+        break;
+    }
+
+    if (const auto result{::sqlite3_config(SQLITE_CONFIG_MALLOC, methods)}; result != SQLITE_OK)
+    {
+      throw sqlite_error("sqlite3_config() failed to configure the allocator", result, loc);
+    }
+  }
+
+  auto get_allocator_metrics() -> allocator_metrics
+  {
+    allocator_metrics metrics;
+
+    auto& registry{get_registry()};
+    const std::lock_guard lock{registry.mutex};
+
+    registry.exited_threads.add_to(metrics);
+
+    for (const auto* const cache : registry.caches)
+    {
+      cache->counters.add_to(metrics);
+    }
+
+    return metrics;
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,122 @@
+#include "sqlite_wrapper/async_executor.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_error.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace sqlite_wrapper
+{
+  async_executor::async_executor(const std::string& file_name, const async_executor_options& options,
+                                 const std::source_location& loc)
+  {
+    if (options.thread_count == 0)
+    {
+      throw sqlite_error(
+          sqlite_wrapper::format("invalid async_executor_options for database \"{}\", thread_count must be > 0", file_name),
+          SQLITE_MISUSE, loc);
+    }
+
+    auto connection_options{options.connection_options};
+    connection_options.no_mutex = true;
+
+    m_connections.reserve(options.thread_count);
+
+    for (std::size_t i{0}; i < options.thread_count; ++i)
+    {
+      m_connections.push_back(open(file_name, connection_options, loc));
+    }
+
+    m_workers.reserve(options.thread_count);
+
+    try
+    {
+      for (const auto& connection : m_connections)
+      {
+        m_workers.emplace_back([this, database = connection.get()] { run(database); });
+      }
+    }
+    catch (...)
+    {
+      {
+        const std::lock_guard lock{m_mutex};
+        m_stopping = true;
+      }
+
+      m_task_available.notify_all();
+
+      for (auto& worker : m_workers)
+      {
+        worker.join();
+      }
+
+      throw;
+    }
+  }
+
+  async_executor::~async_executor()
+  {
+    {
+      const std::lock_guard lock{m_mutex};
+      m_stopping = true;
+    }
+
+    m_task_available.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+      worker.join();
+    }
+  }
+
+  void async_executor::enqueue(task new_task, task_priority priority)
+  {
+    {
+      const std::lock_guard lock{m_mutex};
+      m_tasks.at(to_underlying(priority)).push_back(std::move(new_task));
+    }
+
+    m_task_available.notify_one();
+  }
+
+  void async_executor::run(::sqlite3* database) noexcept
+  {
+    while (true)
+    {
+      task next_task;
+
+      {
+        std::unique_lock lock{m_mutex};
+
+        const auto queue{[this]
+                         { return std::ranges::find_if(m_tasks, [](const auto& tasks) { return !tasks.empty(); }); }};
+
+        m_task_available.wait(lock, [&] { return m_stopping || (queue() != m_tasks.end()); });
+
+        // queued tasks are still executed when stopping
+        const auto tasks{queue()};
+
+        if (tasks == m_tasks.end())
+        {
+          return;
+        }
+
+        next_task = std::move(tasks->front());
+        tasks->pop_front();
+      }
+
+      // packaged tasks store exceptions in their future
+      next_task(database);
+    }
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,183 @@
+#include "sqlite_wrapper/backup.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_error.h"
+
+#include <sqlite3.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <source_location>
+#include <stop_token>
+#include <utility>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    // pause before the next step if the source or destination was locked and no sleep_between_steps is set
+    constexpr std::chrono::milliseconds locked_retry_delay{1};
+
+    [[nodiscard]] auto validate(backup_options options, const std::source_location& loc) -> backup_options
+    {
+      // sqlite3_backup_step() copies no pages and never finishes with 0
+      if (options.pages_per_step == 0)
+      {
+        throw sqlite_error("invalid backup_options, pages_per_step must not be 0", SQLITE_MISUSE, loc);
+      }
+
+      return options;
+    }
+
+    /**
+     * Waits for \p delay, returns false if stop is requested before.
+     */
+    [[nodiscard]] auto wait(const std::stop_token& stop_token, std::chrono::milliseconds delay) -> bool
+    {
+      std::mutex mutex;
+      std::condition_variable_any stopped;
+      std::unique_lock lock{mutex};
+
+      (void)stopped.wait_for(lock, stop_token, delay, [] { return false; });
+
+      return !stop_token.stop_requested();
+    }
+  }  // unnamed namespace
+
+  backup::backup(const db_with_location& source, const db_with_location& destination, backup_options options)
+      : m_destination(destination.value),
+        m_options(validate(std::move(options), destination.location)),
+        m_backup(::sqlite3_backup_init(destination.value, m_options.destination_schema.c_str(), source.value,
+                                       m_options.source_schema.c_str()))
+  {
+    if (m_backup == nullptr)
+    {
+      throw sqlite_error(sqlite_wrapper::format("sqlite3_backup_init() failed to start backup of \"{}\" into \"{}\"",
+                                                m_options.source_schema, m_options.destination_schema),
+                         destination, ::sqlite3_errcode(destination.value));
+    }
+  }
+
+  backup::~backup()
+  {
+    if (m_backup != nullptr)
+    {
+      ::sqlite3_backup_finish(m_backup);
+    }
+  }
+
+  auto backup::step(const std::source_location& loc) -> bool
+  {
+    if (m_done)
+    {
+      return true;
+    }
+
+    if (m_backup == nullptr)
+    {
+      throw sqlite_error("backup is already finished", SQLITE_MISUSE, loc);
+    }
+
+    const auto result{::sqlite3_backup_step(m_backup, m_options.pages_per_step)};
+
+    m_locked = false;
+
+    switch (result)
+    {
+      case SQLITE_DONE:
+        m_done = true;
+        return true;
+      case SQLITE_OK:
+        return false;
+      case SQLITE_BUSY:
+      case SQLITE_LOCKED:
+        m_locked = true;
+        return false;
+      default:
+        throw sqlite_error("sqlite3_backup_step() failed to copy pages", {m_destination, loc}, result);
+    }
+  }
+
+  auto backup::run(const std::stop_token& stop_token, const std::source_location& loc) -> bool
+  {
+    std::optional<std::chrono::steady_clock::time_point> locked_since;
+
+    while (!step(loc))
+    {
+      if (m_options.progress && !m_options.progress(get_progress()))
+      {
+        return false;
+      }
+
+      if (stop_token.stop_requested())
+      {
+        return false;
+      }
+
+      if (m_locked)
+      {
+        const auto now{std::chrono::steady_clock::now()};
+
+        if (!locked_since)
+        {
+          locked_since = now;
+        }
+
+        if ((now - *locked_since) >= m_options.busy_timeout)
+        {
+          throw sqlite_error(sqlite_wrapper::format("backup failed, source or destination locked for more than {} ms",
+                                                    m_options.busy_timeout.count()),
+                             SQLITE_BUSY, loc);
+        }
+      }
+      else
+      {
+        locked_since.reset();
+      }
+
+      const auto delay{(m_options.sleep_between_steps.count() > 0) ? m_options.sleep_between_steps
+                       : m_locked                                  ? locked_retry_delay
+                                                                   : std::chrono::milliseconds{}};
+
+      if ((delay.count() > 0) && !wait(stop_token, delay))
+      {
+        return false;
+      }
+    }
+
+    if (m_options.progress)
+    {
+      (void)m_options.progress(get_progress());
+    }
+
+    finish(loc);
+
+    return true;
+  }
+
+  void backup::finish(const std::source_location& loc)
+  {
+    if (m_backup == nullptr)
+    {
+      return;
+    }
+
+    if (const auto result{::sqlite3_backup_finish(std::exchange(m_backup, nullptr))}; result != SQLITE_OK)
+    {
+      throw sqlite_error("sqlite3_backup_finish() failed", {m_destination, loc}, result);
+    }
+  }
+
+  auto backup::get_progress() const noexcept -> backup_progress
+  {
+    if (m_backup == nullptr)
+    {
+      return {};
+    }
+
+    return {.remaining = ::sqlite3_backup_remaining(m_backup), .page_count = ::sqlite3_backup_pagecount(m_backup)};
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,141 @@
+#include "sqlite_wrapper/busy_handler.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/sqlite_error.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <source_location>
+#include <string_view>
+#include <thread>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    [[noreturn]] void throw_invalid_option(std::string_view what, const std::source_location& loc)
+    {
+      throw sqlite_error(sqlite_wrapper::format("invalid busy_handler_options, {}", what), SQLITE_MISUSE, loc);
+    }
+
+    void validate(const busy_handler_options& options, const std::source_location& loc)
+    {
+      if (options.initial_delay.count() <= 0)
+      {
+        throw_invalid_option("initial_delay must be > 0", loc);
+      }
+
+      if (options.max_delay < options.initial_delay)
+      {
+        throw_invalid_option("max_delay must not be less than initial_delay", loc);
+      }
+
+      if (options.max_total_wait.count() < 0)
+      {
+        throw_invalid_option("max_total_wait must not be negative", loc);
+      }
+
+      if (!(options.multiplier >= 1.0))
+      {
+        throw_invalid_option("multiplier must be >= 1.0", loc);
+      }
+
+      if (!((options.jitter >= 0.0) && (options.jitter <= 1.0)))
+      {
+        throw_invalid_option("jitter must be between 0.0 and 1.0", loc);
+      }
+    }
+  }  // unnamed namespace
+
+  namespace details
+  {
+    auto get_backoff_delay(std::chrono::nanoseconds initial_delay, std::chrono::nanoseconds max_delay, double multiplier,
+                           double jitter, int retry, std::minstd_rand& random) -> std::chrono::nanoseconds
+    {
+      const auto delay{std::min(static_cast<double>(initial_delay.count()) * std::pow(multiplier, retry),
+                                static_cast<double>(max_delay.count()))};
+
+      std::uniform_real_distribution<double> reduction{0.0, jitter};
+
+      return std::chrono::nanoseconds{static_cast<std::int64_t>(delay * (1.0 - reduction(random)))};
+    }
+  }  // namespace details
+
+  busy_handler::busy_handler(::sqlite3* database, const busy_handler_options& options, const std::source_location& loc)
+      : m_database(database),
+        m_options(options),
+        m_random(std::random_device{}())
+  {
+    validate(m_options, loc);
+
+    if (const auto result{::sqlite3_busy_handler(m_database, &busy_handler::on_busy, this)}; result != SQLITE_OK)
+    {
+      throw sqlite_error("sqlite3_busy_handler() failed to install busy handler", db_with_location{m_database, loc}, result);
+    }
+  }
+
+  busy_handler::~busy_handler()
+  {
+    ::sqlite3_busy_handler(m_database, nullptr, nullptr);
+  }
+
+  auto busy_handler::get_metrics() const noexcept -> busy_handler_metrics
+  {
+    return {.busy_events = m_busy_events.load(std::memory_order_relaxed),
+            .retries = m_retries.load(std::memory_order_relaxed),
+            .give_ups = m_give_ups.load(std::memory_order_relaxed),
+            .total_wait_time = std::chrono::nanoseconds{m_total_wait_time_ns.load(std::memory_order_relaxed)},
+            .max_wait_time = std::chrono::nanoseconds{m_max_wait_time_ns.load(std::memory_order_relaxed)}};
+  }
+
+  auto busy_handler::next_delay(int count) -> std::chrono::nanoseconds
+  {
+    return details::get_backoff_delay(m_options.initial_delay, m_options.max_delay, m_options.multiplier, m_options.jitter,
+                                      count, m_random);
+  }
+
+  auto busy_handler::on_busy(void* handler, int count) noexcept -> int
+  {
+    auto& self{*static_cast<busy_handler*>(handler)};
+
+    // SQLite restarts counting with every new statement or transaction that is blocked
+    if (count == 0)
+    {
+      self.m_episode_wait_time = {};
+      self.m_busy_events.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const auto remaining{std::chrono::duration_cast<std::chrono::nanoseconds>(self.m_options.max_total_wait) -
+                         self.m_episode_wait_time};
+
+    if (remaining.count() <= 0)
+    {
+      self.m_give_ups.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+    }
+
+    const auto start{std::chrono::steady_clock::now()};
+
+    std::this_thread::sleep_for(std::min(self.next_delay(count), remaining));
+
+    const auto waited{std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)};
+
+    self.m_episode_wait_time += waited;
+    self.m_retries.fetch_add(1, std::memory_order_relaxed);
+    self.m_total_wait_time_ns.fetch_add(waited.count(), std::memory_order_relaxed);
+
+    // the metrics are only written by the thread that currently holds the connection
+    if (self.m_episode_wait_time.count() > self.m_max_wait_time_ns.load(std::memory_order_relaxed))
+    {
+      self.m_max_wait_time_ns.store(self.m_episode_wait_time.count(), std::memory_order_relaxed);
+    }
+
+    return 1;
+  }
+}  // namespace sqlite_wrapper
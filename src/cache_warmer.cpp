@@ -0,0 +1,243 @@
+#include "sqlite_wrapper/cache_warmer.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <source_location>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    void validate(const warm_options& options, const std::source_location& loc)
+    {
+      if (options.budget == 0)
+      {
+        throw sqlite_error("invalid warm_options, budget must be > 0", SQLITE_MISUSE, loc);
+      }
+
+      if (options.progress_pages == 0)
+      {
+        throw sqlite_error("invalid warm_options, progress_pages must be > 0", SQLITE_MISUSE, loc);
+      }
+
+      if (::sqlite3_compileoption_used("ENABLE_DBSTAT_VTAB") == 0)
+      {
+        throw sqlite_error("warming needs SQLite compiled with SQLITE_ENABLE_DBSTAT_VTAB", SQLITE_MISUSE, loc);
+      }
+    }
+
+    [[nodiscard]] auto quote_identifier(const std::string& identifier) -> std::string
+    {
+      std::string quoted{"\""};
+
+      for (const auto character : identifier)
+      {
+        quoted += character;
+
+        if (character == '"')
+        {
+          quoted += character;
+        }
+      }
+
+      quoted += '"';
+
+      return quoted;
+    }
+
+    /**
+     * Returns the tables and indexes to warm, the names in \p options are checked to exist in the schema.
+     */
+    [[nodiscard]] auto get_objects(const db_with_location& database, const warm_options& options) -> std::vector<std::string>
+    {
+      if (::sqlite3_db_filename(database.value, options.schema.c_str()) == nullptr)
+      {
+        throw sqlite_error(sqlite_wrapper::format("unknown schema \"{}\"", options.schema), SQLITE_MISUSE, database.location);
+      }
+
+      // virtual tables and views have no pages, their root page is 0
+      const auto sql{sqlite_wrapper::format(
+          "SELECT name FROM {}.sqlite_schema WHERE type IN ('table', 'index') AND rootpage > 0 ORDER BY rowid",
+          quote_identifier(options.schema))};
+
+      std::vector<std::string> objects;
+
+      for (auto& [name] : execute<std::tuple<std::string>>(database, sql))
+      {
+        objects.push_back(std::move(name));
+      }
+
+      if (options.objects.empty())
+      {
+        return objects;
+      }
+
+      for (const auto& name : options.objects)
+      {
+        if (std::ranges::find(objects, name) == objects.end())
+        {
+          throw sqlite_error(sqlite_wrapper::format("\"{}\" is not a table or index of schema \"{}\"", name, options.schema),
+                             SQLITE_MISUSE, database.location);
+        }
+      }
+
+      return options.objects;
+    }
+  }  // unnamed namespace
+
+  auto warm(const db_with_location& database, const warm_options& options, const std::stop_token& stop_token) -> warm_progress
+  {
+    validate(options, database.location);
+
+    const auto objects{get_objects(database, options)};
+
+    warm_progress progress{.objects = objects.size()};
+
+    const auto report{[&] { return !stop_token.stop_requested() && (!options.progress || options.progress(progress)); }};
+
+    // dbstat walks the B-tree of the object lazily, one page per row
+    const auto stmt{create_prepared_statement(database, "SELECT pgsize FROM dbstat(?1) WHERE name = ?2")};
+    const stmt_with_location stmt_loc{stmt.get(), database.location};
+
+    for (const auto& name : objects)
+    {
+      reset_and_rebind_prepared_statement(stmt_loc, options.schema, name);
+
+      while (step(stmt_loc))
+      {
+        const auto [page_size] = get_row<std::tuple<std::int64_t>>(stmt_loc);
+
+        ++progress.pages_warmed;
+        progress.bytes_warmed += static_cast<std::uint64_t>(page_size);
+
+        if (progress.bytes_warmed >= options.budget)
+        {
+          progress.budget_exhausted = true;
+          reset_prepared_statement(stmt_loc);
+          (void)report();
+          return progress;
+        }
+
+        if (((progress.pages_warmed % options.progress_pages) == 0) && !report())
+        {
+          reset_prepared_statement(stmt_loc);
+          return progress;
+        }
+      }
+
+      ++progress.objects_warmed;
+
+      if (!report())
+      {
+        return progress;
+      }
+    }
+
+    return progress;
+  }
+
+  cache_warmer::cache_warmer(const std::string& file_name, warm_options options, const std::source_location& loc)
+      : m_options(std::move(options)),
+        m_location(loc)
+  {
+    validate(m_options, loc);
+
+    // only used by the background thread, which is started after the connection is opened
+    m_connection =
+        open(file_name, open_options{.flags = open_flags::open_only, .read_only = true, .no_mutex = true}, loc);
+
+    m_thread = std::jthread{[this](const std::stop_token& stop_token) { run(stop_token); }};
+  }
+
+  cache_warmer::~cache_warmer()
+  {
+    cancel();
+  }
+
+  auto cache_warmer::wait() -> warm_progress
+  {
+    std::unique_lock lock{m_mutex};
+
+    m_finished.wait(lock, [this] { return m_done; });
+
+    if (m_error)
+    {
+      std::rethrow_exception(m_error);
+    }
+
+    return m_progress;
+  }
+
+  void cache_warmer::cancel() noexcept
+  {
+    m_thread.request_stop();
+  }
+
+  auto cache_warmer::is_done() const -> bool
+  {
+    const std::lock_guard lock{m_mutex};
+    return m_done;
+  }
+
+  auto cache_warmer::get_progress() const -> warm_progress
+  {
+    const std::lock_guard lock{m_mutex};
+    return m_progress;
+  }
+
+  void cache_warmer::run(const std::stop_token& stop_token) noexcept
+  {
+    warm_progress progress{};
+    std::exception_ptr error{};
+
+    try
+    {
+      auto options{m_options};
+
+      // publishes the progress for get_progress() before the callback of the caller sees it
+      options.progress = [this](const warm_progress& current)
+      {
+        {
+          const std::lock_guard lock{m_mutex};
+          m_progress = current;
+        }
+
+        return !m_options.progress || m_options.progress(current);
+      };
+
+      progress = warm({m_connection.get(), m_location}, options, stop_token);
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+
+    {
+      const std::lock_guard lock{m_mutex};
+      m_error = error;
+      m_done = true;
+
+      if (!error)
+      {
+        m_progress = progress;
+      }
+    }
+
+    m_finished.notify_all();
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,44 @@
+#include "sqlite_wrapper/compile_options.h"
+
+#include <sqlite3.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sqlite_wrapper
+{
+  auto get_sqlite_version() noexcept -> std::string_view
+  {
+    return ::sqlite3_libversion();
+  }
+
+  auto get_compile_options() -> std::vector<std::string>
+  {
+    std::vector<std::string> options;
+
+    for (int index{0};; ++index)
+    {
+      const auto* option{::sqlite3_compileoption_get(index)};
+
+      if (option == nullptr)
+      {
+        break;
+      }
+
+      options.emplace_back(option);
+    }
+
+    return options;
+  }
+
+  auto is_compile_option_used(const std::string& option) noexcept -> bool
+  {
+    return ::sqlite3_compileoption_used(option.c_str()) != 0;
+  }
+
+  auto get_threading_mode() noexcept -> threading_mode
+  {
+    return static_cast<threading_mode>(::sqlite3_threadsafe());
+  }
+}  // namespace sqlite_wrapper
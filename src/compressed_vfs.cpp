@@ -0,0 +1,960 @@
+#include "sqlite_wrapper/compressed_vfs.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/io_uring_vfs.h"
+#include "sqlite_wrapper/sqlite_error.h"
+
+#include "vfs_shim.h"
+
+#include <sqlite3.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <source_location>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    // file layout: header with the directory of page map chunks, followed by chunks and pages in the order written
+    constexpr std::string_view file_magic{"sqlite_wrapper_z"};
+    constexpr std::uint32_t format_version{1};
+    constexpr std::uint32_t zstd_codec{1};
+
+    constexpr std::size_t header_size{4096};
+    constexpr std::size_t header_fields_size{64};
+    constexpr std::size_t max_chunks{(header_size - header_fields_size) / sizeof(std::uint64_t)};
+
+    constexpr std::size_t entry_size{16};
+    constexpr std::size_t entries_per_chunk{4096};
+    constexpr std::size_t chunk_size{entries_per_chunk * entry_size};
+    constexpr std::size_t block_size{4096};  ///< part of a chunk written when one of its entries changed
+    constexpr std::size_t entries_per_block{block_size / entry_size};
+    constexpr std::size_t blocks_per_chunk{chunk_size / block_size};
+
+    constexpr std::uint32_t allocation_granularity{256};  ///< leaves room for a page to grow a little in place
+    constexpr std::uint32_t min_page_size{512};
+    constexpr std::uint32_t max_page_size{65536};
+
+    template <std::unsigned_integral T>
+    [[nodiscard]] auto load(const std::byte* data) noexcept -> T
+    {
+      T value{};
+      std::memcpy(&value, data, sizeof(T));
+
+      if constexpr (std::endian::native == std::endian::big)
+      {
+        value = std::byteswap(value);
+      }
+
+      return value;
+    }
+
+    template <std::unsigned_integral T>
+    void store(std::byte* data, T value) noexcept
+    {
+      if constexpr (std::endian::native == std::endian::big)
+      {
+        value = std::byteswap(value);
+      }
+
+      std::memcpy(data, &value, sizeof(T));
+    }
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    struct file_header
+    {
+      std::uint32_t page_size{};  ///< 0 until the first page is written
+      std::uint64_t page_count{};
+      std::uint64_t data_end{header_size};  ///< where the next chunk or page is appended
+      std::uint64_t generation{};           ///< incremented with every change of the page map
+      std::array<std::uint64_t, max_chunks> chunks{};  ///< file offsets of the page map chunks, 0 if not allocated
+    };
+
+    // offsets of the fields in the file header
+    constexpr std::size_t version_offset{16};
+    constexpr std::size_t codec_offset{20};
+    constexpr std::size_t page_size_offset{24};
+    constexpr std::size_t page_count_offset{32};
+    constexpr std::size_t data_end_offset{40};
+    constexpr std::size_t generation_offset{48};
+
+    [[nodiscard]] auto parse_header(const std::byte* data, file_header& header) noexcept -> bool
+    {
+      if ((std::memcmp(data, file_magic.data(), file_magic.size()) != 0) ||
+          (load<std::uint32_t>(data + version_offset) != format_version) ||
+          (load<std::uint32_t>(data + codec_offset) != zstd_codec))
+      {
+        return false;
+      }
+
+      header.page_size = load<std::uint32_t>(data + page_size_offset);
+      header.page_count = load<std::uint64_t>(data + page_count_offset);
+      header.data_end = load<std::uint64_t>(data + data_end_offset);
+      header.generation = load<std::uint64_t>(data + generation_offset);
+
+      for (std::size_t i{0}; i < max_chunks; ++i)
+      {
+        header.chunks.at(i) = load<std::uint64_t>(data + header_fields_size + (i * sizeof(std::uint64_t)));
+      }
+
+      // a corrupt or crafted image must not reach the page arithmetic, page_size is 0 only while there are no pages
+      const auto valid_page_size{(header.page_size == 0)
+                                     ? (header.page_count == 0)
+                                     : (std::has_single_bit(header.page_size) && (header.page_size >= min_page_size) &&
+                                        (header.page_size <= max_page_size))};
+
+      return valid_page_size && (header.page_count <= max_chunks * entries_per_chunk);
+    }
+
+    void serialize_header(const file_header& header, std::byte* data) noexcept
+    {
+      std::memset(data, 0, header_size);
+      std::memcpy(data, file_magic.data(), file_magic.size());
+
+      store(data + version_offset, format_version);
+      store(data + codec_offset, zstd_codec);
+      store(data + page_size_offset, header.page_size);
+      store(data + page_count_offset, header.page_count);
+      store(data + data_end_offset, header.data_end);
+      store(data + generation_offset, header.generation);
+
+      for (std::size_t i{0}; i < max_chunks; ++i)
+      {
+        store(data + header_fields_size + (i * sizeof(std::uint64_t)), header.chunks.at(i));
+      }
+    }
+
+    /**
+     * Location of a page, a size equal to the page size means the page is stored uncompressed.
+     */
+    struct map_entry
+    {
+      std::uint64_t offset{};  ///< 0 if the page was never written and reads as zeros
+      std::uint32_t size{};
+      std::uint32_t capacity{};
+    };
+
+    struct map_chunk
+    {
+      std::array<map_entry, entries_per_chunk> entries{};
+      std::bitset<blocks_per_chunk> dirty{};
+    };
+
+    struct compression_context_deleter
+    {
+      void operator()(::ZSTD_CCtx* context) const noexcept
+      {
+        ::ZSTD_freeCCtx(context);
+      }
+    };
+
+    struct decompression_context_deleter
+    {
+      void operator()(::ZSTD_DCtx* context) const noexcept
+      {
+        ::ZSTD_freeDCtx(context);
+      }
+    };
+
+    struct file_state
+    {
+      ::sqlite3_file* real{};  ///< file of the wrapped VFS
+      bool read_only{};
+      int compression_level{};
+      int lock{SQLITE_LOCK_NONE};
+
+      file_header header{};
+      bool dirty{};  ///< page map or header changed since the last flush
+      std::vector<std::unique_ptr<map_chunk>> chunks;
+
+      std::unique_ptr<::ZSTD_CCtx, compression_context_deleter> compression_context;
+      std::unique_ptr<::ZSTD_DCtx, decompression_context_deleter> decompression_context;
+      std::vector<std::byte> compressed;  ///< buffer of a compressed page
+      std::vector<std::byte> page;        ///< buffer of a page that is only read in part
+    };
+
+    struct vfs_registration : details::vfs_registration<compressed_vfs_options>
+    {
+      ::sqlite3_vfs read_only_vfs{};  ///< opens the database files read-only, vfs opens them for reading and writing
+    };
+
+    [[nodiscard]] auto read_real(file_state& file, void* buffer, std::size_t size, std::uint64_t offset) noexcept -> int
+    {
+      return file.real->pMethods->xRead(file.real, buffer, static_cast<int>(size), static_cast<::sqlite3_int64>(offset));
+    }
+
+    [[nodiscard]] auto write_real(file_state& file, const void* buffer, std::size_t size, std::uint64_t offset) noexcept -> int
+    {
+      return file.real->pMethods->xWrite(file.real, buffer, static_cast<int>(size), static_cast<::sqlite3_int64>(offset));
+    }
+
+    /**
+     * Reads the header of the file and drops the cached page map, a new file gets an empty header.
+     */
+    [[nodiscard]] auto load_header(file_state& file) noexcept -> int
+    {
+      ::sqlite3_int64 file_size{};
+
+      if (const auto result{file.real->pMethods->xFileSize(file.real, &file_size)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      file.chunks.clear();
+      file.dirty = false;
+
+      if (file_size == 0)
+      {
+        file.header = {};
+        return SQLITE_OK;
+      }
+
+      std::array<std::byte, header_size> data{};
+
+      if (const auto result{read_real(file, data.data(), data.size(), 0)}; result != SQLITE_OK)
+      {
+        return (result == SQLITE_IOERR_SHORT_READ) ? SQLITE_NOTADB : result;
+      }
+
+      file_header header{};
+
+      if (!parse_header(data.data(), header))
+      {
+        return SQLITE_NOTADB;
+      }
+
+      file.header = header;
+
+      // pages of a transaction whose header was not written yet lie behind data_end
+      file.header.data_end = std::max(file.header.data_end, static_cast<std::uint64_t>(file_size));
+
+      return SQLITE_OK;
+    }
+
+    /**
+     * Reloads the header and page map if another connection changed them.
+     */
+    [[nodiscard]] auto refresh(file_state& file) noexcept -> int
+    {
+      if (file.read_only || file.dirty)
+      {
+        return SQLITE_OK;
+      }
+
+      std::array<std::byte, header_fields_size> data{};
+
+      // a new file reads as zeros, generation 0
+      if (const auto result{read_real(file, data.data(), data.size(), 0)};
+          (result != SQLITE_OK) && (result != SQLITE_IOERR_SHORT_READ))
+      {
+        return result;
+      }
+
+      if (load<std::uint64_t>(data.data() + generation_offset) == file.header.generation)
+      {
+        return SQLITE_OK;
+      }
+
+      return load_header(file);
+    }
+
+    /**
+     * Writes the changed blocks of the page map and then the header.
+     */
+    [[nodiscard]] auto flush(file_state& file) noexcept -> int
+    {
+      if (!file.dirty)
+      {
+        return SQLITE_OK;
+      }
+
+      std::array<std::byte, std::max(block_size, header_size)> data{};
+
+      for (std::size_t chunk_index{0}; chunk_index < file.chunks.size(); ++chunk_index)
+      {
+        auto* const chunk{file.chunks[chunk_index].get()};
+
+        if ((chunk == nullptr) || chunk->dirty.none())
+        {
+          continue;
+        }
+
+        for (std::size_t block{0}; block < blocks_per_chunk; ++block)
+        {
+          if (!chunk->dirty.test(block))
+          {
+            continue;
+          }
+
+          for (std::size_t i{0}; i < entries_per_block; ++i)
+          {
+            const auto& entry{chunk->entries.at((block * entries_per_block) + i)};
+            auto* const target{data.data() + (i * entry_size)};
+
+            store(target, entry.offset);
+            store(target + sizeof(std::uint64_t), entry.size);
+            store(target + sizeof(std::uint64_t) + sizeof(std::uint32_t), entry.capacity);
+          }
+
+          if (const auto result{write_real(file, data.data(), block_size,
+                                           file.header.chunks.at(chunk_index) + (block * block_size))};
+              result != SQLITE_OK)
+          {
+            return result;
+          }
+        }
+
+        chunk->dirty.reset();
+      }
+
+      ++file.header.generation;
+      serialize_header(file.header, data.data());
+
+      if (const auto result{write_real(file, data.data(), header_size, 0)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      file.dirty = false;
+
+      return SQLITE_OK;
+    }
+
+    /**
+     * Returns the chunk of the page map, \p allocate reserves space in the file for a chunk that has none yet.
+     */
+    [[nodiscard]] auto get_chunk(file_state& file, std::size_t chunk_index, bool allocate, map_chunk*& chunk) noexcept -> int
+    {
+      if (chunk_index >= max_chunks)
+      {
+        return allocate ? SQLITE_FULL : SQLITE_CORRUPT;
+      }
+
+      try
+      {
+        if (file.chunks.size() <= chunk_index)
+        {
+          file.chunks.resize(chunk_index + 1);
+        }
+
+        auto& cached{file.chunks[chunk_index]};
+
+        if (!cached)
+        {
+          auto loaded{std::make_unique<map_chunk>()};
+
+          if (const auto offset{file.header.chunks.at(chunk_index)}; offset != 0)
+          {
+            std::vector<std::byte> data(chunk_size);
+
+            if (const auto result{read_real(file, data.data(), data.size(), offset)};
+                (result != SQLITE_OK) && (result != SQLITE_IOERR_SHORT_READ))
+            {
+              return result;
+            }
+
+            for (std::size_t i{0}; i < entries_per_chunk; ++i)
+            {
+              const auto* const source{data.data() + (i * entry_size)};
+
+              loaded->entries.at(i) = {.offset = load<std::uint64_t>(source),
+                                       .size = load<std::uint32_t>(source + sizeof(std::uint64_t)),
+                                       .capacity = load<std::uint32_t>(source + sizeof(std::uint64_t) + sizeof(std::uint32_t))};
+            }
+          }
+
+          cached = std::move(loaded);
+        }
+
+        if (allocate && (file.header.chunks.at(chunk_index) == 0))
+        {
+          file.header.chunks.at(chunk_index) = file.header.data_end;
+          file.header.data_end += chunk_size;
+          cached->dirty.set();
+          file.dirty = true;
+        }
+
+        chunk = cached.get();
+      }
+      catch (...)
+      {
+        return SQLITE_NOMEM;
+      }
+
+      return SQLITE_OK;
+    }
+
+    /**
+     * Reads and decompresses a whole page into \p target.
+     */
+    [[nodiscard]] auto read_page(file_state& file, std::uint64_t page, std::byte* target) noexcept -> int
+    {
+      const auto page_size{file.header.page_size};
+
+      map_chunk* chunk{};
+
+      if (const auto result{get_chunk(file, page / entries_per_chunk, false, chunk)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      const auto& entry{chunk->entries.at(page % entries_per_chunk)};
+
+      if (entry.offset == 0)
+      {
+        std::memset(target, 0, page_size);
+        return SQLITE_OK;
+      }
+
+      if (entry.size == page_size)
+      {
+        return read_real(file, target, page_size, entry.offset);
+      }
+
+      try
+      {
+        file.compressed.resize(entry.size);
+
+        if (!file.decompression_context)
+        {
+          file.decompression_context.reset(::ZSTD_createDCtx());
+
+          if (!file.decompression_context)
+          {
+            return SQLITE_NOMEM;
+          }
+        }
+      }
+      catch (...)
+      {
+        return SQLITE_NOMEM;
+      }
+
+      if (const auto result{read_real(file, file.compressed.data(), entry.size, entry.offset)}; result != SQLITE_OK)
+      {
+        return (result == SQLITE_IOERR_SHORT_READ) ? SQLITE_CORRUPT : result;
+      }
+
+      const auto size{::ZSTD_decompressDCtx(file.decompression_context.get(), target, page_size, file.compressed.data(),
+                                            entry.size)};
+
+      return (::ZSTD_isError(size) || (size != page_size)) ? SQLITE_CORRUPT : SQLITE_OK;
+    }
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // sqlite3_io_methods, see https://www.sqlite.org/c3ref/io_methods.html
+
+    auto file_close(::sqlite3_file* file) noexcept -> int
+    {
+      auto& wrapper{details::to_file<file_state>(file)};
+      const std::unique_ptr<file_state> state{wrapper.state};
+
+      const auto flush_result{flush(*state)};
+      const auto close_result{state->real->pMethods->xClose(state->real)};
+
+      wrapper.state = nullptr;
+
+      return (flush_result != SQLITE_OK) ? flush_result : close_result;
+    }
+
+    auto file_read(::sqlite3_file* file, void* buffer, int amount, ::sqlite3_int64 offset) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+      auto* target{static_cast<std::byte*>(buffer)};
+      auto remaining{static_cast<std::uint64_t>(amount)};
+      auto position{static_cast<std::uint64_t>(offset)};
+      const std::uint64_t page_size{state.header.page_size};
+
+      while (remaining > 0)
+      {
+        const auto page{(page_size > 0) ? (position / page_size) : 0};
+
+        if (page >= state.header.page_count)
+        {
+          // SQLite expects the rest of a short read to be zeroed
+          std::memset(target, 0, remaining);
+          return SQLITE_IOERR_SHORT_READ;
+        }
+
+        const auto in_page{position % page_size};
+        const auto size{std::min(remaining, page_size - in_page)};
+
+        if (size == page_size)
+        {
+          if (const auto result{read_page(state, page, target)}; result != SQLITE_OK)
+          {
+            return result;
+          }
+        }
+        else
+        {
+          try
+          {
+            state.page.resize(page_size);
+          }
+          catch (...)
+          {
+            return SQLITE_IOERR_NOMEM;
+          }
+
+          if (const auto result{read_page(state, page, state.page.data())}; result != SQLITE_OK)
+          {
+            return result;
+          }
+
+          std::memcpy(target, state.page.data() + in_page, size);
+        }
+
+        target += size;
+        position += size;
+        remaining -= size;
+      }
+
+      return SQLITE_OK;
+    }
+
+    auto file_write(::sqlite3_file* file, const void* buffer, int amount, ::sqlite3_int64 offset) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (state.read_only)
+      {
+        return SQLITE_READONLY;
+      }
+
+      const auto size{static_cast<std::uint32_t>(amount)};
+      const auto position{static_cast<std::uint64_t>(offset)};
+
+      if (state.header.page_size == 0)
+      {
+        if (!std::has_single_bit(size) || (size < min_page_size) || (size > max_page_size))
+        {
+          return SQLITE_IOERR_WRITE;
+        }
+
+        state.header.page_size = size;
+        state.dirty = true;
+      }
+
+      // SQLite only writes whole pages to main database files
+      if ((size != state.header.page_size) || ((position % size) != 0))
+      {
+        return SQLITE_IOERR_WRITE;
+      }
+
+      const auto page{position / size};
+
+      map_chunk* chunk{};
+
+      if (const auto result{get_chunk(state, page / entries_per_chunk, true, chunk)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      try
+      {
+        state.compressed.resize(::ZSTD_compressBound(size));
+
+        if (!state.compression_context)
+        {
+          state.compression_context.reset(::ZSTD_createCCtx());
+
+          if (!state.compression_context)
+          {
+            return SQLITE_NOMEM;
+          }
+        }
+      }
+      catch (...)
+      {
+        return SQLITE_NOMEM;
+      }
+
+      const auto compressed_size{::ZSTD_compressCCtx(state.compression_context.get(), state.compressed.data(),
+                                                     state.compressed.size(), buffer, size, state.compression_level)};
+
+      // pages that do not get smaller are stored as they are
+      const auto stored_as_is{::ZSTD_isError(compressed_size) || (compressed_size >= size)};
+      const auto stored_size{stored_as_is ? size : static_cast<std::uint32_t>(compressed_size)};
+      const void* const stored{stored_as_is ? buffer : state.compressed.data()};
+
+      const auto entry_index{page % entries_per_chunk};
+      auto& entry{chunk->entries.at(entry_index)};
+
+      if ((entry.offset == 0) || (entry.capacity < stored_size))
+      {
+        const auto capacity{((stored_size + allocation_granularity - 1) / allocation_granularity) * allocation_granularity};
+
+        entry.offset = state.header.data_end;
+        entry.capacity = capacity;
+        state.header.data_end += capacity;
+      }
+
+      entry.size = stored_size;
+      chunk->dirty.set(entry_index / entries_per_block);
+      state.header.page_count = std::max(state.header.page_count, page + 1);
+      state.dirty = true;
+
+      return write_real(state, stored, stored_size, entry.offset);
+    }
+
+    auto file_truncate(::sqlite3_file* file, ::sqlite3_int64 size) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (state.read_only)
+      {
+        return SQLITE_READONLY;
+      }
+
+      const std::uint64_t page_size{state.header.page_size};
+
+      if (page_size == 0)
+      {
+        return SQLITE_OK;
+      }
+
+      if (size == 0)
+      {
+        // the space is not reclaimed, but a new page size can be used
+        const auto data_end{state.header.data_end};
+        const auto generation{state.header.generation};
+
+        state.header = {.data_end = data_end, .generation = generation};
+        state.chunks.clear();
+        state.dirty = true;
+
+        return SQLITE_OK;
+      }
+
+      const auto page_count{(static_cast<std::uint64_t>(size) + page_size - 1) / page_size};
+
+      for (auto page{page_count}; page < state.header.page_count; ++page)
+      {
+        if (state.header.chunks.at(page / entries_per_chunk) == 0)
+        {
+          continue;
+        }
+
+        map_chunk* chunk{};
+
+        if (const auto result{get_chunk(state, page / entries_per_chunk, false, chunk)}; result != SQLITE_OK)
+        {
+          return result;
+        }
+
+        chunk->entries.at(page % entries_per_chunk) = {};
+        chunk->dirty.set((page % entries_per_chunk) / entries_per_block);
+      }
+
+      state.header.page_count = std::min(state.header.page_count, page_count);
+      state.dirty = true;
+
+      return SQLITE_OK;
+    }
+
+    auto file_sync(::sqlite3_file* file, int flags) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (const auto result{flush(state)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      return state.real->pMethods->xSync(state.real, flags);
+    }
+
+    auto file_size(::sqlite3_file* file, ::sqlite3_int64* size) noexcept -> int
+    {
+      const auto& state{details::to_state<file_state>(file)};
+
+      *size = static_cast<::sqlite3_int64>(state.header.page_count * state.header.page_size);
+
+      return SQLITE_OK;
+    }
+
+    auto file_lock(::sqlite3_file* file, int lock) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (const auto result{state.real->pMethods->xLock(state.real, lock)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      const auto previous_lock{std::exchange(state.lock, lock)};
+
+      // another connection may have changed the file since this one released its locks
+      return (previous_lock == SQLITE_LOCK_NONE) ? refresh(state) : SQLITE_OK;
+    }
+
+    auto file_unlock(::sqlite3_file* file, int lock) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      // other connections must see the page map as soon as they can lock the file
+      const auto flush_result{flush(state)};
+      const auto unlock_result{state.real->pMethods->xUnlock(state.real, lock)};
+
+      state.lock = std::min(state.lock, lock);
+
+      return (flush_result != SQLITE_OK) ? flush_result : unlock_result;
+    }
+
+    auto file_control(::sqlite3_file* file, int operation, void* argument) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (operation == SQLITE_FCNTL_SIZE_HINT)
+      {
+        // the hint is the uncompressed size, preallocating it would waste the saved space
+        return SQLITE_OK;
+      }
+
+      return state.real->pMethods->xFileControl(state.real, operation, argument);
+    }
+
+    auto file_device_characteristics(::sqlite3_file* file) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      // a page write is a write of the page and one of the page map, so it is never atomic
+      constexpr int atomic_writes{SQLITE_IOCAP_ATOMIC | SQLITE_IOCAP_ATOMIC512 | SQLITE_IOCAP_ATOMIC1K |
+                                  SQLITE_IOCAP_ATOMIC2K | SQLITE_IOCAP_ATOMIC4K | SQLITE_IOCAP_ATOMIC8K |
+                                  SQLITE_IOCAP_ATOMIC16K | SQLITE_IOCAP_ATOMIC32K | SQLITE_IOCAP_ATOMIC64K |
+                                  SQLITE_IOCAP_BATCH_ATOMIC};
+
+      const auto characteristics{state.real->pMethods->xDeviceCharacteristics(state.real) & ~atomic_writes};
+
+      return state.read_only ? (characteristics | SQLITE_IOCAP_IMMUTABLE) : characteristics;
+    }
+
+    auto file_shm_lock(::sqlite3_file* file, int offset, int count, int flags) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      // in WAL mode the database file stays locked, checkpoints are published by releasing wal-index locks
+      if ((flags & SQLITE_SHM_UNLOCK) != 0)
+      {
+        const auto flush_result{flush(state)};
+        const auto unlock_result{state.real->pMethods->xShmLock(state.real, offset, count, flags)};
+
+        return (flush_result != SQLITE_OK) ? flush_result : unlock_result;
+      }
+
+      if (const auto result{state.real->pMethods->xShmLock(state.real, offset, count, flags)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      return refresh(state);
+    }
+
+    auto file_fetch(::sqlite3_file* /*file*/, ::sqlite3_int64 /*offset*/, int /*amount*/, void** pointer) noexcept -> int
+    {
+      // the file holds compressed pages, SQLite reads with xRead() instead
+      *pointer = nullptr;
+      return SQLITE_OK;
+    }
+
+    auto file_unfetch(::sqlite3_file* /*file*/, ::sqlite3_int64 /*offset*/, void* /*pointer*/) noexcept -> int
+    {
+      return SQLITE_OK;
+    }
+
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    [[nodiscard]] auto make_io_methods() noexcept -> ::sqlite3_io_methods
+    {
+      // all other methods forward to the file of the wrapped VFS
+      auto methods{details::make_io_methods<file_state>()};
+
+      methods.xClose = &file_close;
+      methods.xRead = &file_read;
+      methods.xWrite = &file_write;
+      methods.xTruncate = &file_truncate;
+      methods.xSync = &file_sync;
+      methods.xFileSize = &file_size;
+      methods.xLock = &file_lock;
+      methods.xUnlock = &file_unlock;
+      methods.xFileControl = &file_control;
+      methods.xDeviceCharacteristics = &file_device_characteristics;
+      methods.xShmLock = &file_shm_lock;
+      methods.xFetch = &file_fetch;
+      methods.xUnfetch = &file_unfetch;
+
+      return methods;
+    }
+
+    const ::sqlite3_io_methods io_methods{make_io_methods()};
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // sqlite3_vfs, all methods but xOpen() are the ones of the wrapped VFS
+
+    auto open_file(::sqlite3_vfs* vfs, const char* name, ::sqlite3_file* file, int flags, int* out_flags,
+                   bool read_only) noexcept -> int
+    {
+      auto* const base_vfs{static_cast<::sqlite3_vfs*>(vfs->pAppData)};
+
+      if ((name == nullptr) || ((flags & SQLITE_OPEN_MAIN_DB) == 0))
+      {
+        // journals, WALs and temporary files are stored uncompressed by the wrapped VFS
+        return base_vfs->xOpen(base_vfs, name, file, flags, out_flags);
+      }
+
+      if (read_only)
+      {
+        flags = (flags & ~(SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE)) | SQLITE_OPEN_READONLY;
+      }
+
+      int opened_flags{};
+
+      if (const auto result{details::open_real_file<file_state>(base_vfs, name, file, flags, &opened_flags)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      auto& wrapper{details::to_file<file_state>(file)};
+      auto* const real{details::to_real_file<file_state>(file)};
+
+      if (out_flags != nullptr)
+      {
+        *out_flags = opened_flags;
+      }
+
+      try
+      {
+        auto state{std::make_unique<file_state>()};
+        state->real = real;
+        state->read_only = read_only;
+
+        {
+          auto& registration{details::get_registration<vfs_registration>()};
+          const std::lock_guard lock{registration.mutex};
+          state->compression_level = registration.options.compression_level;
+        }
+
+        if (const auto result{load_header(*state)}; result != SQLITE_OK)
+        {
+          real->pMethods->xClose(real);
+          return result;
+        }
+
+        wrapper.state = state.release();
+        wrapper.base.pMethods = &io_methods;
+      }
+      catch (...)
+      {
+        real->pMethods->xClose(real);
+        return SQLITE_NOMEM;
+      }
+
+      return SQLITE_OK;
+    }
+
+    auto vfs_open_read_write(::sqlite3_vfs* vfs, const char* name, ::sqlite3_file* file, int flags, int* out_flags) noexcept
+        -> int
+    {
+      return open_file(vfs, name, file, flags, out_flags, false);
+    }
+
+    auto vfs_open_read_only(::sqlite3_vfs* vfs, const char* name, ::sqlite3_file* file, int flags, int* out_flags) noexcept
+        -> int
+    {
+      return open_file(vfs, name, file, flags, out_flags, true);
+    }
+  }  // unnamed namespace
+
+  void register_compressed_vfs(const compressed_vfs_options& options, const std::source_location& loc)
+  {
+    if ((options.compression_level < ::ZSTD_minCLevel()) || (options.compression_level > ::ZSTD_maxCLevel()))
+    {
+      throw sqlite_error(sqlite_wrapper::format("invalid compressed_vfs_options, compression_level {} must be from {} to {}",
+                                                options.compression_level, ::ZSTD_minCLevel(), ::ZSTD_maxCLevel()),
+                         SQLITE_MISUSE, loc);
+    }
+
+    auto& registration{details::get_registration<vfs_registration>()};
+    const std::lock_guard lock{registration.mutex};
+
+    registration.options = options;
+
+    if (registration.base == nullptr)
+    {
+      auto* const base{::sqlite3_vfs_find(nullptr)};
+
+      if (base == nullptr)
+      {
+        throw sqlite_error("no default VFS to wrap found", SQLITE_ERROR, loc);
+      }
+
+      if (std::string_view{base->zName} == io_uring_vfs_name)
+      {
+        // it flushes the WAL when SQLite publishes commits through its own database files only
+        throw sqlite_error("the compressing VFS can not wrap the io_uring VFS", SQLITE_MISUSE, loc);
+      }
+
+      registration.base = base;
+
+      registration.vfs = details::make_vfs<file_state>(base, compressed_vfs_name, &vfs_open_read_write);
+      registration.read_only_vfs = details::make_vfs<file_state>(base, compressed_read_only_vfs_name, &vfs_open_read_only);
+    }
+
+    for (auto* const vfs : {&registration.vfs, &registration.read_only_vfs})
+    {
+      if (const auto result{::sqlite3_vfs_register(vfs, 0)}; result != SQLITE_OK)
+      {
+        throw sqlite_error(sqlite_wrapper::format("sqlite3_vfs_register() failed to register VFS \"{}\"", vfs->zName), result,
+                           loc);
+      }
+    }
+  }
+
+  auto get_compression_stats(const std::string& file_name, const std::source_location& loc) -> compression_stats
+  {
+    std::ifstream file{file_name, std::ios::binary};
+
+    if (!file)
+    {
+      throw sqlite_error(sqlite_wrapper::format("failed to open \"{}\"", file_name), SQLITE_CANTOPEN, loc);
+    }
+
+    const auto physical_size{std::filesystem::file_size(file_name)};
+
+    if (physical_size == 0)
+    {
+      return {};
+    }
+
+    std::array<std::byte, header_size> data{};
+    file_header header{};
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (!file.read(reinterpret_cast<char*>(data.data()), data.size()) || !parse_header(data.data(), header))
+    {
+      throw sqlite_error(sqlite_wrapper::format("\"{}\" is not a database file of the compressing VFS", file_name),
+                         SQLITE_NOTADB, loc);
+    }
+
+    return {.logical_size = header.page_count * header.page_size, .physical_size = physical_size};
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,241 @@
+#include "sqlite_wrapper/connection_pool.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <source_location>
+#include <string>
+#include <utility>
+
+namespace sqlite_wrapper
+{
+  pooled_connection::pooled_connection(connection_pool* pool, ::sqlite3* handle, std::size_t index, bool is_writer) noexcept
+      : m_pool(pool),
+        m_handle(handle),
+        m_index(index),
+        m_is_writer(is_writer),
+        m_checkout_time(std::chrono::steady_clock::now())
+  {
+  }
+
+  pooled_connection::~pooled_connection()
+  {
+    release();
+  }
+
+  pooled_connection::pooled_connection(pooled_connection&& other) noexcept
+      : m_pool(std::exchange(other.m_pool, nullptr)),
+        m_handle(std::exchange(other.m_handle, nullptr)),
+        m_index(other.m_index),
+        m_is_writer(other.m_is_writer),
+        m_checkout_time(other.m_checkout_time)
+  {
+  }
+
+  auto pooled_connection::operator=(pooled_connection&& other) noexcept -> pooled_connection&
+  {
+    if (this != &other)
+    {
+      release();
+
+      m_pool = std::exchange(other.m_pool, nullptr);
+      m_handle = std::exchange(other.m_handle, nullptr);
+      m_index = other.m_index;
+      m_is_writer = other.m_is_writer;
+      m_checkout_time = other.m_checkout_time;
+    }
+
+    return *this;
+  }
+
+  void pooled_connection::release() noexcept
+  {
+    if (m_pool != nullptr)
+    {
+      m_pool->check_in(m_index, m_is_writer, m_checkout_time);
+      m_pool = nullptr;
+      m_handle = nullptr;
+    }
+  }
+
+  connection_pool::connection_pool(const std::string& file_name, const connection_pool_options& options,
+                                   const std::source_location& loc)
+      : m_file_name(file_name),
+        m_created(std::chrono::steady_clock::now())
+  {
+    if (options.reader_count == 0)
+    {
+      throw sqlite_error(sqlite_wrapper::format("connection pool for database \"{}\" needs at least one reader", file_name),
+                         SQLITE_MISUSE, loc);
+    }
+
+    // a pooled_connection is only used by one thread at a time, so the connection mutex is not needed
+    auto writer_options{options.connection_options};
+    writer_options.no_mutex = true;
+    writer_options.journal = journal_mode::wal;
+    writer_options.read_only = false;
+
+    // the journal mode and page size are properties of the database file, they can only be set by the writer
+    auto reader_options{options.connection_options};
+    reader_options.no_mutex = true;
+    reader_options.flags = open_flags::open_only;
+    reader_options.read_only = true;
+    reader_options.journal.reset();
+    reader_options.page_size.reset();
+
+    validate(writer_options, loc);
+    validate(reader_options, loc);
+
+    // the writer creates the database and switches it to WAL mode, which is persistent, before the readers are opened
+    m_writer = open(file_name, writer_options, loc);
+
+    m_readers.reserve(options.reader_count);
+
+    for (std::size_t index{0}; index < options.reader_count; ++index)
+    {
+      m_readers.push_back(open(file_name, reader_options, loc));
+    }
+
+    m_free_readers.resize(m_readers.size());
+    std::iota(m_free_readers.rbegin(), m_free_readers.rend(), std::size_t{0});  // hand out reader 0 first
+
+    m_metrics.reader_count = m_readers.size();
+  }
+
+  connection_pool::~connection_pool()
+  {
+    // pooled_connection must not outlive its pool
+    assert(m_writer_free && (m_free_readers.size() == m_readers.size()));
+  }
+
+  auto connection_pool::checkout_reader(std::chrono::milliseconds timeout, const std::source_location& loc) -> pooled_connection
+  {
+    auto connection{checkout(false, timeout)};
+
+    if (!connection)
+    {
+      throw sqlite_error(sqlite_wrapper::format("timeout after {} ms waiting for a reader of database \"{}\"", timeout.count(),
+                                                m_file_name),
+                         SQLITE_BUSY, loc);
+    }
+
+    return std::move(*connection);
+  }
+
+  auto connection_pool::checkout_writer(std::chrono::milliseconds timeout, const std::source_location& loc) -> pooled_connection
+  {
+    auto connection{checkout(true, timeout)};
+
+    if (!connection)
+    {
+      throw sqlite_error(sqlite_wrapper::format("timeout after {} ms waiting for the writer of database \"{}\"", timeout.count(),
+                                                m_file_name),
+                         SQLITE_BUSY, loc);
+    }
+
+    return std::move(*connection);
+  }
+
+  auto connection_pool::try_checkout_reader(std::chrono::milliseconds timeout) -> std::optional<pooled_connection>
+  {
+    return checkout(false, timeout);
+  }
+
+  auto connection_pool::try_checkout_writer(std::chrono::milliseconds timeout) -> std::optional<pooled_connection>
+  {
+    return checkout(true, timeout);
+  }
+
+  auto connection_pool::get_metrics() const -> connection_pool_metrics
+  {
+    const std::scoped_lock lock{m_mutex};
+
+    auto metrics{m_metrics};
+    metrics.lifetime = std::chrono::steady_clock::now() - m_created;
+
+    return metrics;
+  }
+
+  auto connection_pool::checkout(bool is_writer, std::chrono::milliseconds timeout) -> std::optional<pooled_connection>
+  {
+    const auto start{std::chrono::steady_clock::now()};
+
+    std::unique_lock lock{m_mutex};
+
+    const auto available{is_writer ? m_writer_available.wait_for(lock, timeout, [this] { return m_writer_free; })
+                                   : m_reader_available.wait_for(lock, timeout, [this] { return !m_free_readers.empty(); })};
+
+    const std::chrono::nanoseconds wait_time{std::chrono::steady_clock::now() - start};
+
+    m_metrics.max_wait_time = std::max(m_metrics.max_wait_time, wait_time);
+
+    if (!available)
+    {
+      ++m_metrics.timeouts;
+      return std::nullopt;
+    }
+
+    if (is_writer)
+    {
+      m_writer_free = false;
+      m_metrics.writer_in_use = true;
+      ++m_metrics.writer_checkouts;
+      m_metrics.writer_wait_time += wait_time;
+
+      return pooled_connection{this, m_writer.get(), 0, true};
+    }
+
+    const auto index{m_free_readers.back()};
+    m_free_readers.pop_back();
+
+    ++m_metrics.readers_in_use;
+    ++m_metrics.reader_checkouts;
+    m_metrics.reader_wait_time += wait_time;
+
+    return pooled_connection{this, m_readers[index].get(), index, false};
+  }
+
+  void connection_pool::check_in(std::size_t index, bool is_writer, std::chrono::steady_clock::time_point checkout_time) noexcept
+  {
+    const std::chrono::nanoseconds busy_time{std::chrono::steady_clock::now() - checkout_time};
+
+    {
+      const std::scoped_lock lock{m_mutex};
+
+      if (is_writer)
+      {
+        m_writer_free = true;
+        m_metrics.writer_in_use = false;
+        m_metrics.writer_busy_time += busy_time;
+      }
+      else
+      {
+        // can not throw, capacity for all readers was reserved by the constructor
+        m_free_readers.push_back(index);
+        --m_metrics.readers_in_use;
+        m_metrics.reader_busy_time += busy_time;
+      }
+    }
+
+    if (is_writer)
+    {
+      m_writer_available.notify_one();
+    }
+    else
+    {
+      m_reader_available.notify_one();
+    }
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,62 @@
+#include "sqlite_wrapper/error_code.h"
+
+#include "sqlite_wrapper/format.h"
+
+#include <sqlite3.h>
+
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    class sqlite_error_category : public std::error_category
+    {
+     public:
+      [[nodiscard]] auto name() const noexcept -> const char* override
+      {
+        return "sqlite";
+      }
+
+      [[nodiscard]] auto message(int error) const -> std::string override
+      {
+        return std::string{get_error_string(static_cast<sqlite_errc>(error))};
+      }
+    };
+  }  // unnamed namespace
+
+  auto get_error_string(sqlite_errc code) noexcept -> std::string_view
+  {
+    const auto* err_str{::sqlite3_errstr(to_underlying(code))};
+
+    return (err_str != nullptr) ? err_str : "<unknown error>";
+  }
+
+  auto sqlite_category() noexcept -> const std::error_category&
+  {
+    static const sqlite_error_category category{};
+
+    return category;
+  }
+
+  namespace details
+  {
+    auto to_sqlite_errc(::sqlite3* database, int result) noexcept -> sqlite_errc
+    {
+      if (database != nullptr)
+      {
+        const auto extended{static_cast<sqlite_errc>(::sqlite3_extended_errcode(database))};
+
+        // the connection only knows the extended version of the latest error
+        if (primary_code(extended) == primary_code(static_cast<sqlite_errc>(result)))
+        {
+          return extended;
+        }
+      }
+
+      return static_cast<sqlite_errc>(result);
+    }
+  }  // namespace details
+}  // namespace sqlite_wrapper
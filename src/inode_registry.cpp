@@ -0,0 +1,84 @@
+#include "inode_registry.h"
+
+#ifdef __linux__
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+
+#  include <cerrno>
+
+namespace sqlite_wrapper::details
+{
+  auto inode_registry::instance() -> inode_registry&
+  {
+    static inode_registry registry;
+    return registry;
+  }
+
+  auto inode_registry::acquire(const char* path, bool writable, bool& direct, key& file_key) -> int
+  {
+    struct ::stat status{};
+
+    if (::stat(path, &status) != 0)
+    {
+      return -1;
+    }
+
+    file_key = {.device = status.st_dev, .inode = status.st_ino};
+
+    const std::lock_guard lock{m_mutex};
+
+    auto& file{m_inodes[file_key]};
+    auto fd{get_fd(file, path, writable, direct)};
+
+    if ((fd < 0) && direct && (errno == EINVAL))
+    {
+      // file systems like tmpfs do not support O_DIRECT
+      direct = false;
+      fd = get_fd(file, path, writable, direct);
+    }
+
+    if (fd >= 0)
+    {
+      ++file.references;
+    }
+    else if (file.references == 0)
+    {
+      m_inodes.erase(file_key);
+    }
+
+    return fd;
+  }
+
+  void inode_registry::release(const key& file_key) noexcept
+  {
+    const std::lock_guard lock{m_mutex};
+
+    if (const auto file{m_inodes.find(file_key)}; (file != m_inodes.end()) && (--file->second.references == 0))
+    {
+      for (const auto fd : file->second.fds)
+      {
+        if (fd >= 0)
+        {
+          ::close(fd);
+        }
+      }
+
+      m_inodes.erase(file);
+    }
+  }
+
+  auto inode_registry::get_fd(entry& file, const char* path, bool writable, bool direct) -> int
+  {
+    auto& fd{file.fds.at((direct ? 2U : 0U) + (writable ? 1U : 0U))};
+
+    if (fd < 0)
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+      fd = ::open(path, (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC | (direct ? O_DIRECT : 0));
+    }
+
+    return fd;
+  }
+}  // namespace sqlite_wrapper::details
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+
+#ifdef __linux__
+#  include <sys/types.h>
+
+#  include <array>
+#  include <compare>
+#  include <cstddef>
+#  include <map>
+#  include <mutex>
+
+namespace sqlite_wrapper::details
+{
+  /**
+   * Shares the file descriptors that the VFS shims open next to the ones of the unix VFS between all their files of the
+   * process. Closing any file descriptor of a file releases all POSIX locks of the process on it, so they are only closed
+   * with the last file.
+   */
+  class inode_registry
+  {
+   public:
+    struct key
+    {
+      ::dev_t device{};
+      ::ino_t inode{};
+
+      auto operator<=>(const key&) const = default;
+    };
+
+    [[nodiscard]] static auto instance() -> inode_registry&;
+
+    /**
+     * Returns a file descriptor of \p path or -1 with errno set, \p direct is reset if O_DIRECT is not supported.
+     *
+     * @throws std::bad_alloc if there is no memory
+     */
+    [[nodiscard]] auto acquire(const char* path, bool writable, bool& direct, key& file_key) -> int;
+
+    /**
+     * Releases a file descriptor returned by acquire(), closes all of the file with the last one.
+     */
+    void release(const key& file_key) noexcept;
+
+   private:
+    struct entry
+    {
+      std::array<int, 4> fds{-1, -1, -1, -1};  ///< indexed by direct * 2 + writable
+      std::size_t references{};
+    };
+
+    static auto get_fd(entry& file, const char* path, bool writable, bool direct) -> int;
+
+    std::mutex m_mutex;
+    std::map<key, entry> m_inodes;
+  };
+}  // namespace sqlite_wrapper::details
+#endif
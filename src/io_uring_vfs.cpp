@@ -0,0 +1,1044 @@
+#include "sqlite_wrapper/io_uring_vfs.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/sqlite_error.h"
+
+#include "inode_registry.h"
+#include "vfs_shim.h"
+
+#include <sqlite3.h>
+
+#include <source_location>
+
+#ifdef __linux__
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+
+#  include <algorithm>
+#  include <atomic>
+#  include <cerrno>
+#  include <cstddef>
+#  include <cstdint>
+#  include <cstdlib>
+#  include <cstring>
+#  include <memory>
+#  include <mutex>
+#  include <new>
+#  include <optional>
+#  include <span>
+#  include <system_error>
+#  include <unordered_map>
+#  include <utility>
+#  include <vector>
+#endif
+
+namespace sqlite_wrapper
+{
+#ifdef __linux__
+  namespace
+  {
+    constexpr unsigned max_queue_depth{4096};
+    constexpr std::size_t direct_io_alignment{4096};
+    constexpr std::size_t max_pooled_buffers{256};
+
+    /**
+     * A read or write of a file, repeated for the remaining bytes until it is complete.
+     */
+    struct operation
+    {
+      bool write{};
+      int fd{-1};
+      std::byte* buffer{};
+      std::size_t size{};
+      std::uint64_t offset{};
+
+      std::size_t done{};
+      int error{};             ///< errno of a failed operation
+      bool end_of_file{};      ///< a read reached the end of the file
+      ::iovec io_vector{};     ///< only used while the operation is submitted
+
+      [[nodiscard]] auto is_finished() const noexcept -> bool
+      {
+        return (done == size) || (error != 0) || end_of_file;
+      }
+
+      void complete(std::int64_t result) noexcept
+      {
+        if (result < 0)
+        {
+          error = static_cast<int>(-result);
+        }
+        else if (result == 0)
+        {
+          // a write of zero bytes does not make progress either
+          end_of_file = !write;
+          error = write ? EIO : 0;
+        }
+        else
+        {
+          done += static_cast<std::size_t>(result);
+        }
+      }
+    };
+
+    void run_synchronously(std::span<operation> operations) noexcept
+    {
+      for (auto& op : operations)
+      {
+        while (!op.is_finished())
+        {
+          auto* const buffer{op.buffer + op.done};  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+          const auto offset{static_cast<::off_t>(op.offset + op.done)};
+          const auto result{op.write ? ::pwrite(op.fd, buffer, op.size - op.done, offset)
+                                     : ::pread(op.fd, buffer, op.size - op.done, offset)};
+
+          if ((result < 0) && (errno == EINTR))
+          {
+            continue;
+          }
+
+          op.complete((result < 0) ? -errno : result);
+        }
+      }
+    }
+
+    /**
+     * Minimal io_uring with the raw system calls, see https://kernel.dk/io_uring.pdf .
+     *
+     * Operations are submitted and waited for in one go, so no operation is in flight between calls of run().
+     */
+    class ring
+    {
+     public:
+      /**
+       * Returns nullptr and sets errno if the kernel does not support io_uring or does not allow to use it.
+       */
+      [[nodiscard]] static auto create(unsigned entries) noexcept -> std::unique_ptr<ring>
+      {
+        ::io_uring_params params{};
+
+        const auto fd{static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params))};
+
+        if (fd < 0)
+        {
+          return nullptr;
+        }
+
+        std::unique_ptr<ring> result{new (std::nothrow) ring{fd, params}};
+
+        if (result == nullptr)
+        {
+          ::close(fd);
+          errno = ENOMEM;
+          return nullptr;
+        }
+
+        if (!result->is_mapped())
+        {
+          return nullptr;
+        }
+
+        return result;
+      }
+
+      ~ring()
+      {
+        if (m_sqes != MAP_FAILED)
+        {
+          ::munmap(m_sqes, m_sqes_size);
+        }
+
+        if ((m_cq_ring != MAP_FAILED) && (m_cq_ring != m_sq_ring))
+        {
+          ::munmap(m_cq_ring, m_cq_ring_size);
+        }
+
+        if (m_sq_ring != MAP_FAILED)
+        {
+          ::munmap(m_sq_ring, m_sq_ring_size);
+        }
+
+        ::close(m_fd);
+      }
+
+      ring(const ring&) = delete;
+      ring(ring&&) = delete;
+      auto operator=(const ring&) -> ring& = delete;
+      auto operator=(ring&&) -> ring& = delete;
+
+      /**
+       * Runs all operations until they are finished.
+       *
+       * @returns false if the ring failed and must not be used anymore, the operations are then unfinished
+       */
+      [[nodiscard]] auto run(std::span<operation> operations) noexcept -> bool
+      {
+        while (true)
+        {
+          // submits the unfinished operations in batches of at most m_entries, without allocating
+          unsigned count{0};
+          bool submitted_any{false};
+
+          for (auto& op : operations)
+          {
+            if (op.is_finished())
+            {
+              continue;
+            }
+
+            prepare(op);
+
+            if (++count == m_entries)
+            {
+              if (!submit_and_wait(count))
+              {
+                return false;
+              }
+
+              count = 0;
+              submitted_any = true;
+            }
+          }
+
+          if (count > 0)
+          {
+            if (!submit_and_wait(count))
+            {
+              return false;
+            }
+          }
+          else if (!submitted_any)
+          {
+            return true;
+          }
+        }
+      }
+
+     private:
+      ring(int fd, const ::io_uring_params& params) noexcept
+          : m_fd(fd),
+            m_entries(params.sq_entries),
+            m_sq_ring_size(params.sq_off.array + (params.sq_entries * sizeof(unsigned))),
+            m_cq_ring_size(params.cq_off.cqes + (params.cq_entries * sizeof(::io_uring_cqe))),
+            m_sqes_size(params.sq_entries * sizeof(::io_uring_sqe))
+      {
+        const auto single_mmap{(params.features & IORING_FEAT_SINGLE_MMAP) != 0};
+
+        if (single_mmap)
+        {
+          m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+        }
+
+        m_sq_ring = ::mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd,
+                           IORING_OFF_SQ_RING);
+        m_cq_ring = single_mmap ? m_sq_ring
+                                : ::mmap(nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd,
+                                         IORING_OFF_CQ_RING);
+        m_sqes = ::mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+
+        if (is_mapped())
+        {
+          m_sq_tail = field<unsigned>(m_sq_ring, params.sq_off.tail);
+          m_sq_mask = *field<unsigned>(m_sq_ring, params.sq_off.ring_mask);
+          m_sq_array = field<unsigned>(m_sq_ring, params.sq_off.array);
+          m_cq_head = field<unsigned>(m_cq_ring, params.cq_off.head);
+          m_cq_tail = field<unsigned>(m_cq_ring, params.cq_off.tail);
+          m_cq_mask = *field<unsigned>(m_cq_ring, params.cq_off.ring_mask);
+          m_cqes = field<::io_uring_cqe>(m_cq_ring, params.cq_off.cqes);
+        }
+      }
+
+      template <typename T>
+      [[nodiscard]] static auto field(void* ring, std::uint32_t offset) noexcept -> T*
+      {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return reinterpret_cast<T*>(static_cast<std::byte*>(ring) + offset);
+      }
+
+      [[nodiscard]] auto is_mapped() const noexcept -> bool
+      {
+        return (m_sq_ring != MAP_FAILED) && (m_cq_ring != MAP_FAILED) && (m_sqes != MAP_FAILED);
+      }
+
+      void prepare(operation& op) noexcept
+      {
+        // only this thread produces submissions, the kernel reads the tail
+        const auto tail{*m_sq_tail};
+        const auto index{tail & m_sq_mask};
+        auto& sqe{static_cast<::io_uring_sqe*>(m_sqes)[index]};  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+        op.io_vector = {.iov_base = op.buffer + op.done,  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                        .iov_len = op.size - op.done};
+
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = op.write ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe.fd = op.fd;
+        sqe.off = op.offset + op.done;
+        sqe.addr = reinterpret_cast<std::uint64_t>(&op.io_vector);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        sqe.len = 1;
+        sqe.user_data = reinterpret_cast<std::uint64_t>(&op);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+
+        m_sq_array[index] = index;  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        std::atomic_ref{*m_sq_tail}.store(tail + 1, std::memory_order_release);
+      }
+
+      [[nodiscard]] auto submit_and_wait(unsigned count) noexcept -> bool
+      {
+        unsigned submitted{0};
+        unsigned completed{0};
+
+        while (completed < count)
+        {
+          const auto result{
+              ::syscall(__NR_io_uring_enter, m_fd, count - submitted, count - completed, IORING_ENTER_GETEVENTS, nullptr, 0)};
+
+          if (result < 0)
+          {
+            if (errno == EINTR)
+            {
+              continue;
+            }
+
+            return false;
+          }
+
+          submitted += static_cast<unsigned>(result);
+
+          auto head{*m_cq_head};
+          const auto tail{std::atomic_ref{*m_cq_tail}.load(std::memory_order_acquire)};
+
+          for (; head != tail; ++head, ++completed)
+          {
+            const auto& cqe{m_cqes[head & m_cq_mask]};  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,performance-no-int-to-ptr)
+            reinterpret_cast<operation*>(cqe.user_data)->complete(cqe.res);
+          }
+
+          std::atomic_ref{*m_cq_head}.store(head, std::memory_order_release);
+        }
+
+        return true;
+      }
+
+      int m_fd;
+      unsigned m_entries;
+      std::size_t m_sq_ring_size;
+      std::size_t m_cq_ring_size;
+      std::size_t m_sqes_size;
+
+      void* m_sq_ring{MAP_FAILED};
+      void* m_cq_ring{MAP_FAILED};
+      void* m_sqes{MAP_FAILED};
+
+      unsigned* m_sq_tail{};
+      unsigned m_sq_mask{};
+      unsigned* m_sq_array{};
+      unsigned* m_cq_head{};
+      unsigned* m_cq_tail{};
+      unsigned m_cq_mask{};
+      ::io_uring_cqe* m_cqes{};
+    };
+
+    /**
+     * Aligned buffers for O_DIRECT, kept for reuse as a database uses the same page size for all writes.
+     */
+    class buffer_pool
+    {
+     public:
+      buffer_pool() = default;
+
+      ~buffer_pool()
+      {
+        for (auto& [size, buffers] : m_free)
+        {
+          for (auto* buffer : buffers)
+          {
+            std::free(buffer);  // NOLINT(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
+          }
+        }
+      }
+
+      buffer_pool(const buffer_pool&) = delete;
+      buffer_pool(buffer_pool&&) = delete;
+      auto operator=(const buffer_pool&) -> buffer_pool& = delete;
+      auto operator=(buffer_pool&&) -> buffer_pool& = delete;
+
+      [[nodiscard]] static auto instance() -> buffer_pool&
+      {
+        static buffer_pool pool;
+        return pool;
+      }
+
+      /**
+       * Returns a buffer aligned for O_DIRECT, \p size must be a multiple of direct_io_alignment.
+       *
+       * @throws std::bad_alloc if there is no memory
+       */
+      [[nodiscard]] auto acquire(std::size_t size) -> std::byte*
+      {
+        {
+          const std::lock_guard lock{m_mutex};
+
+          if (auto& buffers{m_free[size]}; !buffers.empty())
+          {
+            auto* const buffer{buffers.back()};
+            buffers.pop_back();
+            return buffer;
+          }
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
+        auto* const buffer{static_cast<std::byte*>(std::aligned_alloc(direct_io_alignment, size))};
+
+        if (buffer == nullptr)
+        {
+          throw std::bad_alloc{};
+        }
+
+        return buffer;
+      }
+
+      void release(std::byte* buffer, std::size_t size) noexcept
+      {
+        try
+        {
+          const std::lock_guard lock{m_mutex};
+
+          if (auto& buffers{m_free[size]}; buffers.size() < max_pooled_buffers)
+          {
+            buffers.push_back(buffer);
+            return;
+          }
+        }
+        catch (...)  // NOLINT(bugprone-empty-catch) the buffer is freed instead
+        {
+        }
+
+        std::free(buffer);  // NOLINT(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
+      }
+
+     private:
+      std::mutex m_mutex;
+      std::unordered_map<std::size_t, std::vector<std::byte*>> m_free;
+    };
+
+    /**
+     * Aligned buffer of the buffer_pool.
+     */
+    class aligned_buffer
+    {
+     public:
+      explicit aligned_buffer(std::size_t size)
+          : m_data(buffer_pool::instance().acquire(size)),
+            m_size(size)
+      {}
+
+      ~aligned_buffer()
+      {
+        if (m_data != nullptr)
+        {
+          buffer_pool::instance().release(m_data, m_size);
+        }
+      }
+
+      aligned_buffer(const aligned_buffer&) = delete;
+      auto operator=(const aligned_buffer&) -> aligned_buffer& = delete;
+
+      aligned_buffer(aligned_buffer&& other) noexcept
+          : m_data(std::exchange(other.m_data, nullptr)),
+            m_size(other.m_size)
+      {}
+
+      auto operator=(aligned_buffer&& other) noexcept -> aligned_buffer&
+      {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        return *this;
+      }
+
+      [[nodiscard]] auto data() const noexcept -> std::byte*
+      {
+        return m_data;
+      }
+
+     private:
+      std::byte* m_data;
+      std::size_t m_size;
+    };
+
+    /**
+     * Write that is not yet submitted, holds a copy of the data.
+     */
+    struct pending_write
+    {
+      std::uint64_t offset{};
+      std::size_t size{};
+      std::vector<std::byte> data;     ///< buffered I/O, contiguous writes are merged
+      std::optional<aligned_buffer> direct_data{};  ///< O_DIRECT
+
+      [[nodiscard]] auto bytes() noexcept -> std::byte*
+      {
+        return direct_data ? direct_data->data() : data.data();
+      }
+    };
+
+    struct file_state
+    {
+      ::sqlite3_file* real{};  ///< file of the unix VFS
+      int fd{-1};              ///< -1 if all I/O goes through the unix VFS
+      bool direct{false};
+      details::inode_registry::key inode{};
+      std::size_t max_batch_size{};
+      std::vector<pending_write> pending;
+      std::size_t pending_bytes{};
+      int deferred_error{SQLITE_OK};  ///< failed flush that could not be reported
+      details::vfs_file<file_state>* wal{};       ///< WAL of a main database file
+      details::vfs_file<file_state>* database{};  ///< main database file of a WAL
+    };
+
+    using vfs_registration = details::vfs_registration<io_uring_vfs_options>;
+
+    /**
+     * Runs the operations through the io_uring of the thread, or with pread() / pwrite() if there is none.
+     */
+    void run(std::span<operation> operations) noexcept
+    {
+      thread_local std::unique_ptr<ring> thread_ring;
+      thread_local bool ring_failed{false};
+
+      if (!thread_ring && !ring_failed)
+      {
+        unsigned queue_depth{};
+
+        {
+          auto& registration{details::get_registration<vfs_registration>()};
+          const std::lock_guard lock{registration.mutex};
+          queue_depth = registration.options.queue_depth;
+        }
+
+        thread_ring = ring::create(queue_depth);
+        ring_failed = !thread_ring;
+      }
+
+      if (thread_ring && !thread_ring->run(operations))
+      {
+        // unusable after a failed io_uring_enter(), the unfinished operations are completed without it
+        thread_ring.reset();
+        ring_failed = true;
+      }
+
+      run_synchronously(operations);
+    }
+
+    [[nodiscard]] auto to_write_error(int error) noexcept -> int
+    {
+      return ((error == ENOSPC) || (error == EDQUOT)) ? SQLITE_FULL : SQLITE_IOERR_WRITE;
+    }
+
+    [[nodiscard]] auto flush(file_state& file) noexcept -> int
+    {
+      if (file.pending.empty())
+      {
+        return std::exchange(file.deferred_error, SQLITE_OK);
+      }
+
+      int result{SQLITE_OK};
+
+      try
+      {
+        std::vector<operation> operations;
+        operations.reserve(file.pending.size());
+
+        for (auto& write : file.pending)
+        {
+          operations.push_back(
+              {.write = true, .fd = file.fd, .buffer = write.bytes(), .size = write.size, .offset = write.offset});
+        }
+
+        run(operations);
+
+        for (const auto& op : operations)
+        {
+          if (op.error != 0)
+          {
+            result = to_write_error(op.error);
+            break;
+          }
+        }
+      }
+      catch (...)
+      {
+        result = SQLITE_NOMEM;
+      }
+
+      file.pending.clear();
+      file.pending_bytes = 0;
+
+      return (result != SQLITE_OK) ? result : std::exchange(file.deferred_error, SQLITE_OK);
+    }
+
+    /**
+     * Flushes the WAL of a database file before the wal-index publishes its frames to other connections.
+     */
+    void flush_wal(file_state& file) noexcept
+    {
+      if (file.wal != nullptr)
+      {
+        auto& wal{*file.wal->state};
+
+        if (const auto result{flush(wal)}; result != SQLITE_OK)
+        {
+          wal.deferred_error = result;
+        }
+      }
+    }
+
+    [[nodiscard]] auto is_aligned(std::int64_t offset, std::size_t size) noexcept -> bool
+    {
+      return ((static_cast<std::uint64_t>(offset) % direct_io_alignment) == 0) && ((size % direct_io_alignment) == 0);
+    }
+
+    [[nodiscard]] auto is_aligned(const void* buffer) noexcept -> bool
+    {
+      return (reinterpret_cast<std::uintptr_t>(buffer) % direct_io_alignment) == 0;  // NOLINT
+    }
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // sqlite3_io_methods, see https://www.sqlite.org/c3ref/io_methods.html
+
+    auto file_close(::sqlite3_file* file) noexcept -> int
+    {
+      auto& wrapper{details::to_file<file_state>(file)};
+      const std::unique_ptr<file_state> state{wrapper.state};
+
+      const auto flush_result{flush(*state)};
+
+      if (state->wal != nullptr)
+      {
+        state->wal->state->database = nullptr;
+      }
+
+      if (state->database != nullptr)
+      {
+        state->database->state->wal = nullptr;
+      }
+
+      if (state->fd >= 0)
+      {
+        details::inode_registry::instance().release(state->inode);
+      }
+
+      const auto close_result{state->real->pMethods->xClose(state->real)};
+
+      wrapper.state = nullptr;
+
+      return (flush_result != SQLITE_OK) ? flush_result : close_result;
+    }
+
+    auto file_read(::sqlite3_file* file, void* buffer, int amount, ::sqlite3_int64 offset) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (const auto result{flush(state)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      const auto size{static_cast<std::size_t>(amount)};
+
+      if ((state.fd < 0) || (state.direct && !is_aligned(offset, size)))
+      {
+        return state.real->pMethods->xRead(state.real, buffer, amount, offset);
+      }
+
+      auto* const data{static_cast<std::byte*>(buffer)};
+      std::optional<aligned_buffer> bounce;
+
+      try
+      {
+        if (state.direct && !is_aligned(buffer))
+        {
+          // page buffers of SQLite are not aligned for O_DIRECT
+          bounce.emplace(size);
+        }
+      }
+      catch (...)
+      {
+        return SQLITE_IOERR_NOMEM;
+      }
+
+      operation op{.fd = state.fd, .buffer = bounce ? bounce->data() : data, .size = size,
+                   .offset = static_cast<std::uint64_t>(offset)};
+
+      run({&op, 1});
+
+      if (op.error != 0)
+      {
+        return SQLITE_IOERR_READ;
+      }
+
+      if (bounce)
+      {
+        std::memcpy(data, bounce->data(), op.done);
+      }
+
+      if (op.done < size)
+      {
+        // SQLite expects the rest of a short read to be zeroed
+        std::memset(data + op.done, 0, size - op.done);  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return SQLITE_IOERR_SHORT_READ;
+      }
+
+      return SQLITE_OK;
+    }
+
+    auto file_write(::sqlite3_file* file, const void* buffer, int amount, ::sqlite3_int64 offset) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (state.fd < 0)
+      {
+        return state.real->pMethods->xWrite(state.real, buffer, amount, offset);
+      }
+
+      const auto size{static_cast<std::size_t>(amount)};
+      const auto begin{static_cast<std::uint64_t>(offset)};
+      const auto* const data{static_cast<const std::byte*>(buffer)};
+
+      // operations of a batch run in any order, so overlapping writes must not be in the same batch
+      const auto overlaps{std::ranges::any_of(
+          state.pending, [begin, size](const pending_write& write)
+          { return (begin < (write.offset + write.size)) && (write.offset < (begin + size)); })};
+
+      const auto direct_write{state.direct && is_aligned(offset, size)};
+
+      if (overlaps || (state.direct && !direct_write))
+      {
+        if (const auto result{flush(state)}; result != SQLITE_OK)
+        {
+          return result;
+        }
+
+        if (!direct_write && state.direct)
+        {
+          return state.real->pMethods->xWrite(state.real, buffer, amount, offset);
+        }
+      }
+
+      try
+      {
+        if (direct_write)
+        {
+          aligned_buffer copy{size};
+          std::memcpy(copy.data(), data, size);
+          state.pending.push_back({.offset = begin, .size = size, .data = {}, .direct_data = std::move(copy)});
+        }
+        else if (!state.pending.empty() && (state.pending.back().offset + state.pending.back().size == begin))
+        {
+          auto& last{state.pending.back()};
+          last.data.insert(last.data.end(), data, data + size);  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+          last.size += size;
+        }
+        else
+        {
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+          state.pending.push_back({.offset = begin, .size = size, .data = {data, data + size}, .direct_data = {}});
+        }
+      }
+      catch (...)
+      {
+        return SQLITE_NOMEM;
+      }
+
+      state.pending_bytes += size;
+
+      if (state.pending_bytes >= state.max_batch_size)
+      {
+        return flush(state);
+      }
+
+      return SQLITE_OK;
+    }
+
+    auto file_truncate(::sqlite3_file* file, ::sqlite3_int64 size) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (const auto result{flush(state)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      return state.real->pMethods->xTruncate(state.real, size);
+    }
+
+    auto file_sync(::sqlite3_file* file, int flags) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (const auto result{flush(state)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      // fsync() of the unix VFS syncs the whole file incl. the writes through the other file descriptor
+      return state.real->pMethods->xSync(state.real, flags);
+    }
+
+    auto file_size(::sqlite3_file* file, ::sqlite3_int64* size) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (const auto result{flush(state)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      return state.real->pMethods->xFileSize(state.real, size);
+    }
+
+    auto file_lock(::sqlite3_file* file, int lock) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (const auto result{flush(state)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      return state.real->pMethods->xLock(state.real, lock);
+    }
+
+    auto file_unlock(::sqlite3_file* file, int lock) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (const auto result{flush(state)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      return state.real->pMethods->xUnlock(state.real, lock);
+    }
+
+    auto file_control(::sqlite3_file* file, int operation, void* argument) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (const auto result{flush(state)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      return state.real->pMethods->xFileControl(state.real, operation, argument);
+    }
+
+    auto file_shm_lock(::sqlite3_file* file, int offset, int count, int flags) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      flush_wal(state);
+
+      return state.real->pMethods->xShmLock(state.real, offset, count, flags);
+    }
+
+    void file_shm_barrier(::sqlite3_file* file) noexcept
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      // SQLite publishes a new wal-index header after this barrier
+      flush_wal(state);
+
+      state.real->pMethods->xShmBarrier(state.real);
+    }
+
+    auto file_fetch(::sqlite3_file* file, ::sqlite3_int64 offset, int amount, void** pointer) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (state.fd >= 0)
+      {
+        // no memory-mapped I/O, SQLite reads with xRead() instead
+        *pointer = nullptr;
+        return SQLITE_OK;
+      }
+
+      return state.real->pMethods->xFetch(state.real, offset, amount, pointer);
+    }
+
+    auto file_unfetch(::sqlite3_file* file, ::sqlite3_int64 offset, void* pointer) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      if (state.fd >= 0)
+      {
+        return SQLITE_OK;
+      }
+
+      return state.real->pMethods->xUnfetch(state.real, offset, pointer);
+    }
+
+    [[nodiscard]] auto make_io_methods() noexcept -> ::sqlite3_io_methods
+    {
+      // all other methods forward to the file of the unix VFS
+      auto methods{details::make_io_methods<file_state>()};
+
+      methods.xClose = &file_close;
+      methods.xRead = &file_read;
+      methods.xWrite = &file_write;
+      methods.xTruncate = &file_truncate;
+      methods.xSync = &file_sync;
+      methods.xFileSize = &file_size;
+      methods.xLock = &file_lock;
+      methods.xUnlock = &file_unlock;
+      methods.xFileControl = &file_control;
+      methods.xShmLock = &file_shm_lock;
+      methods.xShmBarrier = &file_shm_barrier;
+      methods.xFetch = &file_fetch;
+      methods.xUnfetch = &file_unfetch;
+
+      return methods;
+    }
+
+    const ::sqlite3_io_methods io_methods{make_io_methods()};
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // sqlite3_vfs, all methods but xOpen() are the ones of the unix VFS
+
+    auto vfs_open(::sqlite3_vfs* vfs, const char* name, ::sqlite3_file* file, int flags, int* out_flags) noexcept -> int
+    {
+      auto* const base_vfs{static_cast<::sqlite3_vfs*>(vfs->pAppData)};
+
+      int opened_flags{};
+
+      if (const auto result{details::open_real_file<file_state>(base_vfs, name, file, flags, &opened_flags)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      auto& wrapper{details::to_file<file_state>(file)};
+      auto* const real{details::to_real_file<file_state>(file)};
+
+      if (out_flags != nullptr)
+      {
+        *out_flags = opened_flags;
+      }
+
+      try
+      {
+        auto state{std::make_unique<file_state>()};
+        state->real = real;
+
+        constexpr int io_uring_files{SQLITE_OPEN_MAIN_DB | SQLITE_OPEN_MAIN_JOURNAL | SQLITE_OPEN_WAL};
+
+        if ((name != nullptr) && ((flags & io_uring_files) != 0))
+        {
+          io_uring_vfs_options options;
+
+          {
+            auto& registration{details::get_registration<vfs_registration>()};
+            const std::lock_guard lock{registration.mutex};
+            options = registration.options;
+          }
+
+          state->direct = options.direct_io && ((flags & SQLITE_OPEN_MAIN_DB) != 0);
+          state->max_batch_size = options.max_batch_size;
+          state->fd = details::inode_registry::instance().acquire(name, (opened_flags & SQLITE_OPEN_READONLY) == 0, state->direct,
+                                                         state->inode);
+
+          if (state->fd < 0)
+          {
+            real->pMethods->xClose(real);
+            return SQLITE_CANTOPEN;
+          }
+        }
+
+        if ((flags & SQLITE_OPEN_WAL) != 0)
+        {
+          auto* const database{::sqlite3_database_file_object(name)};
+
+          if ((database != nullptr) && (database->pMethods == &io_methods))
+          {
+            state->database = &details::to_file<file_state>(database);
+            state->database->state->wal = &wrapper;
+          }
+        }
+
+        wrapper.state = state.release();
+        wrapper.base.pMethods = &io_methods;
+      }
+      catch (...)
+      {
+        real->pMethods->xClose(real);
+        return SQLITE_NOMEM;
+      }
+
+      return SQLITE_OK;
+    }
+  }  // unnamed namespace
+
+  auto is_io_uring_supported() noexcept -> bool
+  {
+    return ring::create(1) != nullptr;
+  }
+
+  void register_io_uring_vfs(const io_uring_vfs_options& options, bool make_default, const std::source_location& loc)
+  {
+    if ((options.queue_depth == 0) || (options.queue_depth > max_queue_depth))
+    {
+      throw sqlite_error(
+          sqlite_wrapper::format("invalid io_uring_vfs_options, queue_depth must be from 1 to {}", max_queue_depth),
+          SQLITE_MISUSE, loc);
+    }
+
+    if (options.max_batch_size == 0)
+    {
+      throw sqlite_error("invalid io_uring_vfs_options, max_batch_size must be > 0", SQLITE_MISUSE, loc);
+    }
+
+    if (!is_io_uring_supported())
+    {
+      throw sqlite_error(sqlite_wrapper::format("io_uring is not supported, io_uring_setup() failed with: {}",
+                                                std::system_category().message(errno)),
+                         SQLITE_ERROR, loc);
+    }
+
+    auto& registration{details::get_registration<vfs_registration>()};
+    const std::lock_guard lock{registration.mutex};
+
+    registration.options = options;
+
+    if (registration.base == nullptr)
+    {
+      // the default VFS is the unix VFS unless some other VFS was made the default
+      registration.base = ::sqlite3_vfs_find(nullptr);
+
+      if (registration.base == nullptr)
+      {
+        throw sqlite_error("no default VFS to wrap found", SQLITE_ERROR, loc);
+      }
+
+      registration.vfs = details::make_vfs<file_state>(registration.base, io_uring_vfs_name, &vfs_open);
+    }
+
+    if (const auto result{::sqlite3_vfs_register(&registration.vfs, make_default ? 1 : 0)}; result != SQLITE_OK)
+    {
+      throw sqlite_error("sqlite3_vfs_register() failed to register the io_uring VFS", result, loc);
+    }
+  }
+#else
+  auto is_io_uring_supported() noexcept -> bool
+  {
+    return false;
+  }
+
+  void register_io_uring_vfs(const io_uring_vfs_options& /*options*/, bool /*make_default*/, const std::source_location& loc)
+  {
+    throw sqlite_error("io_uring is not supported, it is only available on Linux", SQLITE_ERROR, loc);
+  }
+#endif
+}  // namespace sqlite_wrapper
@@ -0,0 +1,76 @@
+#include "sqlite_wrapper/memory_database.h"
+
+#include "sqlite_wrapper/backup.h"
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_error.h"
+
+#include <sqlite3.h>
+
+#include <source_location>
+#include <string>
+#include <utility>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    auto to_memdb_uri(const std::string& name, bool shared, const std::source_location& loc) -> std::string
+    {
+      if (name.find_first_of("/?#") != std::string::npos)
+      {
+        throw sqlite_error(
+            sqlite_wrapper::format("invalid in-memory database name \"{}\", must not contain '/', '?' or '#'", name),
+            SQLITE_MISUSE, loc);
+      }
+
+      if (shared && name.empty())
+      {
+        throw sqlite_error("shared in-memory database needs a name", SQLITE_MISUSE, loc);
+      }
+
+      if (name.empty())
+      {
+        return ":memory:";
+      }
+
+      // the memdb VFS shares databases with names starting with '/' between all connections of the process
+      return sqlite_wrapper::format("file:{}{}?vfs=memdb", shared ? "/" : "", name);
+    }
+  }  // unnamed namespace
+
+  auto open_memory(const std::string& name, bool shared, open_options options, const std::source_location& loc) -> database
+  {
+    // an in-memory database has no file next to which the WAL could be kept
+    if (options.journal == journal_mode::wal)
+    {
+      throw sqlite_error("invalid open_options, in-memory databases do not support journal_mode::wal", SQLITE_MISUSE, loc);
+    }
+
+    options.flags = open_flags::open_or_create;
+    options.uri = true;
+
+    return open(to_memdb_uri(name, shared, loc), options, loc);
+  }
+
+  void copy_database(const db_with_location& source, const db_with_location& destination)
+  {
+    // copies all pages in one step, so the source is locked once for the whole copy
+    backup copy{source, destination, {.pages_per_step = -1}};
+
+    (void)copy.run({}, destination.location);
+  }
+
+  auto open_memory_from_file(const std::string& file_name, const std::string& name, bool shared, open_options options,
+                             const std::source_location& loc) -> database
+  {
+    const auto source{open(file_name, open_options{.flags = open_flags::open_only, .read_only = true}, loc)};
+
+    auto destination{open_memory(name, shared, std::move(options), loc)};
+
+    copy_database({source.get(), loc}, {destination.get(), loc});
+
+    return destination;
+  }
+}  // namespace sqlite_wrapper
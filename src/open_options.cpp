@@ -0,0 +1,281 @@
+#include "sqlite_wrapper/open_options.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    constexpr std::uint32_t min_page_size{512};
+    constexpr std::uint32_t max_page_size{65536};
+    constexpr int lookaside_slot_alignment{8};
+
+    [[noreturn]] void throw_invalid_option(std::string_view what, const std::source_location& loc)
+    {
+      throw sqlite_error(sqlite_wrapper::format("invalid open_options, {}", what), SQLITE_MISUSE, loc);
+    }
+
+    auto to_sqlite_flags(const open_options& options, const std::source_location& loc) -> int
+    {
+      int sqlite_flags{};
+
+      switch (options.flags)
+      {
+        case open_flags::open_or_create:
+          sqlite_flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+          break;
+        case open_flags::open_only:
+          sqlite_flags = options.read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE;
+          break;
+        default:
+          throw_invalid_option(sqlite_wrapper::format("invalid open_flags value \"{}\"", options.flags), loc);
+      }
+
+      sqlite_flags |= options.no_mutex ? SQLITE_OPEN_NOMUTEX : 0;
+      sqlite_flags |= options.uri ? SQLITE_OPEN_URI : 0;
+      sqlite_flags |= options.memory ? SQLITE_OPEN_MEMORY : 0;
+
+      return sqlite_flags;
+    }
+
+    /**
+     * Executes a PRAGMA and ignores the rows some of them return.
+     */
+    void execute_pragma(const db_with_location& database, const std::string& sql)
+    {
+      const auto stmt{create_prepared_statement(database, sql)};
+
+      while (step({stmt.get(), database.location}))
+      {
+      }
+    }
+
+    void apply_lookaside(const db_with_location& database, const lookaside_config& lookaside)
+    {
+      // SQLite allocates the memory itself if the buffer is nullptr
+      if (const auto result{
+              ::sqlite3_db_config(database.value, SQLITE_DBCONFIG_LOOKASIDE, nullptr, lookaside.slot_size, lookaside.slot_count)};
+          result != SQLITE_OK)
+      {
+        throw sqlite_error(sqlite_wrapper::format("failed to configure lookaside with {} slots of {} bytes",
+                                                  lookaside.slot_count, lookaside.slot_size),
+                           database, result);
+      }
+    }
+
+    void apply_journal_mode(const db_with_location& database, journal_mode mode)
+    {
+      // returns the new journal mode, which silently stays unchanged if the requested one is not supported
+      const auto [new_mode] =
+          execute_one_row<std::tuple<std::string>>(database, sqlite_wrapper::format("PRAGMA journal_mode = {}", mode));
+
+      if (new_mode != sqlite_wrapper::format("{}", mode))
+      {
+        throw sqlite_error(sqlite_wrapper::format("failed to set journal mode {}, journal mode is {}", mode, new_mode),
+                           SQLITE_ERROR, database.location);
+      }
+    }
+
+    void apply_busy_timeout(const db_with_location& database, std::chrono::milliseconds timeout)
+    {
+      const auto timeout_ms{
+          static_cast<int>(std::min<std::chrono::milliseconds::rep>(timeout.count(), std::numeric_limits<int>::max()))};
+
+      if (const auto result{::sqlite3_busy_timeout(database.value, timeout_ms)}; result != SQLITE_OK)
+      {
+        throw sqlite_error(sqlite_wrapper::format("failed to set busy timeout of {} ms", timeout_ms), database, result);
+      }
+    }
+
+    /**
+     * Returns a URI with the immutable parameter, '%', '?' and '#' in \p file_name are percent-encoded.
+     */
+    auto to_immutable_uri(const std::string& file_name) -> std::string
+    {
+      // an absolute path gets an empty authority, else it would be taken as authority if it starts with "//"
+      std::string uri{file_name.starts_with('/') ? "file://" : "file:"};
+
+      // only the unreserved characters of RFC 3986 and the path separator are kept
+      for (const auto character : file_name)
+      {
+        const auto is_alpha_numeric{((character >= 'A') && (character <= 'Z')) || ((character >= 'a') && (character <= 'z')) ||
+                                    ((character >= '0') && (character <= '9'))};
+
+        if (is_alpha_numeric || (character == '-') || (character == '.') || (character == '_') || (character == '~') ||
+            (character == '/'))
+        {
+          uri += character;
+        }
+        else
+        {
+          uri += sqlite_wrapper::format("%{:02X}", static_cast<unsigned char>(character));
+        }
+      }
+
+      uri += "?immutable=1";
+
+      return uri;
+    }
+  }  // unnamed namespace
+
+  void validate(const open_options& options, const std::source_location& loc)
+  {
+    (void)to_sqlite_flags(options, loc);
+
+    if (options.read_only && (options.flags != open_flags::open_only))
+    {
+      throw_invalid_option("read_only requires open_flags::open_only", loc);
+    }
+
+    if (options.read_only && (options.journal || options.page_size))
+    {
+      throw_invalid_option("journal mode and page size can not be changed on a read_only connection", loc);
+    }
+
+    if (options.memory && (options.journal == journal_mode::wal))
+    {
+      throw_invalid_option("in-memory databases do not support journal_mode::wal", loc);
+    }
+
+    if (options.journal && (to_underlying(*options.journal) > to_underlying(journal_mode::off)))
+    {
+      throw_invalid_option(sqlite_wrapper::format("unknown journal mode {}", to_underlying(*options.journal)), loc);
+    }
+
+    if (options.synchronous && (to_underlying(*options.synchronous) > to_underlying(synchronous_mode::extra)))
+    {
+      throw_invalid_option(sqlite_wrapper::format("unknown synchronous mode {}", to_underlying(*options.synchronous)), loc);
+    }
+
+    if (options.temp_store && (to_underlying(*options.temp_store) > to_underlying(temp_store_mode::memory)))
+    {
+      throw_invalid_option(sqlite_wrapper::format("unknown temp store mode {}", to_underlying(*options.temp_store)), loc);
+    }
+
+    if (options.mmap_size && (*options.mmap_size < 0))
+    {
+      throw_invalid_option(sqlite_wrapper::format("mmap_size {} must not be negative", *options.mmap_size), loc);
+    }
+
+    if (options.busy_timeout && (options.busy_timeout->count() < 0))
+    {
+      throw_invalid_option(sqlite_wrapper::format("busy_timeout {} ms must not be negative", options.busy_timeout->count()), loc);
+    }
+
+    if (options.page_size && (!std::has_single_bit(*options.page_size) || (*options.page_size < min_page_size) ||
+                              (*options.page_size > max_page_size)))
+    {
+      throw_invalid_option(
+          sqlite_wrapper::format("page_size {} must be a power of two from {} to {}", *options.page_size, min_page_size,
+                                 max_page_size),
+          loc);
+    }
+
+    if (options.lookaside && ((options.lookaside->slot_size < 0) || (options.lookaside->slot_count < 0) ||
+                              ((options.lookaside->slot_size % lookaside_slot_alignment) != 0)))
+    {
+      throw_invalid_option(sqlite_wrapper::format("lookaside slot size {} must be a multiple of {} and slot count {} must not "
+                                                  "be negative",
+                                                  options.lookaside->slot_size, lookaside_slot_alignment,
+                                                  options.lookaside->slot_count),
+                           loc);
+    }
+
+    if (!options.vfs.empty() && (::sqlite3_vfs_find(options.vfs.c_str()) == nullptr))
+    {
+      throw_invalid_option(sqlite_wrapper::format("VFS \"{}\" is not registered", options.vfs), loc);
+    }
+  }
+
+  auto open(const std::string& file_name, const open_options& options, const std::source_location& loc) -> database
+  {
+    validate(options, loc);
+
+    // an exception closes the database again, so either all options are applied or none
+    auto database{details::open(file_name, to_sqlite_flags(options, loc), options.vfs, loc)};
+    const db_with_location db_loc{database.get(), loc};
+
+    // lookaside must be configured before the connection allocates memory, page_size before switching to WAL mode
+    if (options.lookaside)
+    {
+      apply_lookaside(db_loc, *options.lookaside);
+    }
+
+    if (options.busy_timeout)
+    {
+      apply_busy_timeout(db_loc, *options.busy_timeout);
+    }
+
+    if (options.page_size)
+    {
+      execute_pragma(db_loc, sqlite_wrapper::format("PRAGMA page_size = {}", *options.page_size));
+    }
+
+    if (options.journal)
+    {
+      apply_journal_mode(db_loc, *options.journal);
+    }
+
+    if (options.synchronous)
+    {
+      execute_pragma(db_loc, sqlite_wrapper::format("PRAGMA synchronous = {}", to_underlying(*options.synchronous)));
+    }
+
+    if (options.cache_size)
+    {
+      execute_pragma(db_loc, sqlite_wrapper::format("PRAGMA cache_size = {}", *options.cache_size));
+    }
+
+    if (options.mmap_size)
+    {
+      execute_pragma(db_loc, sqlite_wrapper::format("PRAGMA mmap_size = {}", *options.mmap_size));
+    }
+
+    if (options.temp_store)
+    {
+      execute_pragma(db_loc, sqlite_wrapper::format("PRAGMA temp_store = {}", to_underlying(*options.temp_store)));
+    }
+
+    return database;
+  }
+
+  auto open_immutable(const std::string& file_name, open_options options, const std::source_location& loc) -> database
+  {
+    options.flags = open_flags::open_only;
+    options.read_only = true;
+    options.uri = true;
+
+    if (!options.mmap_size)
+    {
+      std::error_code error{};
+      const auto file_size{std::filesystem::file_size(file_name, error)};
+
+      if (error)
+      {
+        throw sqlite_error(sqlite_wrapper::format("failed to get size of database file \"{}\": {}", file_name, error.message()),
+                           SQLITE_CANTOPEN, loc);
+      }
+
+      options.mmap_size = static_cast<std::int64_t>(file_size);
+    }
+
+    return open(to_immutable_uri(file_name), options, loc);
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,835 @@
+#include "sqlite_wrapper/page_cache.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <sqlite3.h>
+
+#ifdef __linux__
+#  include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <source_location>
+#include <vector>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    enum class entry_state : unsigned char
+    {
+      free,
+      pinned,
+      unpinned
+    };
+
+    /**
+     * Precedes the page and the extra bytes of SQLite in a slab.
+     */
+    struct entry
+    {
+      ::sqlite3_pcache_page page;  ///< must be the first member, SQLite only knows this part
+      unsigned key;
+      entry_state state;
+      entry* newer;  ///< in least recently used order while unpinned
+      entry* older;  ///< in least recently used order while unpinned, next free entry while free
+    };
+
+    constexpr std::size_t entry_alignment{16};
+    constexpr std::size_t entry_header_size{(sizeof(entry) + entry_alignment - 1) & ~(entry_alignment - 1)};
+
+    [[nodiscard]] constexpr auto round_up(std::size_t size, std::size_t alignment) noexcept -> std::size_t
+    {
+      return ((size + alignment - 1) / alignment) * alignment;
+    }
+
+    [[nodiscard]] auto to_entry(::sqlite3_pcache_page* page) noexcept -> entry*
+    {
+      return reinterpret_cast<entry*>(page);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    /**
+     * Open-addressing hash table of the pages of a page cache with linear probing, the page numbers are spread by
+     * Fibonacci hashing.
+     */
+    class page_hash
+    {
+     public:
+      [[nodiscard]] auto size() const noexcept -> std::size_t
+      {
+        return m_size;
+      }
+
+      [[nodiscard]] auto find(unsigned key) const noexcept -> entry*
+      {
+        if (m_size == 0)
+        {
+          return nullptr;
+        }
+
+        for (auto slot{home_slot(key)};; slot = next_slot(slot))
+        {
+          auto* const current{m_slots[slot]};  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+
+          if ((current == nullptr) || (current->key == key))
+          {
+            return current;
+          }
+        }
+      }
+
+      /**
+       * Grows the table so that one more entry can be inserted without exceeding a load factor of 0.5 .
+       *
+       * @throws std::bad_alloc
+       */
+      void reserve_one()
+      {
+        if ((m_size + 1) * 2 <= m_slots.size())
+        {
+          return;
+        }
+
+        std::vector<entry*> slots(std::max<std::size_t>(min_capacity, m_slots.size() * 2));
+
+        std::swap(m_slots, slots);
+        m_shift = 64 - static_cast<unsigned>(std::countr_zero(m_slots.size()));
+        m_size = 0;
+
+        for (auto* const current : slots)
+        {
+          if (current != nullptr)
+          {
+            insert(current);
+          }
+        }
+      }
+
+      /**
+       * Inserts an entry whose key is not in the table, reserve_one() must be called before.
+       */
+      void insert(entry* new_entry) noexcept
+      {
+        auto slot{home_slot(new_entry->key)};
+
+        while (m_slots[slot] != nullptr)  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        {
+          slot = next_slot(slot);
+        }
+
+        m_slots[slot] = new_entry;  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        ++m_size;
+      }
+
+      void erase(unsigned key) noexcept
+      {
+        if (m_size == 0)
+        {
+          return;
+        }
+
+        auto slot{home_slot(key)};
+
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
+        for (; m_slots[slot] != nullptr; slot = next_slot(slot))
+        {
+          if (m_slots[slot]->key == key)
+          {
+            break;
+          }
+        }
+
+        if (m_slots[slot] == nullptr)
+        {
+          return;
+        }
+
+        // moves the following entries of the cluster back unless their home slot is between the gap and them
+        for (auto next{next_slot(slot)}; m_slots[next] != nullptr; next = next_slot(next))
+        {
+          const auto home{home_slot(m_slots[next]->key)};
+          const auto stays{(slot <= next) ? ((slot < home) && (home <= next)) : ((slot < home) || (home <= next))};
+
+          if (!stays)
+          {
+            m_slots[slot] = m_slots[next];
+            slot = next;
+          }
+        }
+
+        m_slots[slot] = nullptr;
+        // NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+
+        --m_size;
+      }
+
+      void clear() noexcept
+      {
+        std::ranges::fill(m_slots, nullptr);
+        m_size = 0;
+      }
+
+     private:
+      static constexpr std::size_t min_capacity{256};
+      static constexpr std::uint64_t fibonacci_multiplier{0x9E3779B97F4A7C15ULL};
+
+      [[nodiscard]] auto home_slot(unsigned key) const noexcept -> std::size_t
+      {
+        return static_cast<std::size_t>((key * fibonacci_multiplier) >> m_shift);
+      }
+
+      [[nodiscard]] auto next_slot(std::size_t slot) const noexcept -> std::size_t
+      {
+        return (slot + 1) & (m_slots.size() - 1);
+      }
+
+      std::vector<entry*> m_slots;
+      std::size_t m_size{0};
+      unsigned m_shift{64};
+    };
+
+    enum class slab_backing : unsigned char
+    {
+      heap,
+      mapped,
+      huge_pages
+    };
+
+    struct slab
+    {
+      std::byte* memory;
+      std::size_t size;
+      slab_backing backing;
+      std::size_t capacity;  ///< entries that fit into the slab
+      std::size_t carved;    ///< entries handed out from the start of the slab
+    };
+
+    struct page_cache
+    {
+      std::size_t page_size{};
+      std::size_t extra_size{};
+      std::size_t entry_size{};
+      bool purgeable{};
+
+      std::size_t max_pages{};  ///< cache size of the connection, only used if purgeable
+      std::size_t pinned{};
+
+      std::vector<slab> slabs;
+      entry* free_entries{};
+      entry* newest{};  ///< most recently unpinned entry
+      entry* oldest{};  ///< least recently unpinned entry, reused first
+      page_hash pages;
+    };
+
+    struct atomic_metrics
+    {
+      std::atomic<std::uint64_t> fetches;
+      std::atomic<std::uint64_t> hits;
+      std::atomic<std::uint64_t> creations;
+      std::atomic<std::uint64_t> evictions;
+      std::atomic<std::uint64_t> slabs;
+      std::atomic<std::uint64_t> huge_page_slabs;
+      std::atomic<std::uint64_t> over_budget_slabs;
+      std::atomic<std::int64_t> bytes_reserved;
+    };
+
+    atomic_metrics metrics{};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+    page_cache_options configured_options{};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // slabs
+
+#ifdef __linux__
+    constexpr std::size_t huge_page_size{2ULL * 1024 * 1024};
+
+    [[nodiscard]] auto map(std::size_t size, int flags) noexcept -> std::byte*
+    {
+      auto* const memory{::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0)};
+
+      return (memory != MAP_FAILED) ? static_cast<std::byte*>(memory) : nullptr;
+    }
+
+    /**
+     * Maps memory aligned to a huge page, so the kernel can back all of it with transparent huge pages.
+     */
+    [[nodiscard]] auto map_transparent(std::size_t size) noexcept -> std::byte*
+    {
+      if (size < huge_page_size)
+      {
+        return map(size, 0);
+      }
+
+      auto* const memory{map(size + huge_page_size, 0)};
+
+      if (memory == nullptr)
+      {
+        return nullptr;
+      }
+
+      const auto address{reinterpret_cast<std::uintptr_t>(memory)};  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+      const auto head{round_up(address, huge_page_size) - address};
+
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      if (head > 0)
+      {
+        (void)::munmap(memory, head);
+      }
+
+      if (head < huge_page_size)
+      {
+        (void)::munmap(memory + head + size, huge_page_size - head);
+      }
+
+      // only a hint, without transparent huge pages enabled the slab keeps normal pages
+      (void)::madvise(memory + head, size, MADV_HUGEPAGE);
+
+      return memory + head;
+      // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+#endif
+
+    [[nodiscard]] auto allocate_slab(std::size_t size) noexcept -> slab
+    {
+#ifdef __linux__
+      // smaller slabs are not worth a huge page
+      if ((configured_options.huge_pages == huge_pages::explicit_first) && ((size % huge_page_size) == 0))
+      {
+        // fails if the hugetlbfs pool has not enough free pages or size is no multiple of its page size
+        if (auto* const memory{map(size, MAP_HUGETLB)}; memory != nullptr)
+        {
+          return {memory, size, slab_backing::huge_pages, 0, 0};
+        }
+      }
+
+      auto* const memory{(configured_options.huge_pages == huge_pages::none) ? map(size, 0) : map_transparent(size)};
+
+      return {memory, size, slab_backing::mapped, 0, 0};
+#else
+      auto* const memory{
+          static_cast<std::byte*>(::operator new(size, std::align_val_t{page_cache_options::slab_alignment}, std::nothrow))};
+
+      return {memory, size, slab_backing::heap, 0, 0};
+#endif
+    }
+
+    void free_slab(const slab& freed) noexcept
+    {
+#ifdef __linux__
+      (void)::munmap(freed.memory, freed.size);
+#else
+      ::operator delete(freed.memory, std::align_val_t{page_cache_options::slab_alignment});
+#endif
+
+      metrics.bytes_reserved.fetch_sub(static_cast<std::int64_t>(freed.size), std::memory_order_relaxed);
+    }
+
+    /**
+     * Reserves the bytes of a slab in the budget, beyond it only if \p force is true.
+     */
+    [[nodiscard]] auto reserve(std::size_t size, bool force) noexcept -> bool
+    {
+      const auto budget{static_cast<std::int64_t>(configured_options.budget)};
+      const auto bytes{static_cast<std::int64_t>(size)};
+
+      auto reserved{metrics.bytes_reserved.load(std::memory_order_relaxed)};
+
+      do
+      {
+        if (!force && (reserved + bytes > budget))
+        {
+          return false;
+        }
+      } while (!metrics.bytes_reserved.compare_exchange_weak(reserved, reserved + bytes, std::memory_order_relaxed));
+
+      if (reserved + bytes > budget)
+      {
+        metrics.over_budget_slabs.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      return true;
+    }
+
+    /**
+     * Returns the size of the next slab of \p cache. The first slab holds slab_alignment bytes and every further one twice
+     * as many up to slab_size, so small page caches and those of in-memory and temporary databases stay small.
+     */
+    [[nodiscard]] auto next_slab_size(const page_cache& cache) noexcept -> std::size_t
+    {
+      const auto size{cache.slabs.empty() ? page_cache_options::slab_alignment
+                                          : std::min(cache.slabs.back().size * 2, configured_options.slab_size)};
+
+      return round_up(std::max(size, cache.entry_size), page_cache_options::slab_alignment);
+    }
+
+    /**
+     * Returns the next entry of the last slab, allocates a new slab if the last one is used up.
+     */
+    [[nodiscard]] auto carve_entry(page_cache& cache, bool force) noexcept -> entry*
+    {
+      if (cache.slabs.empty() || (cache.slabs.back().carved == cache.slabs.back().capacity))
+      {
+        try
+        {
+          cache.slabs.reserve(cache.slabs.size() + 1);
+        }
+        catch (...)
+        {
+          return nullptr;
+        }
+
+        const auto slab_size{next_slab_size(cache)};
+
+        if (!reserve(slab_size, force))
+        {
+          return nullptr;
+        }
+
+        auto new_slab{allocate_slab(slab_size)};
+
+        if (new_slab.memory == nullptr)
+        {
+          metrics.bytes_reserved.fetch_sub(static_cast<std::int64_t>(slab_size), std::memory_order_relaxed);
+          return nullptr;
+        }
+
+        new_slab.capacity = slab_size / cache.entry_size;
+
+        metrics.slabs.fetch_add(1, std::memory_order_relaxed);
+
+        if (new_slab.backing == slab_backing::huge_pages)
+        {
+          metrics.huge_page_slabs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        cache.slabs.push_back(new_slab);
+      }
+
+      auto& current{cache.slabs.back()};
+
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      auto* const memory{current.memory + (current.carved * cache.entry_size)};
+      auto* const new_entry{::new (memory) entry{}};
+
+      new_entry->page.pBuf = memory + entry_header_size;
+      new_entry->page.pExtra = memory + entry_header_size + cache.page_size;
+      // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+      ++current.carved;
+
+      return new_entry;
+    }
+
+    void release_slabs(page_cache& cache) noexcept
+    {
+      std::ranges::for_each(cache.slabs, free_slab);
+
+      cache.slabs.clear();
+      cache.free_entries = nullptr;
+      cache.newest = nullptr;
+      cache.oldest = nullptr;
+      cache.pages.clear();
+      cache.pinned = 0;
+    }
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // entries
+
+    void push_free(page_cache& cache, entry* freed) noexcept
+    {
+      freed->state = entry_state::free;
+      freed->older = cache.free_entries;
+      cache.free_entries = freed;
+    }
+
+    void push_newest(page_cache& cache, entry* unpinned) noexcept
+    {
+      unpinned->state = entry_state::unpinned;
+      unpinned->newer = nullptr;
+      unpinned->older = cache.newest;
+
+      if (cache.newest != nullptr)
+      {
+        cache.newest->newer = unpinned;
+      }
+      else
+      {
+        cache.oldest = unpinned;
+      }
+
+      cache.newest = unpinned;
+    }
+
+    void remove_unpinned(page_cache& cache, entry* unpinned) noexcept
+    {
+      (unpinned->newer != nullptr ? unpinned->newer->older : cache.newest) = unpinned->older;
+      (unpinned->older != nullptr ? unpinned->older->newer : cache.oldest) = unpinned->newer;
+    }
+
+    /**
+     * Removes an entry from the cache, regardless of being pinned, and puts it onto the free list.
+     */
+    void discard(page_cache& cache, entry* discarded) noexcept
+    {
+      if (discarded->state == entry_state::unpinned)
+      {
+        remove_unpinned(cache, discarded);
+      }
+      else
+      {
+        --cache.pinned;
+      }
+
+      cache.pages.erase(discarded->key);
+      push_free(cache, discarded);
+    }
+
+    [[nodiscard]] auto evict_oldest(page_cache& cache) noexcept -> entry*
+    {
+      auto* const evicted{cache.oldest};
+
+      remove_unpinned(cache, evicted);
+      cache.pages.erase(evicted->key);
+
+      metrics.evictions.fetch_add(1, std::memory_order_relaxed);
+
+      return evicted;
+    }
+
+    void discard_excess_pages(page_cache& cache) noexcept
+    {
+      while (cache.purgeable && (cache.pages.size() > cache.max_pages) && (cache.oldest != nullptr))
+      {
+        push_free(cache, evict_oldest(cache));
+      }
+    }
+
+    /**
+     * Returns an entry for a new page, \p force is true if SQLite can not proceed without it.
+     */
+    [[nodiscard]] auto take_entry(page_cache& cache, bool force) noexcept -> entry*
+    {
+      if (cache.purgeable && (cache.pages.size() >= cache.max_pages) && (cache.oldest != nullptr))
+      {
+        return evict_oldest(cache);
+      }
+
+      if (auto* const freed{cache.free_entries}; freed != nullptr)
+      {
+        cache.free_entries = freed->older;
+        return freed;
+      }
+
+      if (auto* const carved{carve_entry(cache, false)}; carved != nullptr)
+      {
+        return carved;
+      }
+
+      // the budget of all page caches is used up, the pages of in-memory and temporary databases are their only copy
+      if (!cache.purgeable)
+      {
+        return carve_entry(cache, true);
+      }
+
+      if (cache.oldest != nullptr)
+      {
+        return evict_oldest(cache);
+      }
+
+      return force ? carve_entry(cache, true) : nullptr;
+    }
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // sqlite3_pcache_methods2, see https://www.sqlite.org/c3ref/pcache_methods2.html
+
+    [[nodiscard]] auto to_cache(::sqlite3_pcache* cache) noexcept -> page_cache&
+    {
+      return *reinterpret_cast<page_cache*>(cache);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    auto cache_init(void* /*data*/) noexcept -> int
+    {
+      return SQLITE_OK;
+    }
+
+    void cache_shutdown(void* /*data*/) noexcept
+    {
+    }
+
+    auto cache_create(int page_size, int extra_size, int purgeable) noexcept -> ::sqlite3_pcache*
+    {
+      auto* const cache{new (std::nothrow) page_cache{}};
+
+      if (cache == nullptr)
+      {
+        return nullptr;
+      }
+
+      cache->page_size = static_cast<std::size_t>(page_size);
+      cache->extra_size = static_cast<std::size_t>(extra_size);
+      cache->entry_size = round_up(entry_header_size + cache->page_size + cache->extra_size, entry_alignment);
+      cache->purgeable = (purgeable != 0);
+
+      return reinterpret_cast<::sqlite3_pcache*>(cache);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    void cache_cachesize(::sqlite3_pcache* cache, int max_pages) noexcept
+    {
+      auto& current{to_cache(cache)};
+
+      current.max_pages = static_cast<std::size_t>(std::max(max_pages, 1));
+      discard_excess_pages(current);
+    }
+
+    auto cache_pagecount(::sqlite3_pcache* cache) noexcept -> int
+    {
+      return static_cast<int>(to_cache(cache).pages.size());
+    }
+
+    auto cache_fetch(::sqlite3_pcache* cache, unsigned key, int create) noexcept -> ::sqlite3_pcache_page*
+    {
+      auto& current{to_cache(cache)};
+
+      metrics.fetches.fetch_add(1, std::memory_order_relaxed);
+
+      if (auto* const found{current.pages.find(key)}; found != nullptr)
+      {
+        metrics.hits.fetch_add(1, std::memory_order_relaxed);
+
+        if (found->state == entry_state::unpinned)
+        {
+          remove_unpinned(current, found);
+          found->state = entry_state::pinned;
+          ++current.pinned;
+        }
+
+        return &found->page;
+      }
+
+      // 1 asks for a page only if it is easy, SQLite spills dirty pages first if there is none, 2 asks for it regardless
+      if ((create == 0) ||
+          ((create == 1) && current.purgeable && (current.pinned >= current.max_pages - (current.max_pages / 10))))
+      {
+        return nullptr;
+      }
+
+      try
+      {
+        current.pages.reserve_one();
+      }
+      catch (...)
+      {
+        return nullptr;
+      }
+
+      auto* const created{take_entry(current, create == 2)};
+
+      if (created == nullptr)
+      {
+        return nullptr;
+      }
+
+      created->key = key;
+      created->state = entry_state::pinned;
+      ++current.pinned;
+
+      // SQLite expects the extra bytes of a new page to be zero
+      std::memset(created->page.pExtra, 0, current.extra_size);
+
+      current.pages.insert(created);
+
+      metrics.creations.fetch_add(1, std::memory_order_relaxed);
+
+      return &created->page;
+    }
+
+    void cache_unpin(::sqlite3_pcache* cache, ::sqlite3_pcache_page* page, int discard_page) noexcept
+    {
+      auto& current{to_cache(cache)};
+      auto* const unpinned{to_entry(page)};
+
+      if ((discard_page != 0) || (current.purgeable && (current.pages.size() > current.max_pages)))
+      {
+        discard(current, unpinned);
+        return;
+      }
+
+      --current.pinned;
+      push_newest(current, unpinned);
+    }
+
+    void cache_rekey(::sqlite3_pcache* cache, ::sqlite3_pcache_page* page, unsigned old_key, unsigned new_key) noexcept
+    {
+      auto& current{to_cache(cache)};
+      auto* const rekeyed{to_entry(page)};
+
+      // SQLite guarantees that a page with the new key is not pinned
+      if (auto* const replaced{current.pages.find(new_key)}; replaced != nullptr)
+      {
+        discard(current, replaced);
+      }
+
+      current.pages.erase(old_key);
+      rekeyed->key = new_key;
+      current.pages.insert(rekeyed);
+    }
+
+    void cache_truncate(::sqlite3_pcache* cache, unsigned limit) noexcept
+    {
+      auto& current{to_cache(cache)};
+
+      for (const auto& current_slab : current.slabs)
+      {
+        for (std::size_t index{0}; index < current_slab.carved; ++index)
+        {
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+          auto* const truncated{std::launder(reinterpret_cast<entry*>(current_slab.memory + (index * current.entry_size)))};
+
+          // pinned pages are implicitly unpinned
+          if ((truncated->state != entry_state::free) && (truncated->key >= limit))
+          {
+            discard(current, truncated);
+          }
+        }
+      }
+    }
+
+    void cache_destroy(::sqlite3_pcache* cache) noexcept
+    {
+      auto* const destroyed{&to_cache(cache)};
+
+      release_slabs(*destroyed);
+
+      delete destroyed;  // NOLINT(cppcoreguidelines-owning-memory)
+    }
+
+    void cache_shrink(::sqlite3_pcache* cache) noexcept
+    {
+      auto& current{to_cache(cache)};
+
+      // unpinned pages of in-memory and temporary databases are still their content
+      if (!current.purgeable)
+      {
+        return;
+      }
+
+      while (current.oldest != nullptr)
+      {
+        auto* const oldest{current.oldest};
+
+        remove_unpinned(current, oldest);
+        current.pages.erase(oldest->key);
+        push_free(current, oldest);
+      }
+
+      if (current.pages.size() == 0)
+      {
+        release_slabs(current);
+      }
+    }
+
+    const ::sqlite3_pcache_methods2 slab_methods{1,
+                                                 nullptr,
+                                                 &cache_init,
+                                                 &cache_shutdown,
+                                                 &cache_create,
+                                                 &cache_cachesize,
+                                                 &cache_pagecount,
+                                                 &cache_fetch,
+                                                 &cache_unpin,
+                                                 &cache_rekey,
+                                                 &cache_truncate,
+                                                 &cache_destroy,
+                                                 &cache_shrink};
+  }  // unnamed namespace
+
+  void configure_page_cache(const page_cache_options& options, const std::source_location& loc)
+  {
+    if (to_underlying(options.kind) > to_underlying(page_cache_kind::slabs))
+    {
+      throw sqlite_error(
+          sqlite_wrapper::format("invalid page_cache_options, unknown page cache kind {}", to_underlying(options.kind)),
+          SQLITE_MISUSE, loc);
+    }
+
+    if (to_underlying(options.huge_pages) > to_underlying(huge_pages::explicit_first))
+    {
+      throw sqlite_error(
+          sqlite_wrapper::format("invalid page_cache_options, unknown huge pages {}", to_underlying(options.huge_pages)),
+          SQLITE_MISUSE, loc);
+    }
+
+    if (options.budget == 0)
+    {
+      throw sqlite_error("invalid page_cache_options, budget must be > 0", SQLITE_MISUSE, loc);
+    }
+
+    if ((options.slab_size == 0) || ((options.slab_size % page_cache_options::slab_alignment) != 0))
+    {
+      throw sqlite_error(sqlite_wrapper::format("invalid page_cache_options, slab_size {} must be a multiple of {} and > 0",
+                                                options.slab_size, page_cache_options::slab_alignment),
+                         SQLITE_MISUSE, loc);
+    }
+
+    static std::mutex mutex;
+    static ::sqlite3_pcache_methods2 sqlite_methods{};
+    static bool sqlite_methods_saved{false};
+
+    const std::lock_guard lock{mutex};
+
+    // fails once SQLite is initialized, so nothing is changed while page caches exist
+    ::sqlite3_pcache_methods2 current_methods{};
+
+    if (const auto result{::sqlite3_config(SQLITE_CONFIG_GETPCACHE2, &current_methods)}; result != SQLITE_OK)
+    {
+      throw sqlite_error("configure_page_cache() must be called before SQLite is initialized", result, loc);
+    }
+
+    if (!sqlite_methods_saved)
+    {
+      sqlite_methods = current_methods;
+      sqlite_methods_saved = true;
+    }
+
+    configured_options = options;
+
+    const auto* const methods{(options.kind == page_cache_kind::slabs) ? &slab_methods : &sqlite_methods};
+
+    if (const auto result{::sqlite3_config(SQLITE_CONFIG_PCACHE2, methods)}; result != SQLITE_OK)
+    {
+      throw sqlite_error("sqlite3_config() failed to configure the page cache", result, loc);
+    }
+  }
+
+  auto get_page_cache_metrics() noexcept -> page_cache_metrics
+  {
+    return {.fetches = metrics.fetches.load(std::memory_order_relaxed),
+            .hits = metrics.hits.load(std::memory_order_relaxed),
+            .creations = metrics.creations.load(std::memory_order_relaxed),
+            .evictions = metrics.evictions.load(std::memory_order_relaxed),
+            .slabs = metrics.slabs.load(std::memory_order_relaxed),
+            .huge_page_slabs = metrics.huge_page_slabs.load(std::memory_order_relaxed),
+            .over_budget_slabs = metrics.over_budget_slabs.load(std::memory_order_relaxed),
+            .bytes_reserved = metrics.bytes_reserved.load(std::memory_order_relaxed)};
+  }
+
+  void reset_page_cache_metrics() noexcept
+  {
+    metrics.fetches.store(0, std::memory_order_relaxed);
+    metrics.hits.store(0, std::memory_order_relaxed);
+    metrics.creations.store(0, std::memory_order_relaxed);
+    metrics.evictions.store(0, std::memory_order_relaxed);
+    metrics.slabs.store(0, std::memory_order_relaxed);
+    metrics.huge_page_slabs.store(0, std::memory_order_relaxed);
+    metrics.over_budget_slabs.store(0, std::memory_order_relaxed);
+  }
+}  // namespace sqlite_wrapper
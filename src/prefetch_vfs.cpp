@@ -0,0 +1,296 @@
+#include "sqlite_wrapper/prefetch_vfs.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/io_uring_vfs.h"
+#include "sqlite_wrapper/sqlite_error.h"
+
+#include "inode_registry.h"
+#include "vfs_shim.h"
+
+#include <sqlite3.h>
+
+#ifdef __linux__
+#  include <fcntl.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <source_location>
+#include <string_view>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    struct file_state
+    {
+      ::sqlite3_file* real{};  ///< file of the wrapped VFS
+      int fd{-1};              ///< -1 if nothing is prefetched
+#ifdef __linux__
+      details::inode_registry::key inode{};
+#endif
+      prefetch_vfs_options options{};
+
+      std::uint64_t last_begin{};  ///< offset of the last read
+      std::uint64_t last_end{};    ///< end of the last read
+      unsigned forward_reads{};    ///< forward reads in a row
+      std::size_t window{};
+      std::uint64_t prefetched_begin{};
+      std::uint64_t prefetched_end{};
+    };
+
+    using vfs_registration = details::vfs_registration<prefetch_vfs_options>;
+
+    struct atomic_metrics
+    {
+      std::atomic<std::uint64_t> reads;
+      std::atomic<std::uint64_t> sequential_reads;
+      std::atomic<std::uint64_t> prefetches;
+      std::atomic<std::uint64_t> prefetched_bytes;
+      std::atomic<std::uint64_t> hits;
+      std::atomic<std::uint64_t> misses;
+    };
+
+    atomic_metrics metrics{};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+    void prefetch(file_state& file, std::uint64_t begin, std::uint64_t end) noexcept
+    {
+#ifdef __linux__
+      // starts an asynchronous read into the page cache, errors only mean there is nothing prefetched
+      (void)::posix_fadvise(file.fd, static_cast<::off_t>(begin), static_cast<::off_t>(end - begin), POSIX_FADV_WILLNEED);
+#endif
+
+      metrics.prefetches.fetch_add(1, std::memory_order_relaxed);
+      metrics.prefetched_bytes.fetch_add(end - begin, std::memory_order_relaxed);
+
+      // a window that continues the previous one extends it
+      if (begin != file.prefetched_end)
+      {
+        file.prefetched_begin = begin;
+      }
+
+      file.prefetched_end = end;
+    }
+
+    /**
+     * Counts a read of the database file and prefetches the next window if it continues a forward scan.
+     */
+    void observe_read(file_state& file, std::int64_t offset, int amount) noexcept
+    {
+      const auto begin{static_cast<std::uint64_t>(offset)};
+      const auto end{begin + static_cast<std::uint64_t>(amount)};
+
+      metrics.reads.fetch_add(1, std::memory_order_relaxed);
+
+      if ((begin >= file.prefetched_begin) && (end <= file.prefetched_end))
+      {
+        metrics.hits.fetch_add(1, std::memory_order_relaxed);
+      }
+      else
+      {
+        metrics.misses.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      // scans of b-trees skip the interior pages in between, so forward reads within the window still count
+      const auto forward{(file.last_end > 0) && (begin >= file.last_begin) &&
+                         (begin <= file.last_end + std::max<std::uint64_t>(file.window, file.options.min_window))};
+
+      file.last_begin = begin;
+      file.last_end = end;
+
+      if (!forward)
+      {
+        // a new scan may start below the windows of the last one, it must not wait until it passes them
+        file.forward_reads = 0;
+        file.window = file.options.min_window;
+        file.prefetched_begin = 0;
+        file.prefetched_end = 0;
+        return;
+      }
+
+      metrics.sequential_reads.fetch_add(1, std::memory_order_relaxed);
+
+      if ((file.fd < 0) || (++file.forward_reads < file.options.trigger_reads))
+      {
+        return;
+      }
+
+      // the next window is requested when the scan consumed half of the current one
+      if (end + (file.window / 2) > file.prefetched_end)
+      {
+        prefetch(file, std::max(end, file.prefetched_end), end + file.window);
+
+        file.window = std::min(file.window * 2, file.options.max_window);
+      }
+    }
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // sqlite3_io_methods, see https://www.sqlite.org/c3ref/io_methods.html
+
+    auto file_close(::sqlite3_file* file) noexcept -> int
+    {
+#ifdef __linux__
+      if (const auto& state{details::to_state<file_state>(file)}; state.fd >= 0)
+      {
+        details::inode_registry::instance().release(state.inode);
+      }
+#endif
+
+      return details::forwarding_io_methods<file_state>::close(file);
+    }
+
+    auto file_read(::sqlite3_file* file, void* buffer, int amount, ::sqlite3_int64 offset) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      observe_read(state, offset, amount);
+
+      return state.real->pMethods->xRead(state.real, buffer, amount, offset);
+    }
+
+    auto file_fetch(::sqlite3_file* file, ::sqlite3_int64 offset, int amount, void** pointer) noexcept -> int
+    {
+      auto& state{details::to_state<file_state>(file)};
+
+      // with memory-mapped I/O the page faults of a scan profit from the prefetching as well
+      observe_read(state, offset, amount);
+
+      return state.real->pMethods->xFetch(state.real, offset, amount, pointer);
+    }
+
+    [[nodiscard]] auto make_io_methods() noexcept -> ::sqlite3_io_methods
+    {
+      // all other methods forward to the file of the wrapped VFS
+      auto methods{details::make_io_methods<file_state>()};
+
+      methods.xClose = &file_close;
+      methods.xRead = &file_read;
+      methods.xFetch = &file_fetch;
+
+      return methods;
+    }
+
+    const ::sqlite3_io_methods io_methods{make_io_methods()};
+
+    // -------------------------------------------------------------------------------------------------------------------
+    // sqlite3_vfs, all methods but xOpen() are the ones of the wrapped VFS
+
+    auto vfs_open(::sqlite3_vfs* vfs, const char* name, ::sqlite3_file* file, int flags, int* out_flags) noexcept -> int
+    {
+      auto* const base_vfs{static_cast<::sqlite3_vfs*>(vfs->pAppData)};
+
+      if ((name == nullptr) || ((flags & SQLITE_OPEN_MAIN_DB) == 0))
+      {
+        // other files are not scanned, they are opened by the wrapped VFS without the wrapper
+        return base_vfs->xOpen(base_vfs, name, file, flags, out_flags);
+      }
+
+      if (const auto result{details::open_real_file<file_state>(base_vfs, name, file, flags, out_flags)}; result != SQLITE_OK)
+      {
+        return result;
+      }
+
+      auto& wrapper{details::to_file<file_state>(file)};
+      auto* const real{details::to_real_file<file_state>(file)};
+
+      try
+      {
+        auto state{std::make_unique<file_state>()};
+        state->real = real;
+
+        {
+          auto& registration{details::get_registration<vfs_registration>()};
+          const std::lock_guard lock{registration.mutex};
+          state->options = registration.options;
+        }
+
+        state->window = state->options.min_window;
+
+#ifdef __linux__
+        bool direct{false};
+
+        // without a file descriptor the file is only observed
+        state->fd = details::inode_registry::instance().acquire(name, false, direct, state->inode);
+#endif
+
+        wrapper.state = state.release();
+        wrapper.base.pMethods = &io_methods;
+      }
+      catch (...)
+      {
+        real->pMethods->xClose(real);
+        return SQLITE_NOMEM;
+      }
+
+      return SQLITE_OK;
+    }
+  }  // unnamed namespace
+
+  void register_prefetch_vfs(const prefetch_vfs_options& options, bool make_default, const std::source_location& loc)
+  {
+    if (options.trigger_reads == 0)
+    {
+      throw sqlite_error("invalid prefetch_vfs_options, trigger_reads must be > 0", SQLITE_MISUSE, loc);
+    }
+
+    if ((options.min_window == 0) || (options.max_window < options.min_window))
+    {
+      throw sqlite_error(sqlite_wrapper::format("invalid prefetch_vfs_options, min_window {} must be > 0 and <= max_window {}",
+                                                options.min_window, options.max_window),
+                         SQLITE_MISUSE, loc);
+    }
+
+    auto& registration{details::get_registration<vfs_registration>()};
+    const std::lock_guard lock{registration.mutex};
+
+    registration.options = options;
+
+    if (registration.base == nullptr)
+    {
+      registration.base = ::sqlite3_vfs_find(nullptr);
+
+      if (registration.base == nullptr)
+      {
+        throw sqlite_error("no default VFS to wrap found", SQLITE_ERROR, loc);
+      }
+
+      if (std::string_view{registration.base->zName} == io_uring_vfs_name)
+      {
+        // it flushes the WAL when SQLite publishes commits through its own database files only
+        registration.base = nullptr;
+        throw sqlite_error("the prefetching VFS can not wrap the io_uring VFS", SQLITE_MISUSE, loc);
+      }
+
+      registration.vfs = details::make_vfs<file_state>(registration.base, prefetch_vfs_name, &vfs_open);
+    }
+
+    if (const auto result{::sqlite3_vfs_register(&registration.vfs, make_default ? 1 : 0)}; result != SQLITE_OK)
+    {
+      throw sqlite_error("sqlite3_vfs_register() failed to register the prefetching VFS", result, loc);
+    }
+  }
+
+  auto get_prefetch_vfs_metrics() noexcept -> prefetch_vfs_metrics
+  {
+    return {.reads = metrics.reads.load(std::memory_order_relaxed),
+            .sequential_reads = metrics.sequential_reads.load(std::memory_order_relaxed),
+            .prefetches = metrics.prefetches.load(std::memory_order_relaxed),
+            .prefetched_bytes = metrics.prefetched_bytes.load(std::memory_order_relaxed),
+            .hits = metrics.hits.load(std::memory_order_relaxed),
+            .misses = metrics.misses.load(std::memory_order_relaxed)};
+  }
+
+  void reset_prefetch_vfs_metrics() noexcept
+  {
+    metrics.reads.store(0, std::memory_order_relaxed);
+    metrics.sequential_reads.store(0, std::memory_order_relaxed);
+    metrics.prefetches.store(0, std::memory_order_relaxed);
+    metrics.prefetched_bytes.store(0, std::memory_order_relaxed);
+    metrics.hits.store(0, std::memory_order_relaxed);
+    metrics.misses.store(0, std::memory_order_relaxed);
+  }
+}  // namespace sqlite_wrapper
@@ -14,7 +14,7 @@ namespace sqlite_wrapper::details
 
   void statement_deleter::operator()(::sqlite3_stmt* stmt) const noexcept
   {
-    [[maybe_unused]] const auto err{::sqlite3_finalize(stmt)};
-    assert(err == SQLITE_OK);
+    // sqlite3_finalize() returns the error of the last failed sqlite3_step(), finalizing itself always succeeds
+    (void)::sqlite3_finalize(stmt);
   }
 }  // namespace sqlite_wrapper::details
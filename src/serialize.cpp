@@ -0,0 +1,105 @@
+#include "sqlite_wrapper/serialize.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/sqlite_error.h"
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <source_location>
+#include <string>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    struct sqlite_free
+    {
+      void operator()(void* memory) const noexcept
+      {
+        ::sqlite3_free(memory);
+      }
+    };
+
+    [[nodiscard]] auto to_byte_vector(const unsigned char* data, ::sqlite3_int64 size) -> byte_vector
+    {
+      const auto* const begin{reinterpret_cast<const std::byte*>(data)};  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+
+      return {begin, begin + size};  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+  }  // unnamed namespace
+
+  auto serialize(::sqlite3* database, const std::string& schema, const std::source_location& loc) -> byte_vector
+  {
+    ::sqlite3_int64 size{};
+
+    // in-memory databases are read in place without an extra copy by SQLite
+    if (const auto* const data{::sqlite3_serialize(database, schema.c_str(), &size, SQLITE_SERIALIZE_NOCOPY)}; data != nullptr)
+    {
+      return to_byte_vector(data, size);
+    }
+
+    const std::unique_ptr<unsigned char, sqlite_free> data{::sqlite3_serialize(database, schema.c_str(), &size, 0)};
+
+    if (data == nullptr)
+    {
+      // a database without any page serializes to nothing
+      if (size == 0)
+      {
+        return {};
+      }
+
+      throw sqlite_error(sqlite_wrapper::format("sqlite3_serialize() failed to serialize database \"{}\"", schema),
+                         SQLITE_ERROR, loc);
+    }
+
+    return to_byte_vector(data.get(), size);
+  }
+
+  void deserialize(::sqlite3* database, const_byte_span image, deserialize_mode mode, const std::string& schema,
+                   const std::source_location& loc)
+  {
+    const auto size{static_cast<::sqlite3_int64>(image.size())};
+
+    unsigned char* data{};
+    int flags{};
+
+    if (mode == deserialize_mode::read_only_view)
+    {
+      // SQLite does not write to a read-only database image
+      data = const_cast<unsigned char*>(  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+          reinterpret_cast<const unsigned char*>(image.data()));  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+      flags = SQLITE_DESERIALIZE_READONLY;
+    }
+    else
+    {
+      // SQLite takes ownership of memory allocated with sqlite3_malloc64() and frees it on close
+      data = static_cast<unsigned char*>(::sqlite3_malloc64(static_cast<::sqlite3_uint64>(size)));
+
+      if ((data == nullptr) && (size > 0))
+      {
+        throw sqlite_error(sqlite_wrapper::format("failed to allocate {} bytes to deserialize database \"{}\"", size, schema),
+                           SQLITE_NOMEM, loc);
+      }
+
+      if (size > 0)
+      {
+        std::memcpy(data, image.data(), image.size());
+      }
+
+      flags = SQLITE_DESERIALIZE_FREEONCLOSE |
+              ((mode == deserialize_mode::read_only_copy) ? SQLITE_DESERIALIZE_READONLY : SQLITE_DESERIALIZE_RESIZEABLE);
+    }
+
+    // on failure SQLite frees data if SQLITE_DESERIALIZE_FREEONCLOSE is set
+    if (const auto result{::sqlite3_deserialize(database, schema.c_str(), data, size, size, static_cast<unsigned>(flags))};
+        result != SQLITE_OK)
+    {
+      // sqlite3_deserialize() does not set an error message on the connection
+      throw sqlite_error(sqlite_wrapper::format("sqlite3_deserialize() failed to deserialize database \"{}\"", schema),
+                         result, loc);
+    }
+  }
+}  // namespace sqlite_wrapper
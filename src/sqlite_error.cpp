@@ -1,5 +1,6 @@
 #include "sqlite_wrapper/sqlite_error.h"
 
+#include "sqlite_wrapper/error_code.h"
 #include "sqlite_wrapper/format.h"
 #include "sqlite_wrapper/raii.h"
 
@@ -7,6 +8,9 @@
 
 #include <cassert>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <stacktrace>
 #include <stdexcept>
 #include <string>
@@ -15,8 +19,24 @@
 
 namespace sqlite_wrapper
 {
+  struct sqlite_error::message_data
+  {
+    int error{SQLITE_OK};
+    std::optional<std::string> sqlite_message;  // copy of sqlite3_errmsg(), it changes with the next call on the connection
+    std::optional<std::string> sql;             // only set for errors of prepared statements
+    std::once_flag formatted;
+    std::string message;
+  };
+
   namespace
   {
+    auto stack_trace_capture_flag() noexcept -> bool&
+    {
+      thread_local bool enabled{false};
+
+      return enabled;
+    }
+
     auto error_code_to_string(int error) -> std::string
     {
       if (error == SQLITE_OK)
@@ -29,42 +49,83 @@ namespace sqlite_wrapper
       return (err_str != nullptr) ? err_str : sqlite_wrapper::format("<unknown value: {}>", error);
     }
 
-    auto error_to_string(sqlite3* raw_db_handle, int error) -> std::string
+    /**
+     * Copies the error message of the database connection and returns the extended result code belonging to \p error.
+     */
+    auto capture_database_state(sqlite3* raw_db_handle, int error, std::optional<std::string>& sqlite_message) -> sqlite_errc
     {
-      const auto* err_msg{(raw_db_handle != nullptr) ? ::sqlite3_errmsg(raw_db_handle) : nullptr};
-
-      if (err_msg != nullptr)
+      if (raw_db_handle == nullptr)
       {
-        return sqlite_wrapper::format("{} {}", err_msg, error_code_to_string(error));
+        return static_cast<sqlite_errc>(error);
       }
 
-      return sqlite_wrapper::format("{}", error_code_to_string(error));
-    }
-
-    auto error_to_string(sqlite3_stmt* stmt, int error) -> std::string
-    {
-      assert(stmt != nullptr);
-      const auto* sql_str{::sqlite3_sql(stmt)};
+      if (const auto* err_msg{::sqlite3_errmsg(raw_db_handle)}; err_msg != nullptr)
+      {
+        sqlite_message.emplace(err_msg);
+      }
 
-      return sqlite_wrapper::format("{} for SQL \"{}\"", error_to_string(::sqlite3_db_handle(stmt), error),
-                                    (sql_str != nullptr) ? sql_str : "<nullptr>");
+      return (error != SQLITE_OK) ? details::to_sqlite_errc(raw_db_handle, error) : sqlite_errc::ok;
     }
   }  // unnamed namespace
 
   sqlite_error::sqlite_error(std::string_view what, const db_with_location& database, int error, std::stacktrace&& stacktrace)
-      : std::runtime_error(
-            sqlite_wrapper::format("{}, failed with: {} in {}", what, error_to_string(database.value, error), database.location)),
+      : std::runtime_error(std::string{what}),
         m_location(database.location),
-        m_stacktrace(std::move(stacktrace))
+        m_stacktrace(std::move(stacktrace)),
+        m_extended_code(static_cast<sqlite_errc>(error)),
+        m_message_data(std::make_shared<message_data>())
   {
+    m_message_data->error = error;
+    m_extended_code = capture_database_state(database.value, error, m_message_data->sqlite_message);
   }
 
   sqlite_error::sqlite_error(std::string_view what, const stmt_with_location& stmt, int error, std::stacktrace&& stacktrace)
-      : std::runtime_error(
-            sqlite_wrapper::format("{}, failed with: {} in {}", what, error_to_string(stmt.value, error), stmt.location)),
+      : std::runtime_error(std::string{what}),
         m_location(stmt.location),
-        m_stacktrace(std::move(stacktrace))
+        m_stacktrace(std::move(stacktrace)),
+        m_extended_code(static_cast<sqlite_errc>(error)),
+        m_message_data(std::make_shared<message_data>())
+  {
+    assert(stmt.value != nullptr);
+    const auto* sql_str{::sqlite3_sql(stmt.value)};
+
+    m_message_data->error = error;
+    m_message_data->sql.emplace((sql_str != nullptr) ? sql_str : "<nullptr>");
+    m_extended_code = capture_database_state(::sqlite3_db_handle(stmt.value), error, m_message_data->sqlite_message);
+  }
+
+  auto sqlite_error::what() const noexcept -> const char*
   {
+    try
+    {
+      std::call_once(m_message_data->formatted,
+                     [this]
+                     {
+                       const auto& data{*m_message_data};
+                       const auto error_code_str{error_code_to_string(data.error)};
+                       auto error_str{data.sqlite_message ? sqlite_wrapper::format("{} {}", *data.sqlite_message, error_code_str)
+                                                          : error_code_str};
+
+                       if (data.sql)
+                       {
+                         error_str = sqlite_wrapper::format("{} for SQL \"{}\"", error_str, *data.sql);
+                       }
+
+                       // without location if it was not recorded, see SQLITE_WRAPPER_STRIP_LOCATION
+                       m_message_data->message =
+                           (m_location.line() != 0)
+                               ? sqlite_wrapper::format("{}, failed with: {} in {}", std::runtime_error::what(), error_str,
+                                                        m_location)
+                               : sqlite_wrapper::format("{}, failed with: {}", std::runtime_error::what(), error_str);
+                     });
+
+      return m_message_data->message.c_str();
+    }
+    catch (...)
+    {
+      // formatting failed (out of memory), at least return the description of the failed operation
+      return std::runtime_error::what();
+    }
   }
 
   auto sqlite_error::where() const -> const std::source_location&
@@ -77,16 +138,39 @@ namespace sqlite_wrapper
     return m_stacktrace;
   }
 
+  auto sqlite_error::code() const noexcept -> sqlite_errc
+  {
+    return primary_code(m_extended_code);
+  }
+
+  auto sqlite_error::extended_code() const noexcept -> sqlite_errc
+  {
+    return m_extended_code;
+  }
+
+  void set_stack_trace_capture(bool enabled) noexcept
+  {
+    stack_trace_capture_flag() = enabled;
+  }
+
+  auto is_stack_trace_capture_enabled() noexcept -> bool
+  {
+    return are_stack_traces_supported() && stack_trace_capture_flag();
+  }
+
   auto get_stack_trace([[maybe_unused]] std::uint16_t skip) noexcept -> std::stacktrace
   {
     if constexpr (are_stack_traces_supported())
     {
-      try
+      if (stack_trace_capture_flag())
       {
-        return std::stacktrace::current(skip);
+        try
+        {
+          return std::stacktrace::current(skip);
+        }
+        catch (...)  // NOLINT(bugprone-empty-catch)
+        {}
       }
-      catch (...)  // NOLINT(bugprone-empty-catch)
-      {}
     }
     return std::stacktrace{};
   }
@@ -1,13 +1,14 @@
 ﻿#include "sqlite_wrapper/sqlite_wrapper.h"
 
+#include "sqlite_wrapper/error_code.h"
 #include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/hot_path.h"
 #include "sqlite_wrapper/raii.h"
 
 #include <sqlite3.h>
 
 #include <cassert>
-#include <cstddef>
-#include <cstdint>
+#include <expected>
 #include <source_location>
 #include <string>
 #include <string_view>
@@ -30,45 +31,25 @@ namespace sqlite_wrapper
       return statement{stmt};
     }
 
-    void bind_value(const stmt_with_location& stmt, int index)
+    auto try_create_prepared_statement(const db_with_location& database, std::string_view sql) noexcept
+        -> std::expected<statement, sqlite_errc>
     {
-      if (const auto result{::sqlite3_bind_null(stmt.value, index)}; result != SQLITE_OK)
-      {
-        throw sqlite_error(sqlite_wrapper::format("failed to bind null to index {}", index), stmt, result);
-      }
-    }
-
-    void bind_value(const stmt_with_location& stmt, int index, std::int64_t value)
-    {
-      if (const auto result{::sqlite3_bind_int64(stmt.value, index, value)}; result != SQLITE_OK)
-      {
-        throw sqlite_error(sqlite_wrapper::format("failed to bind int64 to index {}", index), stmt, result);
-      }
-    }
-
-    void bind_value(const stmt_with_location& stmt, int index, double value)
-    {
-      if (const auto result{::sqlite3_bind_double(stmt.value, index, value)}; result != SQLITE_OK)
-      {
-        throw sqlite_error(sqlite_wrapper::format("failed to bind double to index {}", index), stmt, result);
-      }
-    }
+      sqlite3_stmt* stmt{nullptr};
 
-    void bind_value(const stmt_with_location& stmt, int index, std::string_view value)
-    {
-      if (const auto result{::sqlite3_bind_text64(stmt.value, index, value.data(), value.size(), nullptr, SQLITE_UTF8)};
+      if (const auto result{::sqlite3_prepare_v2(database.value, sql.data(), static_cast<int>(sql.size()), &stmt, nullptr)};
           result != SQLITE_OK)
       {
-        throw sqlite_error(sqlite_wrapper::format("failed to bind string to index {}", index), stmt, result);
+        assert(stmt == nullptr);
+        return std::unexpected(to_sqlite_errc(database.value, result));
       }
-    }
 
-    void bind_value(const stmt_with_location& stmt, int index, const_byte_span value)
-    {
-      if (const auto result{::sqlite3_bind_blob64(stmt.value, index, value.data(), value.size(), nullptr)}; result != SQLITE_OK)
+      if (stmt == nullptr)
       {
-        throw sqlite_error(sqlite_wrapper::format("failed to bind BLOB to index {}", index), stmt, result);
+        // empty SQL statement or only a comment
+        return std::unexpected(sqlite_errc::misuse);
       }
+
+      return statement{stmt};
     }
 
     auto sqlite_type_to_string(int type) -> std::string
@@ -90,131 +71,69 @@ namespace sqlite_wrapper
       }
     }
 
-    namespace
+    void throw_bind_error(const stmt_with_location& stmt, int index, std::string_view type, int error)
     {
-      /**
-       * Checks a column in a "ready to be returned row", in a prepared statement, to have the expected type.
-       *
-       * @param stmt statement
-       * @param index index of column to check (0 based)
-       * @param expected_type expected column type
-       * @param maybe_null indicates if NULL is allowed.
-       *
-       * @throws sqlite_error exception if expected_type does not match the actual columns type.
-       * @returns true if the type matches, false if, and only if, it is NULL AND maybe_null is true.
-       */
-      auto check_null_and_column_type(const stmt_with_location& stmt, int index, int expected_type, bool maybe_null) -> bool
-      {
-        const auto type{sqlite3_column_type(stmt.value, index)};
-
-        if (type == SQLITE_NULL)
-        {
-          if (maybe_null)
-          {
-            return false;
-          }
-
-          throw sqlite_error(sqlite_wrapper::format("column at index {} must not be NULL", index), stmt, SQLITE_MISMATCH);
-        }
-
-        if (type != expected_type)
-        {
-          throw sqlite_error(sqlite_wrapper::format("column at index {} has type {}, expected {}", index,
-                                                    sqlite_type_to_string(type), sqlite_type_to_string(expected_type)),
-                             stmt, SQLITE_MISMATCH);
-        }
-
-        return true;
-      }
-    }  // unnamed namespace
+      throw sqlite_error(sqlite_wrapper::format("failed to bind {} to index {}", type, index), stmt, error);
+    }
 
-    auto get_column(const stmt_with_location& stmt, int index, std::int64_t& value, bool maybe_null) -> bool
+    void throw_column_type_error(const stmt_with_location& stmt, int index, int type, int expected_type)
     {
-      if (!check_null_and_column_type(stmt, index, SQLITE_INTEGER, maybe_null))
+      if (type == SQLITE_NULL)
       {
-        return false;
+        throw sqlite_error(sqlite_wrapper::format("column at index {} must not be NULL", index), stmt, SQLITE_MISMATCH);
       }
 
-      value = sqlite3_column_int64(stmt.value, index);
-
-      return true;
+      throw sqlite_error(sqlite_wrapper::format("column at index {} has type {}, expected {}", index, sqlite_type_to_string(type),
+                                                sqlite_type_to_string(expected_type)),
+                         stmt, SQLITE_MISMATCH);
     }
 
-    auto get_column(const stmt_with_location& stmt, int index, double& value, bool maybe_null) -> bool
+    void throw_column_nullptr_error(const stmt_with_location& stmt, int index, std::string_view function_name)
     {
-      if (!details::check_null_and_column_type(stmt, index, SQLITE_FLOAT, maybe_null))
-      {
-        return false;
-      }
-
-      value = sqlite3_column_double(stmt.value, index);
-
-      return true;
+      throw sqlite_error(sqlite_wrapper::format("{} for index {} returned nullptr", function_name, index), stmt, SQLITE_NOMEM);
     }
 
-    auto get_column(const stmt_with_location& stmt, int index, std::string& value, bool maybe_null) -> bool
+    void clear_bindings(const stmt_with_location& stmt)
     {
-      if (!check_null_and_column_type(stmt, index, SQLITE_TEXT, maybe_null))
-      {
-        return false;
-      }
-
-      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-      const auto* str{reinterpret_cast<const char*>(sqlite3_column_text(stmt.value, index))};
-      const auto length{static_cast<std::size_t>(sqlite3_column_bytes(stmt.value, index))};
+      const auto result{sqlite3_clear_bindings(stmt.value)};
 
-      if (str == nullptr)
+      if (result != SQLITE_OK)
       {
-        throw sqlite_error(sqlite_wrapper::format("sqlite3_column_text() for index {} returned nullptr", index), stmt,
-                           SQLITE_NOMEM);
+        throw sqlite_error("sqlite3_clear_bindings() failed", stmt, result);
       }
-
-      value = std::string{str, length};
-
-      return true;
     }
 
-    auto get_column(const stmt_with_location& stmt, int index, byte_vector& value, bool maybe_null) -> bool
+    auto open(const std::string& file_name, int sqlite_flags, const std::string& vfs, const std::source_location& loc)
+        -> database
     {
-      if (!check_null_and_column_type(stmt, index, SQLITE_BLOB, maybe_null))
-      {
-        return false;
-      }
-
-      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-      const auto* data{reinterpret_cast<const std::byte*>(sqlite3_column_blob(stmt.value, index))};
-      const auto length{static_cast<std::size_t>(sqlite3_column_bytes(stmt.value, index))};
+      sqlite3* raw_db_handle{nullptr};
 
-      if (data == nullptr)
+      if (const auto result{::sqlite3_open_v2(file_name.c_str(), &raw_db_handle, sqlite_flags,
+                                              vfs.empty() ? nullptr : vfs.c_str())};
+          result != SQLITE_OK)
       {
-        throw sqlite_error(sqlite_wrapper::format("sqlite3_column_blob() for index {} returned nullptr", index), stmt,
-                           SQLITE_NOMEM);
-      }
-
-      value.clear();
-      value.reserve(length);
-
-      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-      value.insert(value.cbegin(), data, data + length);
-
-      return true;
-    }
+        if (raw_db_handle != nullptr)
+        {
+          // SQLite3 does return a handle we need to close in some error cases, see documentation
+          ::sqlite3_close(raw_db_handle);
+        }
 
-    void clear_bindings(const stmt_with_location& stmt)
-    {
-      const auto result{sqlite3_clear_bindings(stmt.value)};
+        throw sqlite_error(sqlite_wrapper::format("sqlite3_open() failed to open database \"{}\"", file_name), result, loc);
+      }
 
-      if (result != SQLITE_OK)
+      if (raw_db_handle == nullptr)
       {
-        throw sqlite_error("sqlite3_clear_bindings() failed", stmt, result);
+        // make sure we do not return a nullptr
+        throw sqlite_error(sqlite_wrapper::format("sqlite3_open() returned nullptr for database \"{}\"", file_name),
+                           SQLITE_ERROR, loc);
       }
+
+      return database{raw_db_handle};
     }
   }  // namespace details
 
   auto open(const std::string& file_name, open_flags flags, const std::source_location& loc) -> database
   {
-    sqlite3* raw_db_handle{nullptr};
-
     int sqlite_flags{};
 
     switch (flags)
@@ -229,37 +148,36 @@ namespace sqlite_wrapper
         throw sqlite_error(sqlite_wrapper::format("invalid open_flags value \"{}\"", flags), SQLITE_ERROR, loc);
     }
 
-    if (const auto result{::sqlite3_open_v2(file_name.c_str(), &raw_db_handle, sqlite_flags, nullptr)}; result != SQLITE_OK)
-    {
-      if (raw_db_handle != nullptr)
-      {
-        // SQLite3 does return a handle we need to close in some error cases, see documentation
-        ::sqlite3_close(raw_db_handle);
-      }
+    return details::open(file_name, sqlite_flags, {}, loc);
+  }
 
-      throw sqlite_error(sqlite_wrapper::format("sqlite3_open() failed to open database \"{}\"", file_name), result, loc);
-    }
+  auto step(const stmt_with_location& stmt) -> bool
+  {
+    const auto result{::sqlite3_step(stmt.value)};
 
-    if (raw_db_handle == nullptr)
+    if ((result != SQLITE_DONE) && (result != SQLITE_ROW))
     {
-      // make sure we do not return a nullptr
-      throw sqlite_error(sqlite_wrapper::format("sqlite3_open() returned nullptr for database \"{}\"", file_name), SQLITE_ERROR,
-                         loc);
+      throw sqlite_error("failed to step", stmt, result);
     }
 
-    return database{raw_db_handle};
+    return (result == SQLITE_ROW);
   }
 
-  auto step(const stmt_with_location& stmt) -> bool
+  auto try_step(const stmt_with_location& stmt) noexcept -> std::expected<bool, sqlite_errc>
   {
     const auto result{::sqlite3_step(stmt.value)};
 
-    if ((result != SQLITE_DONE) && (result != SQLITE_ROW))
+    if (result == SQLITE_ROW)
     {
-      throw sqlite_error("failed to step", stmt, result);
+      return true;
     }
 
-    return (result == SQLITE_ROW);
+    if (result == SQLITE_DONE)
+    {
+      return false;
+    }
+
+    return std::unexpected(details::to_sqlite_errc(::sqlite3_db_handle(stmt.value), result));
   }
 
   void reset_prepared_statement(const stmt_with_location& stmt)
@@ -0,0 +1,79 @@
+#include "sqlite_wrapper/thread_bound_database.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_error.h"
+
+#include <sqlite3.h>
+
+#include <atomic>
+#include <source_location>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    auto to_string(std::thread::id id) -> std::string
+    {
+      if (id == std::thread::id{})
+      {
+        return "<nobody>";
+      }
+
+      std::ostringstream stream;
+      stream << id;
+      return stream.str();
+    }
+  }  // unnamed namespace
+
+  namespace details
+  {
+    void throw_not_owner(std::thread::id owner, const std::source_location& loc)
+    {
+      throw sqlite_error(sqlite_wrapper::format("database connection owned by thread {} used by thread {}", to_string(owner),
+                                                to_string(std::this_thread::get_id())),
+                         SQLITE_MISUSE, loc);
+    }
+  }  // namespace details
+
+  thread_bound_database::thread_bound_database(database&& database) noexcept
+      : m_database(std::move(database)),
+        m_owner(std::this_thread::get_id())
+  {
+  }
+
+  void thread_bound_database::transfer_ownership(std::thread::id new_owner, const std::source_location& loc)
+  {
+    auto expected_owner{std::this_thread::get_id()};
+
+    // the owner hands it over, or any thread takes an unowned connection
+    if (!m_owner.compare_exchange_strong(expected_owner, new_owner, std::memory_order_acq_rel) &&
+        ((expected_owner != std::thread::id{}) ||
+         !m_owner.compare_exchange_strong(expected_owner, new_owner, std::memory_order_acq_rel)))
+    {
+      details::throw_not_owner(expected_owner, loc);
+    }
+  }
+
+  auto thread_bound_database::release(const std::source_location& loc) -> database
+  {
+    (void)get(loc);
+
+    m_owner.store(std::thread::id{}, std::memory_order_release);
+
+    return std::move(m_database);
+  }
+
+  auto open_thread_bound(const std::string& file_name, open_options options, const std::source_location& loc)
+      -> thread_bound_database
+  {
+    options.no_mutex = true;
+
+    return thread_bound_database{open(file_name, options, loc)};
+  }
+}  // namespace sqlite_wrapper
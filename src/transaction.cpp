@@ -0,0 +1,183 @@
+#include "sqlite_wrapper/transaction.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <source_location>
+#include <string_view>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    void execute_cached(const statement& stmt, const std::source_location& loc)
+    {
+      const stmt_with_location stmt_loc{stmt.get(), loc};
+
+      try
+      {
+        (void)step(stmt_loc);
+      }
+      catch (...)
+      {
+        // the error was already reported by step()
+        ::sqlite3_reset(stmt.get());
+        throw;
+      }
+
+      reset_prepared_statement(stmt_loc);
+    }
+
+    /**
+     * Executes a statement in a destructor, where errors can not be reported.
+     */
+    void execute_cached_noexcept(const statement& stmt) noexcept
+    {
+      ::sqlite3_step(stmt.get());
+      ::sqlite3_reset(stmt.get());
+    }
+
+    [[noreturn]] void throw_not_active(std::string_view what, const std::source_location& loc)
+    {
+      throw sqlite_error(sqlite_wrapper::format("{} is not active", what), SQLITE_MISUSE, loc);
+    }
+  }  // unnamed namespace
+
+  transaction_statements::transaction_statements(::sqlite3* database, const std::source_location& loc)
+      : m_database(database)
+  {
+    const db_with_location db_loc{m_database, loc};
+
+    m_begin.at(to_underlying(transaction_mode::deferred)) = create_prepared_statement(db_loc, "BEGIN DEFERRED");
+    m_begin.at(to_underlying(transaction_mode::immediate)) = create_prepared_statement(db_loc, "BEGIN IMMEDIATE");
+    m_begin.at(to_underlying(transaction_mode::exclusive)) = create_prepared_statement(db_loc, "BEGIN EXCLUSIVE");
+    m_commit = create_prepared_statement(db_loc, "COMMIT");
+    m_rollback = create_prepared_statement(db_loc, "ROLLBACK");
+  }
+
+  auto transaction_statements::get_savepoint_statements(std::size_t depth, const std::source_location& loc)
+      -> const savepoint_statements&
+  {
+    while (m_savepoints.size() <= depth)
+    {
+      const db_with_location db_loc{m_database, loc};
+      const auto name{sqlite_wrapper::format("sqlite_wrapper_savepoint_{}", m_savepoints.size())};
+
+      m_savepoints.push_back({.begin = create_prepared_statement(db_loc, "SAVEPOINT " + name),
+                              .release = create_prepared_statement(db_loc, "RELEASE " + name),
+                              .rollback_to = create_prepared_statement(db_loc, "ROLLBACK TO " + name)});
+    }
+
+    return m_savepoints[depth];
+  }
+
+  transaction::transaction(transaction_statements& statements, transaction_mode mode, const std::source_location& loc)
+      : m_statements(statements)
+  {
+    execute_cached(m_statements.m_begin.at(to_underlying(mode)), loc);
+
+    m_active = true;
+  }
+
+  transaction::~transaction()
+  {
+    // SQLite may already have rolled back the transaction after an error like SQLITE_FULL
+    if (m_active && (::sqlite3_get_autocommit(m_statements.m_database) == 0))
+    {
+      execute_cached_noexcept(m_statements.m_rollback);
+    }
+  }
+
+  void transaction::commit(const std::source_location& loc)
+  {
+    if (!m_active)
+    {
+      throw_not_active("transaction", loc);
+    }
+
+    execute_cached(m_statements.m_commit, loc);
+
+    m_active = false;
+  }
+
+  void transaction::rollback(const std::source_location& loc)
+  {
+    if (!m_active)
+    {
+      throw_not_active("transaction", loc);
+    }
+
+    m_active = false;
+
+    if (::sqlite3_get_autocommit(m_statements.m_database) == 0)
+    {
+      execute_cached(m_statements.m_rollback, loc);
+    }
+  }
+
+  savepoint::savepoint(transaction_statements& statements, const std::source_location& loc)
+      : m_statements(statements),
+        m_depth(statements.m_savepoint_depth)
+  {
+    execute_cached(m_statements.get_savepoint_statements(m_depth, loc).begin, loc);
+
+    ++m_statements.m_savepoint_depth;
+    m_active = true;
+  }
+
+  savepoint::~savepoint()
+  {
+    if (m_active)
+    {
+      const auto& statements{m_statements.m_savepoints[m_depth]};
+
+      execute_cached_noexcept(statements.rollback_to);
+      execute_cached_noexcept(statements.release);
+
+      m_statements.m_savepoint_depth = m_depth;
+    }
+  }
+
+  void savepoint::check_innermost(const std::source_location& loc) const
+  {
+    if (!m_active)
+    {
+      throw_not_active("savepoint", loc);
+    }
+
+    if (m_statements.m_savepoint_depth != (m_depth + 1))
+    {
+      throw sqlite_error(sqlite_wrapper::format("savepoint at depth {} is not the innermost savepoint, the depth is {}",
+                                                m_depth + 1, m_statements.m_savepoint_depth),
+                         SQLITE_MISUSE, loc);
+    }
+  }
+
+  void savepoint::release(const std::source_location& loc)
+  {
+    check_innermost(loc);
+
+    execute_cached(m_statements.m_savepoints[m_depth].release, loc);
+
+    m_active = false;
+    m_statements.m_savepoint_depth = m_depth;
+  }
+
+  void savepoint::rollback(const std::source_location& loc)
+  {
+    check_innermost(loc);
+
+    const auto& statements{m_statements.m_savepoints[m_depth]};
+
+    execute_cached(statements.rollback_to, loc);
+    execute_cached(statements.release, loc);
+
+    m_active = false;
+    m_statements.m_savepoint_depth = m_depth;
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,89 @@
+#include "sqlite_wrapper/transaction_retry.h"
+
+#include "sqlite_wrapper/busy_handler.h"
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/sqlite_error.h"
+
+#include <sqlite3.h>
+
+#include <chrono>
+#include <cstddef>
+#include <random>
+#include <source_location>
+#include <string_view>
+#include <thread>
+
+namespace sqlite_wrapper::details
+{
+  namespace
+  {
+    [[noreturn]] void throw_invalid_policy(std::string_view what, const std::source_location& loc)
+    {
+      throw sqlite_error(sqlite_wrapper::format("invalid retry_policy, {}", what), SQLITE_MISUSE, loc);
+    }
+  }  // unnamed namespace
+
+  void validate(const retry_policy& policy, const std::source_location& loc)
+  {
+    if (policy.max_attempts == 0)
+    {
+      throw_invalid_policy("max_attempts must be > 0", loc);
+    }
+
+    if ((policy.initial_delay.count() < 0) || (policy.max_delay < policy.initial_delay))
+    {
+      throw_invalid_policy("delays must not be negative and max_delay not less than initial_delay", loc);
+    }
+
+    if (!(policy.multiplier >= 1.0))
+    {
+      throw_invalid_policy("multiplier must be >= 1.0", loc);
+    }
+
+    if (!((policy.jitter >= 0.0) && (policy.jitter <= 1.0)))
+    {
+      throw_invalid_policy("jitter must be between 0.0 and 1.0", loc);
+    }
+
+    if (policy.is_retryable == nullptr)
+    {
+      throw_invalid_policy("is_retryable must not be nullptr", loc);
+    }
+  }
+
+  auto prepare_retry(const sqlite_error& error, std::size_t attempt, std::chrono::steady_clock::time_point attempt_start,
+                     const retry_policy& policy, retry_metrics* metrics) -> bool
+  {
+    if (!policy.is_retryable(error.extended_code()))
+    {
+      return false;
+    }
+
+    if (attempt >= policy.max_attempts)
+    {
+      if (metrics != nullptr)
+      {
+        ++metrics->give_ups;
+        metrics->wasted_time += std::chrono::steady_clock::now() - attempt_start;
+      }
+
+      return false;
+    }
+
+    const auto backoff_start{std::chrono::steady_clock::now()};
+
+    thread_local std::minstd_rand random{std::random_device{}()};
+
+    std::this_thread::sleep_for(get_backoff_delay(policy.initial_delay, policy.max_delay, policy.multiplier, policy.jitter,
+                                                  static_cast<int>(attempt - 1), random));
+
+    if (metrics != nullptr)
+    {
+      ++metrics->retries;
+      metrics->wasted_time += backoff_start - attempt_start;
+      metrics->backoff_time += std::chrono::steady_clock::now() - backoff_start;
+    }
+
+    return true;
+  }
+}  // namespace sqlite_wrapper::details
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace sqlite_wrapper::details
+{
+  /**
+   * File of a VFS shim, SQLite allocates it followed by the file of the wrapped VFS. \p State keeps the file of the wrapped
+   * VFS in its member real.
+   */
+  template <typename State>
+  struct vfs_file
+  {
+    ::sqlite3_file base;
+    State* state;
+  };
+
+  template <typename State>
+  constexpr std::size_t real_file_offset{(sizeof(vfs_file<State>) + alignof(std::max_align_t) - 1) &
+                                         ~(alignof(std::max_align_t) - 1)};
+
+  template <typename State>
+  [[nodiscard]] auto to_file(::sqlite3_file* file) noexcept -> vfs_file<State>&
+  {
+    return *reinterpret_cast<vfs_file<State>*>(file);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+
+  template <typename State>
+  [[nodiscard]] auto to_state(::sqlite3_file* file) noexcept -> State&
+  {
+    return *to_file<State>(file).state;
+  }
+
+  template <typename State>
+  [[nodiscard]] auto to_real_file(::sqlite3_file* file) noexcept -> ::sqlite3_file*
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return reinterpret_cast<::sqlite3_file*>(reinterpret_cast<std::byte*>(file) + real_file_offset<State>);
+  }
+
+  /**
+   * Opens the file of \p base behind \p file, it is closed again if that fails. \p file is left without methods, so SQLite
+   * does not call the shim before it attached its state.
+   */
+  template <typename State>
+  [[nodiscard]] auto open_real_file(::sqlite3_vfs* base, const char* name, ::sqlite3_file* file, int flags,
+                                    int* out_flags) noexcept -> int
+  {
+    auto& wrapper{to_file<State>(file)};
+    auto* const real{to_real_file<State>(file)};
+
+    wrapper.base.pMethods = nullptr;
+    wrapper.state = nullptr;
+
+    const auto result{base->xOpen(base, name, real, flags, out_flags)};
+
+    if ((result != SQLITE_OK) && (real->pMethods != nullptr))
+    {
+      real->pMethods->xClose(real);
+    }
+
+    return result;
+  }
+
+  /**
+   * Returns a VFS named \p name with all methods but xOpen() of \p base, which is kept in pAppData.
+   */
+  template <typename State>
+  [[nodiscard]] auto make_vfs(::sqlite3_vfs* base, const char* name, decltype(::sqlite3_vfs::xOpen) open) noexcept
+      -> ::sqlite3_vfs
+  {
+    auto vfs{*base};
+
+    vfs.pNext = nullptr;
+    vfs.szOsFile = static_cast<int>(real_file_offset<State>) + base->szOsFile;
+    vfs.zName = name;
+    vfs.pAppData = base;
+    vfs.xOpen = open;
+
+    return vfs;
+  }
+
+  template <typename Options>
+  struct vfs_registration
+  {
+    ::sqlite3_vfs vfs{};
+    ::sqlite3_vfs* base{};
+    Options options{};
+    std::mutex mutex;
+  };
+
+  template <typename Registration>
+  [[nodiscard]] auto get_registration() -> Registration&
+  {
+    static Registration registration;
+    return registration;
+  }
+
+  /**
+   * sqlite3_io_methods of a shim that forward to the file of the wrapped VFS, see
+   * https://www.sqlite.org/c3ref/io_methods.html
+   */
+  template <typename State>
+  struct forwarding_io_methods
+  {
+    static auto close(::sqlite3_file* file) noexcept -> int
+    {
+      const std::unique_ptr<State> state{std::exchange(to_file<State>(file).state, nullptr)};
+
+      return state->real->pMethods->xClose(state->real);
+    }
+
+    static auto read(::sqlite3_file* file, void* buffer, int amount, ::sqlite3_int64 offset) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xRead(state.real, buffer, amount, offset);
+    }
+
+    static auto write(::sqlite3_file* file, const void* buffer, int amount, ::sqlite3_int64 offset) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xWrite(state.real, buffer, amount, offset);
+    }
+
+    static auto truncate(::sqlite3_file* file, ::sqlite3_int64 size) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xTruncate(state.real, size);
+    }
+
+    static auto sync(::sqlite3_file* file, int flags) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xSync(state.real, flags);
+    }
+
+    static auto size(::sqlite3_file* file, ::sqlite3_int64* size) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xFileSize(state.real, size);
+    }
+
+    static auto lock(::sqlite3_file* file, int lock) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xLock(state.real, lock);
+    }
+
+    static auto unlock(::sqlite3_file* file, int lock) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xUnlock(state.real, lock);
+    }
+
+    static auto check_reserved_lock(::sqlite3_file* file, int* result) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xCheckReservedLock(state.real, result);
+    }
+
+    static auto control(::sqlite3_file* file, int operation, void* argument) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xFileControl(state.real, operation, argument);
+    }
+
+    static auto sector_size(::sqlite3_file* file) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xSectorSize(state.real);
+    }
+
+    static auto device_characteristics(::sqlite3_file* file) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xDeviceCharacteristics(state.real);
+    }
+
+    static auto shm_map(::sqlite3_file* file, int page, int page_size, int extend, void volatile** memory) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xShmMap(state.real, page, page_size, extend, memory);
+    }
+
+    static auto shm_lock(::sqlite3_file* file, int offset, int count, int flags) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xShmLock(state.real, offset, count, flags);
+    }
+
+    static void shm_barrier(::sqlite3_file* file) noexcept
+    {
+      auto& state{to_state<State>(file)};
+
+      state.real->pMethods->xShmBarrier(state.real);
+    }
+
+    static auto shm_unmap(::sqlite3_file* file, int delete_flag) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xShmUnmap(state.real, delete_flag);
+    }
+
+    static auto fetch(::sqlite3_file* file, ::sqlite3_int64 offset, int amount, void** pointer) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xFetch(state.real, offset, amount, pointer);
+    }
+
+    static auto unfetch(::sqlite3_file* file, ::sqlite3_int64 offset, void* pointer) noexcept -> int
+    {
+      auto& state{to_state<State>(file)};
+
+      return state.real->pMethods->xUnfetch(state.real, offset, pointer);
+    }
+  };
+
+  constexpr int io_methods_version{3};
+
+  /**
+   * Returns sqlite3_io_methods that forward all calls to the file of the wrapped VFS, xClose() deletes the state of the file
+   * as well. A shim replaces the methods it changes.
+   */
+  template <typename State>
+  [[nodiscard]] constexpr auto make_io_methods() noexcept -> ::sqlite3_io_methods
+  {
+    using forward = forwarding_io_methods<State>;
+
+    return {io_methods_version,
+            &forward::close,
+            &forward::read,
+            &forward::write,
+            &forward::truncate,
+            &forward::sync,
+            &forward::size,
+            &forward::lock,
+            &forward::unlock,
+            &forward::check_reserved_lock,
+            &forward::control,
+            &forward::sector_size,
+            &forward::device_characteristics,
+            &forward::shm_map,
+            &forward::shm_lock,
+            &forward::shm_barrier,
+            &forward::shm_unmap,
+            &forward::fetch,
+            &forward::unfetch};
+  }
+}  // namespace sqlite_wrapper::details
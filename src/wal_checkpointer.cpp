@@ -0,0 +1,223 @@
+#include "sqlite_wrapper/wal_checkpointer.h"
+
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+
+namespace sqlite_wrapper
+{
+  namespace
+  {
+    void validate(const wal_checkpointer_options& options, const std::source_location& loc)
+    {
+      if (options.passive_frames <= 0)
+      {
+        throw sqlite_error("invalid wal_checkpointer_options, passive_frames must be > 0", SQLITE_MISUSE, loc);
+      }
+
+      if ((options.restart_frames < 0) || (options.truncate_frames < 0) || (options.busy_timeout.count() < 0))
+      {
+        throw sqlite_error("invalid wal_checkpointer_options, restart_frames, truncate_frames and busy_timeout must not be "
+                           "negative",
+                           SQLITE_MISUSE, loc);
+      }
+    }
+
+    [[nodiscard]] auto get_file_name(::sqlite3* database, const std::source_location& loc) -> std::string
+    {
+      const auto* const file_name{::sqlite3_db_filename(database, "main")};
+
+      if ((file_name == nullptr) || (*file_name == '\0'))
+      {
+        throw sqlite_error("wal_checkpointer needs a database file", SQLITE_MISUSE, loc);
+      }
+
+      return file_name;
+    }
+  }  // unnamed namespace
+
+  wal_checkpointer::wal_checkpointer(::sqlite3* database, const wal_checkpointer_options& options,
+                                     const std::source_location& loc)
+      : m_database(database),
+        m_options(options),
+        m_previous_autocheckpoint(0)
+  {
+    validate(m_options, loc);
+
+    const auto file_name{get_file_name(m_database, loc)};
+
+    m_previous_autocheckpoint = static_cast<int>(
+        std::get<0>(execute_one_row<std::tuple<std::int64_t>>({m_database, loc}, "PRAGMA main.wal_autocheckpoint")));
+
+    // only used by the background thread, which is started after the connection is opened
+    m_connection = open(file_name,
+                        open_options{.flags = open_flags::open_only, .no_mutex = true, .busy_timeout = m_options.busy_timeout},
+                        loc);
+
+    // also opens the WAL of the new connection, a checkpoint on a connection that has not read the database does nothing
+    if (std::get<0>(execute_one_row<std::tuple<std::string>>({m_connection.get(), loc}, "PRAGMA main.journal_mode")) != "wal")
+    {
+      throw sqlite_error("wal_checkpointer needs a database in WAL mode", SQLITE_MISUSE, loc);
+    }
+
+    m_thread = std::thread{[this] { run(); }};
+
+    // replaces the hook of the automatic checkpoints
+    ::sqlite3_wal_hook(m_database, &on_commit, this);
+  }
+
+  wal_checkpointer::~wal_checkpointer()
+  {
+    // replaces the hook again, with none if automatic checkpoints were disabled before
+    ::sqlite3_wal_autocheckpoint(m_database, m_previous_autocheckpoint);
+
+    {
+      const std::lock_guard lock{m_mutex};
+      m_stopping = true;
+    }
+
+    m_wake.notify_one();
+    m_thread.join();
+  }
+
+  void wal_checkpointer::request_checkpoint() noexcept
+  {
+    if (!m_requested.exchange(true))
+    {
+      // taking the lock makes sure the background thread is either waiting or will see the request
+      {
+        const std::lock_guard lock{m_mutex};
+      }
+
+      m_wake.notify_one();
+    }
+  }
+
+  auto wal_checkpointer::get_metrics() const -> wal_checkpointer_metrics
+  {
+    wal_checkpointer_metrics metrics;
+
+    {
+      const std::lock_guard lock{m_mutex};
+      metrics = m_metrics;
+    }
+
+    metrics.commits = m_commits.load(std::memory_order_relaxed);
+    metrics.wal_frames = m_wal_frames.load(std::memory_order_relaxed);
+    metrics.max_wal_frames = m_max_wal_frames.load(std::memory_order_relaxed);
+
+    return metrics;
+  }
+
+  auto wal_checkpointer::on_commit(void* context, ::sqlite3* /*database*/, const char* schema, int frames) noexcept -> int
+  {
+    auto& self{*static_cast<wal_checkpointer*>(context)};
+
+    if (std::string_view{schema} != "main")
+    {
+      return SQLITE_OK;
+    }
+
+    self.m_commits.fetch_add(1, std::memory_order_relaxed);
+    self.m_wal_frames.store(frames, std::memory_order_relaxed);
+
+    // only the writer calls the hook, no other thread updates the maximum
+    if (frames > self.m_max_wal_frames.load(std::memory_order_relaxed))
+    {
+      self.m_max_wal_frames.store(frames, std::memory_order_relaxed);
+    }
+
+    if (frames >= self.m_options.passive_frames)
+    {
+      self.request_checkpoint();
+    }
+
+    return SQLITE_OK;
+  }
+
+  auto wal_checkpointer::checkpoint(int mode) noexcept -> int
+  {
+    int wal_frames{};
+    int checkpointed_frames{};
+
+    const auto start{std::chrono::steady_clock::now()};
+    const auto result{::sqlite3_wal_checkpoint_v2(m_connection.get(), "main", mode, &wal_frames, &checkpointed_frames)};
+    const auto duration{std::chrono::steady_clock::now() - start};
+
+    const std::lock_guard lock{m_mutex};
+
+    switch (mode)
+    {
+      case SQLITE_CHECKPOINT_RESTART:
+        ++m_metrics.restart_checkpoints;
+        break;
+      case SQLITE_CHECKPOINT_TRUNCATE:
+        ++m_metrics.truncate_checkpoints;
+        break;
+      default:
+        ++m_metrics.passive_checkpoints;
+        break;
+    }
+
+    if (result == SQLITE_BUSY)
+    {
+      ++m_metrics.busy_checkpoints;
+    }
+    else if (result != SQLITE_OK)
+    {
+      ++m_metrics.failed_checkpoints;
+      return 0;
+    }
+
+    m_metrics.checkpointed_frames = checkpointed_frames;
+    m_metrics.total_checkpoint_time += duration;
+    m_metrics.max_checkpoint_time = std::max<std::chrono::nanoseconds>(m_metrics.max_checkpoint_time, duration);
+
+    return wal_frames - checkpointed_frames;
+  }
+
+  void wal_checkpointer::run() noexcept
+  {
+    std::unique_lock lock{m_mutex};
+
+    while (true)
+    {
+      m_wake.wait(lock, [this] { return m_stopping || m_requested.load(); });
+
+      if (m_stopping)
+      {
+        return;
+      }
+
+      m_requested.store(false);
+      lock.unlock();
+
+      // a PASSIVE checkpoint never waits, it only copies frames no reader needs anymore
+      const auto remaining_frames{checkpoint(SQLITE_CHECKPOINT_PASSIVE)};
+
+      if ((m_options.truncate_frames > 0) && (remaining_frames >= m_options.truncate_frames))
+      {
+        std::ignore = checkpoint(SQLITE_CHECKPOINT_TRUNCATE);
+      }
+      else if ((m_options.restart_frames > 0) && (remaining_frames >= m_options.restart_frames))
+      {
+        std::ignore = checkpoint(SQLITE_CHECKPOINT_RESTART);
+      }
+
+      lock.lock();
+    }
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,203 @@
+#include "sqlite_wrapper/write_batcher.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/transaction.h"
+
+#include <sqlite3.h>
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <source_location>
+#include <thread>
+#include <utility>
+
+namespace sqlite_wrapper
+{
+  write_batcher::write_batcher(::sqlite3* database, const write_batcher_options& options, const std::source_location& loc)
+      : m_database(database),
+        m_options(options),
+        m_statements(database, loc)
+  {
+    if (m_options.max_statements == 0)
+    {
+      throw sqlite_error("invalid write_batcher_options, max_statements must be > 0", SQLITE_MISUSE, loc);
+    }
+
+    if (m_options.max_delay.count() < 0)
+    {
+      throw sqlite_error("invalid write_batcher_options, max_delay must not be negative", SQLITE_MISUSE, loc);
+    }
+
+    if (m_options.max_delay.count() > 0)
+    {
+      if (::sqlite3_db_mutex(m_database) == nullptr)
+      {
+        throw sqlite_error("write_batcher with max_delay needs a connection with mutex, it commits from a background thread",
+                           SQLITE_MISUSE, loc);
+      }
+
+      m_committer = std::thread{[this] { run(); }};
+    }
+  }
+
+  write_batcher::~write_batcher()
+  {
+    {
+      const std::lock_guard lock{m_mutex};
+      m_stopping = true;
+
+      if (m_batch)
+      {
+        try
+        {
+          commit(std::source_location::current());
+        }
+        catch (...)  // NOLINT(bugprone-empty-catch) a destructor can not report errors, the batch is rolled back
+        {
+        }
+      }
+    }
+
+    m_batch_started.notify_one();
+
+    if (m_committer.joinable())
+    {
+      m_committer.join();
+    }
+
+    // rolls back a batch that failed to commit
+    m_batch.reset();
+  }
+
+  void write_batcher::flush(const std::source_location& loc)
+  {
+    const std::lock_guard lock{m_mutex};
+
+    if (m_background_error)
+    {
+      std::rethrow_exception(std::exchange(m_background_error, nullptr));
+    }
+
+    if (m_batch)
+    {
+      commit(loc);
+    }
+  }
+
+  auto write_batcher::pending_statements() const -> std::size_t
+  {
+    const std::lock_guard lock{m_mutex};
+
+    return m_pending;
+  }
+
+  auto write_batcher::get_metrics() const -> write_batcher_metrics
+  {
+    const std::lock_guard lock{m_mutex};
+
+    return m_metrics;
+  }
+
+  auto write_batcher::begin_statement() -> bool
+  {
+    if (m_background_error)
+    {
+      std::rethrow_exception(std::exchange(m_background_error, nullptr));
+    }
+
+    if (m_batch)
+    {
+      return true;
+    }
+
+    // statements of an explicit transaction are not batched
+    if (::sqlite3_get_autocommit(m_database) == 0)
+    {
+      return false;
+    }
+
+    m_batch.emplace(m_statements, m_options.mode);
+    m_deadline = std::chrono::steady_clock::now() + m_options.max_delay;
+
+    m_batch_started.notify_one();
+
+    return true;
+  }
+
+  void write_batcher::end_statement()
+  {
+    ++m_pending;
+    ++m_metrics.statements;
+
+    if (m_pending >= m_options.max_statements)
+    {
+      commit(std::source_location::current());
+    }
+  }
+
+  void write_batcher::statement_failed() noexcept
+  {
+    // errors like SQLITE_FULL or SQLITE_IOERR roll back the whole transaction and with it the batch
+    if (m_batch && (::sqlite3_get_autocommit(m_database) != 0))
+    {
+      m_batch.reset();
+      m_pending = 0;
+    }
+  }
+
+  void write_batcher::commit(const std::source_location& loc)
+  {
+    try
+    {
+      m_batch->commit(loc);
+    }
+    catch (...)
+    {
+      ++m_metrics.failed_commits;
+
+      // the batch is kept, unless SQLite rolled it back
+      statement_failed();
+      throw;
+    }
+
+    m_batch.reset();
+    m_pending = 0;
+    ++m_metrics.commits;
+  }
+
+  void write_batcher::run() noexcept
+  {
+    std::unique_lock lock{m_mutex};
+
+    while (!m_stopping)
+    {
+      if (!m_batch)
+      {
+        m_batch_started.wait(lock, [this] { return m_stopping || m_batch.has_value(); });
+        continue;
+      }
+
+      if (std::chrono::steady_clock::now() < m_deadline)
+      {
+        // a batch committed and started meanwhile moves the deadline, it is checked again after waking up
+        (void)m_batch_started.wait_until(lock, m_deadline, [this] { return m_stopping; });
+        continue;
+      }
+
+      try
+      {
+        commit(std::source_location::current());
+      }
+      catch (...)
+      {
+        m_background_error = std::current_exception();
+
+        // retries a failed commit after another max_delay
+        m_deadline = std::chrono::steady_clock::now() + m_options.max_delay;
+      }
+    }
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,362 @@
+#include "sqlite_wrapper/write_queue.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/raii.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <sqlite3.h>
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sqlite_wrapper
+{
+  struct write_queue::node
+  {
+    write_function write;
+    std::promise<void> promise;
+    node* next{nullptr};
+  };
+
+  /**
+   * Writes taken from the submitted stack in submission order, only used by the writer thread.
+   */
+  class write_queue::pending_writes
+  {
+   public:
+    pending_writes() = default;
+
+    ~pending_writes()
+    {
+      while (!empty())
+      {
+        (void)pop();
+      }
+    }
+
+    pending_writes(const pending_writes&) = delete;
+    pending_writes(pending_writes&&) = delete;
+    auto operator=(const pending_writes&) -> pending_writes& = delete;
+    auto operator=(pending_writes&&) -> pending_writes& = delete;
+
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+      return m_head == nullptr;
+    }
+
+    /**
+     * Appends a stack of nodes, newest first, in reverse order.
+     */
+    void append_reversed(node* stack) noexcept
+    {
+      node* first{nullptr};
+      node* const last{stack};
+
+      while (stack != nullptr)
+      {
+        first = std::exchange(stack, std::exchange(stack->next, first));
+      }
+
+      if (first == nullptr)
+      {
+        return;
+      }
+
+      if (m_tail == nullptr)
+      {
+        m_head = first;
+      }
+      else
+      {
+        m_tail->next = first;
+      }
+
+      m_tail = last;
+    }
+
+    [[nodiscard]] auto pop() noexcept -> std::unique_ptr<node>
+    {
+      std::unique_ptr<node> front{std::exchange(m_head, m_head->next)};
+
+      if (m_head == nullptr)
+      {
+        m_tail = nullptr;
+      }
+
+      return front;
+    }
+
+   private:
+    node* m_head{nullptr};
+    node* m_tail{nullptr};
+  };
+
+  namespace
+  {
+    void execute_cached(const statement& stmt, const std::source_location& loc = std::source_location::current())
+    {
+      const stmt_with_location stmt_loc{stmt.get(), loc};
+
+      try
+      {
+        (void)step(stmt_loc);
+      }
+      catch (...)
+      {
+        // the error was already reported by step()
+        ::sqlite3_reset(stmt.get());
+        throw;
+      }
+
+      reset_prepared_statement(stmt_loc);
+    }
+  }  // unnamed namespace
+
+  write_queue::write_queue(const std::string& file_name, const write_queue_options& options, const std::source_location& loc)
+      : m_file_name(file_name),
+        m_options(options)
+  {
+    if (m_options.max_batch_size == 0)
+    {
+      throw sqlite_error(sqlite_wrapper::format("invalid write_queue_options for database \"{}\", max_batch_size must be > 0",
+                                                file_name),
+                         SQLITE_MISUSE, loc);
+    }
+
+    auto connection_options{m_options.connection_options};
+    connection_options.no_mutex = true;
+
+    m_database = open(file_name, connection_options, loc);
+
+    const db_with_location db_loc{m_database.get(), loc};
+
+    m_begin = create_prepared_statement(db_loc, "BEGIN IMMEDIATE");
+    m_commit = create_prepared_statement(db_loc, "COMMIT");
+    m_rollback = create_prepared_statement(db_loc, "ROLLBACK");
+    m_savepoint = create_prepared_statement(db_loc, "SAVEPOINT write_queue");
+    m_release = create_prepared_statement(db_loc, "RELEASE write_queue");
+    m_rollback_to = create_prepared_statement(db_loc, "ROLLBACK TO write_queue");
+
+    m_writer = std::thread{[this] { run(); }};
+  }
+
+  write_queue::~write_queue()
+  {
+    {
+      const std::lock_guard lock{m_mutex};
+      m_stopping = true;
+    }
+
+    m_writes_available.notify_one();
+    m_writer.join();
+  }
+
+  auto write_queue::submit(write_function write) -> std::future<void>
+  {
+    auto new_node{std::make_unique<node>(std::move(write))};
+    auto future{new_node->promise.get_future()};
+
+    m_submitted_count.fetch_add(1, std::memory_order_relaxed);
+
+    auto* submitted{new_node.release()};
+    submitted->next = m_submitted.load();
+
+    while (!m_submitted.compare_exchange_weak(submitted->next, submitted))
+    {
+    }
+
+    // the writer either sees the new write or is already waiting and has to be woken up, all accesses are sequentially
+    // consistent for this
+    if (m_writer_waiting.load())
+    {
+      const std::lock_guard lock{m_mutex};
+      m_writes_available.notify_one();
+    }
+
+    return future;
+  }
+
+  auto write_queue::get_metrics() const noexcept -> write_queue_metrics
+  {
+    return {.submitted = m_submitted_count.load(std::memory_order_relaxed),
+            .succeeded = m_succeeded.load(std::memory_order_relaxed),
+            .failed = m_failed.load(std::memory_order_relaxed),
+            .transactions = m_transactions.load(std::memory_order_relaxed),
+            .largest_batch = m_largest_batch.load(std::memory_order_relaxed)};
+  }
+
+  void write_queue::take_submitted(pending_writes& pending) noexcept
+  {
+    pending.append_reversed(m_submitted.exchange(nullptr));
+  }
+
+  auto write_queue::wait_for_writes(std::chrono::steady_clock::time_point deadline) -> bool
+  {
+    std::unique_lock lock{m_mutex};
+
+    m_writer_waiting = true;
+
+    const auto available{[this] { return (m_submitted.load() != nullptr) || m_stopping.load(); }};
+
+    if (deadline == std::chrono::steady_clock::time_point::max())
+    {
+      m_writes_available.wait(lock, available);
+    }
+    else
+    {
+      (void)m_writes_available.wait_until(lock, deadline, available);
+    }
+
+    m_writer_waiting = false;
+
+    return m_submitted.load() != nullptr;
+  }
+
+  void write_queue::run() noexcept
+  {
+    pending_writes pending;
+
+    while (true)
+    {
+      take_submitted(pending);
+
+      if (!pending.empty())
+      {
+        run_batch(pending);
+      }
+      else if (m_stopping.load())
+      {
+        return;
+      }
+      else
+      {
+        (void)wait_for_writes(std::chrono::steady_clock::time_point::max());
+      }
+    }
+  }
+
+  void write_queue::run_batch(pending_writes& pending)
+  {
+    std::vector<std::unique_ptr<node>> batch;
+    std::size_t failed{0};
+
+    // the metrics are updated before a future becomes ready, so they already include the write
+    const auto fail{[this](node& write, const std::exception_ptr& error)
+                    {
+                      m_failed.fetch_add(1, std::memory_order_relaxed);
+                      write.promise.set_exception(error);
+                    }};
+
+    try
+    {
+      execute_cached(m_begin);
+    }
+    catch (...)
+    {
+      // fails the writes that would have formed this transaction, so a persistent error does not block the queue
+      for (const auto error{std::current_exception()}; !pending.empty() && (failed < m_options.max_batch_size); ++failed)
+      {
+        fail(*pending.pop(), error);
+      }
+
+      return;
+    }
+
+    try
+    {
+      const auto deadline{std::chrono::steady_clock::now() + m_options.max_batch_delay};
+
+      while ((batch.size() + failed) < m_options.max_batch_size)
+      {
+        if (pending.empty())
+        {
+          take_submitted(pending);
+        }
+
+        if (pending.empty())
+        {
+          if (m_stopping.load() || (std::chrono::steady_clock::now() >= deadline) || !wait_for_writes(deadline))
+          {
+            break;
+          }
+
+          continue;
+        }
+
+        batch.push_back(pending.pop());
+
+        execute_cached(m_savepoint);
+
+        try
+        {
+          batch.back()->write(m_database.get());
+        }
+        catch (...)
+        {
+          const auto failed_write{std::move(batch.back())};
+          batch.pop_back();
+          ++failed;
+
+          fail(*failed_write, std::current_exception());
+
+          // only the failed write is undone, the transaction stays open for the others
+          execute_cached(m_rollback_to);
+          execute_cached(m_release);
+          continue;
+        }
+
+        execute_cached(m_release);
+      }
+
+      execute_cached(m_commit);
+    }
+    catch (...)
+    {
+      if (::sqlite3_get_autocommit(m_database.get()) == 0)
+      {
+        try
+        {
+          execute_cached(m_rollback);
+        }
+        catch (...)  // NOLINT(bugprone-empty-catch) the writes already fail with the original error
+        {
+        }
+      }
+
+      for (const auto error{std::current_exception()}; const auto& write : batch)
+      {
+        fail(*write, error);
+      }
+
+      failed += batch.size();
+      batch.clear();
+    }
+
+    const auto batch_size{batch.size() + failed};
+
+    m_succeeded.fetch_add(batch.size(), std::memory_order_relaxed);
+    m_transactions.fetch_add(1, std::memory_order_relaxed);
+
+    // only the writer thread writes the largest batch
+    if (batch_size > m_largest_batch.load(std::memory_order_relaxed))
+    {
+      m_largest_batch.store(batch_size, std::memory_order_relaxed);
+    }
+
+    for (const auto& write : batch)
+    {
+      write->promise.set_value();
+    }
+  }
+}  // namespace sqlite_wrapper
@@ -0,0 +1,124 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/allocator.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <sqlite3.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <thread>
+#include <tuple>
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class allocator_tests : public Test
+  {
+   protected:
+    void SetUp() override
+    {
+      ASSERT_EQ(::sqlite3_shutdown(), SQLITE_OK);
+    }
+
+    void TearDown() override
+    {
+      // later tests use the allocator of SQLite again, SQLite must not keep blocks of m_resource
+      const auto result{::sqlite3_shutdown()};
+      sqlite_wrapper::configure_allocator({.kind = sqlite_wrapper::allocator_kind::sqlite_default});
+
+      ASSERT_EQ(result, SQLITE_OK);
+    }
+
+    static void run_queries()
+    {
+      const auto database{sqlite_wrapper::open(":memory:")};
+
+      sqlite_wrapper::execute_no_data(database.get(), "CREATE TABLE Test (Id INTEGER PRIMARY KEY, Data TEXT)");
+
+      // randomblob() returns 1 byte for 0
+      for (std::int64_t id{1}; id <= 100; ++id)
+      {
+        sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (?1, hex(randomblob(?1)))", id);
+      }
+
+      const auto [count] = sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(
+          database.get(), "SELECT count(*) FROM Test WHERE length(Data) = 2 * Id");
+
+      ASSERT_EQ(count, 100);
+    }
+
+    std::pmr::synchronized_pool_resource m_resource;  ///< outlives the shutdown of SQLite in TearDown()
+  };
+}  // unnamed namespace
+
+TEST_F(allocator_tests, thread_caches_serve_sqlite)
+{
+  sqlite_wrapper::configure_allocator({.kind = sqlite_wrapper::allocator_kind::thread_caches});
+
+  const auto before{sqlite_wrapper::get_allocator_metrics()};
+
+  run_queries();
+  std::jthread{&allocator_tests::run_queries}.join();
+
+  const auto after{sqlite_wrapper::get_allocator_metrics()};
+
+  ASSERT_GT(after.allocations, before.allocations);
+  ASSERT_GT(after.cached_allocations, before.cached_allocations);
+  ASSERT_EQ(after.allocations - before.allocations, after.frees - before.frees);
+  ASSERT_EQ(after.failed_allocations, before.failed_allocations);
+}
+
+TEST_F(allocator_tests, memory_resource_serves_sqlite)
+{
+  sqlite_wrapper::configure_allocator({.kind = sqlite_wrapper::allocator_kind::memory_resource, .resource = &m_resource});
+
+  const auto before{sqlite_wrapper::get_allocator_metrics()};
+
+  run_queries();
+
+  const auto after{sqlite_wrapper::get_allocator_metrics()};
+
+  ASSERT_GT(after.allocations, before.allocations);
+  ASSERT_EQ(after.cached_allocations, before.cached_allocations);
+
+  // SQLite returns all blocks when it shuts down
+  ASSERT_EQ(::sqlite3_shutdown(), SQLITE_OK);
+  ASSERT_EQ(sqlite_wrapper::get_allocator_metrics().bytes_in_use, before.bytes_in_use);
+}
+
+TEST_F(allocator_tests, sqlite_default_is_not_counted)
+{
+  sqlite_wrapper::configure_allocator({.kind = sqlite_wrapper::allocator_kind::sqlite_default});
+
+  const auto before{sqlite_wrapper::get_allocator_metrics()};
+
+  run_queries();
+
+  ASSERT_EQ(sqlite_wrapper::get_allocator_metrics().allocations, before.allocations);
+}
+
+TEST_F(allocator_tests, configuring_initialized_sqlite_fails)
+{
+  const auto database{sqlite_wrapper::open(":memory:")};
+
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::configure_allocator(); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("configure_allocator() must be called before SQLite is initialized"));
+}
+
+TEST_F(allocator_tests, invalid_options_fail)
+{
+  ASSERT_THROWS_WITH_MSG(
+      [] { sqlite_wrapper::configure_allocator({.kind = static_cast<sqlite_wrapper::allocator_kind>(42)}); },
+      sqlite_wrapper::sqlite_error, StartsWith("invalid allocator_options, unknown allocator kind 42"));
+  ASSERT_THROWS_WITH_MSG(
+      [] { sqlite_wrapper::configure_allocator({.kind = sqlite_wrapper::allocator_kind::memory_resource}); },
+      sqlite_wrapper::sqlite_error,
+      StartsWith("invalid allocator_options, allocator_kind::memory_resource needs a resource"));
+}
@@ -0,0 +1,136 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/async_executor.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <latch>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using ::testing::ElementsAre;
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class async_executor_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+   protected:
+    void SetUp() override
+    {
+      std::filesystem::remove(temp_db_file_name);
+
+      const auto database{sqlite_wrapper::open(temp_db_file_name.string())};
+
+      sqlite_wrapper::execute_no_data(database.get(), "CREATE TABLE Test (Id INTEGER, Name TEXT)");
+      sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (1, 'one'), (2, 'two'), (3, 'three')");
+    }
+
+    void TearDown() override
+    {
+      std::filesystem::remove(temp_db_file_name);
+    }
+  };
+
+  const std::filesystem::path async_executor_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                      "sqlite_wrapper_async_executor_test.db"};
+}  // unnamed namespace
+
+TEST_F(async_executor_tests, async_execute_returns_rows)
+{
+  sqlite_wrapper::async_executor executor{temp_db_file_name.string(), {.thread_count = 2}};
+
+  auto rows{sqlite_wrapper::async_execute<std::tuple<std::int64_t, std::string>>(
+      executor, "SELECT Id, Name FROM Test WHERE Id >= ? ORDER BY Id", 2)};
+  auto count{sqlite_wrapper::async_execute<std::tuple<std::int64_t>>(executor, sqlite_wrapper::task_priority::high,
+                                                                      "SELECT COUNT(*) FROM Test")};
+
+  ASSERT_THAT(rows.get(), ElementsAre(std::make_tuple(2, "two"), std::make_tuple(3, "three")));
+  ASSERT_EQ(std::get<0>(count.get().front()), 3);
+}
+
+TEST_F(async_executor_tests, errors_are_returned_through_the_future)
+{
+  sqlite_wrapper::async_executor executor{temp_db_file_name.string()};
+
+  auto missing_table{sqlite_wrapper::async_execute<std::tuple<std::int64_t>>(executor, "SELECT Id FROM Missing")};
+  auto write{executor.submit([](::sqlite3* database)
+                             { sqlite_wrapper::execute_no_data(database, "INSERT INTO Test VALUES (4, 'four')"); })};
+
+  ASSERT_THROWS_WITH_MSG([&missing_table] { std::ignore = missing_table.get(); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("failed to create prepared statement \"SELECT Id FROM Missing\""));
+
+  // connections are read-only by default
+  try
+  {
+    write.get();
+    FAIL() << "expected sqlite_error";
+  }
+  catch (const sqlite_wrapper::sqlite_error& e)
+  {
+    ASSERT_EQ(e.code(), sqlite_wrapper::sqlite_errc::readonly);
+  }
+}
+
+TEST_F(async_executor_tests, higher_priorities_run_first)
+{
+  sqlite_wrapper::async_executor executor{temp_db_file_name.string(), {.thread_count = 1}};
+
+  std::promise<void> release_worker;
+  std::latch worker_blocked{1};
+
+  auto blocker{executor.submit(
+      [&worker_blocked, released = release_worker.get_future()](::sqlite3*)
+      {
+        worker_blocked.count_down();
+        released.wait();
+      })};
+
+  worker_blocked.wait();
+
+  std::mutex mutex;
+  std::vector<sqlite_wrapper::task_priority> order;
+  std::vector<std::future<void>> futures;
+
+  for (const auto priority : {sqlite_wrapper::task_priority::low, sqlite_wrapper::task_priority::normal,
+                              sqlite_wrapper::task_priority::high, sqlite_wrapper::task_priority::low})
+  {
+    futures.push_back(executor.submit(
+        [&, priority](::sqlite3*)
+        {
+          const std::lock_guard lock{mutex};
+          order.push_back(priority);
+        },
+        priority));
+  }
+
+  release_worker.set_value();
+
+  for (auto& future : futures)
+  {
+    future.get();
+  }
+
+  ASSERT_THAT(order, ElementsAre(sqlite_wrapper::task_priority::high, sqlite_wrapper::task_priority::normal,
+                                 sqlite_wrapper::task_priority::low, sqlite_wrapper::task_priority::low));
+}
+
+TEST_F(async_executor_tests, invalid_thread_count_fails)
+{
+  ASSERT_THROWS_WITH_MSG(
+      [] { const sqlite_wrapper::async_executor executor(temp_db_file_name.string(), {.thread_count = 0}); },
+      sqlite_wrapper::sqlite_error,
+      StartsWith("invalid async_executor_options for database \"" + temp_db_file_name.string() + "\", thread_count must be > 0"));
+}
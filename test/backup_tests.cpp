@@ -0,0 +1,207 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/backup.h"
+#include "sqlite_wrapper/memory_database.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <stop_token>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+using namespace std::chrono_literals;
+
+namespace
+{
+  class backup_tests : public Test
+  {
+   protected:
+    void SetUp() override
+    {
+      sqlite_wrapper::execute_no_data(m_source.get(), "CREATE TABLE Test (Id INTEGER, Data BLOB)");
+      sqlite_wrapper::execute_no_data(m_source.get(), "BEGIN");
+
+      for (std::int64_t id{0}; id < row_count; ++id)
+      {
+        sqlite_wrapper::execute_no_data(m_source.get(), "INSERT INTO Test VALUES (?1, zeroblob(500))", id);
+      }
+
+      sqlite_wrapper::execute_no_data(m_source.get(), "COMMIT");
+    }
+
+    [[nodiscard]] static auto count_rows(const sqlite_wrapper::db_with_location& database) -> std::int64_t
+    {
+      return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database, "SELECT COUNT(*) FROM Test"));
+    }
+
+    static constexpr std::int64_t row_count{1000};
+
+    static const std::filesystem::path temp_db_file_name;
+
+    sqlite_wrapper::database m_source{sqlite_wrapper::open_memory()};
+    sqlite_wrapper::database m_destination{sqlite_wrapper::open_memory()};
+  };
+
+  const std::filesystem::path backup_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                              "sqlite_wrapper_backup_test.db"};
+}  // unnamed namespace
+
+TEST_F(backup_tests, run_copies_database_in_steps)
+{
+  std::vector<sqlite_wrapper::backup_progress> progress;
+
+  sqlite_wrapper::backup backup{m_source.get(), m_destination.get(),
+                                {.pages_per_step = 10,
+                                 .progress = [&progress](const sqlite_wrapper::backup_progress& state)
+                                 {
+                                   progress.push_back(state);
+                                   return true;
+                                 }}};
+
+  ASSERT_TRUE(backup.run());
+  ASSERT_TRUE(backup.is_done());
+
+  ASSERT_GT(progress.size(), 2U);
+  ASSERT_GT(progress.front().remaining, 0);
+  ASSERT_EQ(progress.back().remaining, 0);
+  ASSERT_EQ(progress.back().fraction(), 1.0);
+
+  ASSERT_EQ(count_rows(m_destination.get()), row_count);
+}
+
+TEST_F(backup_tests, step_reports_progress)
+{
+  sqlite_wrapper::backup backup{m_source.get(), m_destination.get(), {.pages_per_step = 1}};
+
+  ASSERT_FALSE(backup.step());
+
+  const auto progress{backup.get_progress()};
+
+  ASSERT_GT(progress.page_count, 1);
+  ASSERT_EQ(progress.remaining, progress.page_count - 1);
+
+  while (!backup.step())
+  {
+  }
+
+  backup.finish();
+
+  ASSERT_EQ(count_rows(m_destination.get()), row_count);
+}
+
+TEST_F(backup_tests, progress_callback_cancels_backup)
+{
+  int steps{0};
+
+  sqlite_wrapper::backup backup{m_source.get(), m_destination.get(),
+                                {.pages_per_step = 1,
+                                 .progress = [&steps](const sqlite_wrapper::backup_progress& /*state*/)
+                                 { return ++steps < 3; }}};
+
+  ASSERT_FALSE(backup.run());
+  ASSERT_FALSE(backup.is_done());
+  ASSERT_EQ(steps, 3);
+}
+
+TEST_F(backup_tests, stop_token_cancels_backup)
+{
+  std::stop_source stop_source;
+  stop_source.request_stop();
+
+  sqlite_wrapper::backup backup{m_source.get(), m_destination.get(), {.pages_per_step = 1}};
+
+  ASSERT_FALSE(backup.run(stop_source.get_token()));
+  ASSERT_FALSE(backup.is_done());
+}
+
+TEST_F(backup_tests, writes_through_source_connection_are_copied)
+{
+  sqlite_wrapper::backup backup{m_source.get(), m_destination.get(), {.pages_per_step = 1}};
+
+  ASSERT_FALSE(backup.step());
+
+  sqlite_wrapper::execute_no_data(m_source.get(), "INSERT INTO Test VALUES (-1, NULL)");
+
+  ASSERT_TRUE(backup.run());
+
+  ASSERT_EQ(count_rows(m_destination.get()), row_count + 1);
+}
+
+TEST_F(backup_tests, step_after_finish_fails)
+{
+  sqlite_wrapper::backup backup{m_source.get(), m_destination.get(), {.pages_per_step = 1}};
+
+  backup.finish();
+
+  ASSERT_THROWS_WITH_MSG([&backup] { std::ignore = backup.step(); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("backup is already finished"));
+}
+
+TEST_F(backup_tests, unknown_schema_fails)
+{
+  ASSERT_THROWS_WITH_MSG(
+      [this] { const sqlite_wrapper::backup backup(m_source.get(), m_destination.get(), {.source_schema = "unknown"}); },
+      sqlite_wrapper::sqlite_error, StartsWith("sqlite3_backup_init() failed to start backup of \"unknown\" into \"main\""));
+}
+
+TEST_F(backup_tests, zero_pages_per_step_fails)
+{
+  ASSERT_THROWS_WITH_MSG(
+      [this] { const sqlite_wrapper::backup backup(m_source.get(), m_destination.get(), {.pages_per_step = 0}); },
+      sqlite_wrapper::sqlite_error, StartsWith("invalid backup_options, pages_per_step must not be 0"));
+}
+
+TEST_F(backup_tests, locked_destination_fails_after_busy_timeout)
+{
+  std::filesystem::remove(temp_db_file_name);
+
+  {
+    const auto destination{sqlite_wrapper::open(temp_db_file_name.string())};
+    const auto locker{sqlite_wrapper::open(temp_db_file_name.string())};
+
+    sqlite_wrapper::execute_no_data(locker.get(), "BEGIN EXCLUSIVE");
+
+    sqlite_wrapper::backup backup{m_source.get(), destination.get(), {.busy_timeout = 50ms}};
+
+    ASSERT_THROWS_WITH_MSG([&backup] { (void)backup.run(); }, sqlite_wrapper::sqlite_error,
+                           StartsWith("backup failed, source or destination locked for more than 50 ms"));
+  }
+
+  std::filesystem::remove(temp_db_file_name);
+}
+
+TEST_F(backup_tests, stop_token_cancels_waiting_for_lock)
+{
+  std::filesystem::remove(temp_db_file_name);
+
+  {
+    const auto destination{sqlite_wrapper::open(temp_db_file_name.string())};
+    const auto locker{sqlite_wrapper::open(temp_db_file_name.string())};
+
+    sqlite_wrapper::execute_no_data(locker.get(), "BEGIN EXCLUSIVE");
+
+    sqlite_wrapper::backup backup{m_source.get(), destination.get(), {.sleep_between_steps = 1h, .busy_timeout = 1h}};
+
+    std::stop_source stop_source;
+    const std::jthread stopper{[&stop_source]
+                               {
+                                 std::this_thread::sleep_for(10ms);
+                                 stop_source.request_stop();
+                               }};
+
+    ASSERT_FALSE(backup.run(stop_source.get_token()));
+    ASSERT_FALSE(backup.is_done());
+  }
+
+  std::filesystem::remove(temp_db_file_name);
+}
@@ -0,0 +1,102 @@
+#include "assert_throws_with_msg.h"
+#include "lock_contention_test.h"
+
+#include "sqlite_wrapper/busy_handler.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+using ::testing::StartsWith;
+
+namespace
+{
+  class busy_handler_tests : public sqlite_wrapper::lock_contention_test
+  {
+   protected:
+    busy_handler_tests() : lock_contention_test{"sqlite_wrapper_busy_handler_test.db", "CREATE TABLE Test (Id INTEGER)"}
+    {
+    }
+  };
+}  // unnamed namespace
+
+TEST_F(busy_handler_tests, gives_up_after_max_total_wait)
+{
+  const sqlite_wrapper::busy_handler handler{m_database.get(), {.max_total_wait = 50ms}};
+
+  sqlite_wrapper::execute_no_data(m_lock_holder.get(), "BEGIN EXCLUSIVE");
+
+  try
+  {
+    sqlite_wrapper::execute_no_data(m_database.get(), "INSERT INTO Test VALUES (1)");
+    FAIL() << "expected sqlite_error";
+  }
+  catch (const sqlite_wrapper::sqlite_error& e)
+  {
+    ASSERT_EQ(e.code(), sqlite_wrapper::sqlite_errc::busy);
+  }
+
+  const auto metrics{handler.get_metrics()};
+
+  ASSERT_EQ(metrics.busy_events, 1U);
+  ASSERT_EQ(metrics.give_ups, 1U);
+  ASSERT_GT(metrics.retries, 1U);
+  ASSERT_GE(metrics.total_wait_time, 50ms);
+  ASSERT_EQ(metrics.max_wait_time, metrics.total_wait_time);
+}
+
+TEST_F(busy_handler_tests, retries_until_lock_is_released)
+{
+  const sqlite_wrapper::busy_handler handler{m_database.get()};
+
+  sqlite_wrapper::execute_no_data(m_lock_holder.get(), "BEGIN EXCLUSIVE");
+
+  std::jthread lock_holder{[&]
+                           {
+                             std::this_thread::sleep_for(20ms);
+                             sqlite_wrapper::execute_no_data(m_lock_holder.get(), "COMMIT");
+                           }};
+
+  sqlite_wrapper::execute_no_data(m_database.get(), "INSERT INTO Test VALUES (1)");
+
+  const auto metrics{handler.get_metrics()};
+
+  ASSERT_EQ(metrics.busy_events, 1U);
+  ASSERT_EQ(metrics.give_ups, 0U);
+  ASSERT_GT(metrics.retries, 0U);
+  ASSERT_GT(metrics.total_wait_time.count(), 0);
+}
+
+TEST_F(busy_handler_tests, without_contention_nothing_is_counted)
+{
+  const sqlite_wrapper::busy_handler handler{m_database.get()};
+
+  sqlite_wrapper::execute_no_data(m_database.get(), "INSERT INTO Test VALUES (1)");
+
+  const auto metrics{handler.get_metrics()};
+
+  ASSERT_EQ(metrics.busy_events, 0U);
+  ASSERT_EQ(metrics.retries, 0U);
+  ASSERT_EQ(metrics.total_wait_time.count(), 0);
+}
+
+TEST_F(busy_handler_tests, invalid_options_fail)
+{
+  ASSERT_THROWS_WITH_MSG([this] { const sqlite_wrapper::busy_handler handler(m_database.get(), {.initial_delay = 0us}); },
+                         sqlite_wrapper::sqlite_error, StartsWith("invalid busy_handler_options, initial_delay must be > 0"));
+  ASSERT_THROWS_WITH_MSG(
+      [this] { const sqlite_wrapper::busy_handler handler(m_database.get(), {.initial_delay = 2ms, .max_delay = 1ms}); },
+      sqlite_wrapper::sqlite_error,
+      StartsWith("invalid busy_handler_options, max_delay must not be less than initial_delay"));
+  ASSERT_THROWS_WITH_MSG([this] { const sqlite_wrapper::busy_handler handler(m_database.get(), {.multiplier = 0.5}); },
+                         sqlite_wrapper::sqlite_error, StartsWith("invalid busy_handler_options, multiplier must be >= 1.0"));
+  ASSERT_THROWS_WITH_MSG([this] { const sqlite_wrapper::busy_handler handler(m_database.get(), {.jitter = 1.5}); },
+                         sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid busy_handler_options, jitter must be between 0.0 and 1.0"));
+}
@@ -0,0 +1,130 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/cache_warmer.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class cache_warmer_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+    static constexpr std::uint64_t page_size{4096};
+
+   protected:
+    void SetUp() override
+    {
+      std::filesystem::remove(temp_db_file_name);
+
+      m_database = sqlite_wrapper::open(temp_db_file_name.string());
+
+      sqlite_wrapper::execute_no_data(m_database.get(), "PRAGMA page_size = 4096");
+      sqlite_wrapper::execute_no_data(m_database.get(), "CREATE TABLE Test (Id INTEGER PRIMARY KEY, Data TEXT)");
+      sqlite_wrapper::execute_no_data(m_database.get(), "CREATE INDEX TestData ON Test (Data)");
+      sqlite_wrapper::execute_no_data(m_database.get(), "CREATE VIEW TestView AS SELECT Data FROM Test");
+      sqlite_wrapper::execute_no_data(m_database.get(), "BEGIN");
+
+      for (int id{0}; id < 10'000; ++id)
+      {
+        sqlite_wrapper::execute_no_data(m_database.get(), "INSERT INTO Test VALUES (?1, printf('%d %d', ?1, random()))", id);
+      }
+
+      sqlite_wrapper::execute_no_data(m_database.get(), "COMMIT");
+    }
+
+    void TearDown() override
+    {
+      m_database.reset();
+
+      std::filesystem::remove(temp_db_file_name);
+    }
+
+    sqlite_wrapper::database m_database;
+  };
+
+  const std::filesystem::path cache_warmer_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                    "sqlite_wrapper_cache_warmer_test.db"};
+}  // unnamed namespace
+
+TEST_F(cache_warmer_tests, all_objects_are_warmed)
+{
+  const auto progress{sqlite_wrapper::warm(m_database.get())};
+
+  // all pages but the first one, which holds the schema
+  ASSERT_EQ(progress.objects, 2U);
+  ASSERT_EQ(progress.objects_warmed, 2U);
+  ASSERT_EQ(progress.bytes_warmed, std::filesystem::file_size(temp_db_file_name) - page_size);
+  ASSERT_EQ(progress.bytes_warmed, progress.pages_warmed * page_size);
+  ASSERT_FALSE(progress.budget_exhausted);
+  ASSERT_EQ(progress.fraction(), 1.0);
+}
+
+TEST_F(cache_warmer_tests, warming_stops_at_budget)
+{
+  const auto progress{sqlite_wrapper::warm(m_database.get(), {.objects = {"TestData", "Test"}, .budget = 10 * page_size})};
+
+  ASSERT_EQ(progress.objects, 2U);
+  ASSERT_EQ(progress.objects_warmed, 0U);
+  ASSERT_EQ(progress.pages_warmed, 10U);
+  ASSERT_TRUE(progress.budget_exhausted);
+}
+
+TEST_F(cache_warmer_tests, progress_cancels_warming)
+{
+  int calls{0};
+
+  const auto progress{sqlite_wrapper::warm(m_database.get(),
+                                           {.progress_pages = 5,
+                                            .progress = [&calls](const sqlite_wrapper::warm_progress& current)
+                                            {
+                                              ++calls;
+                                              return current.pages_warmed < 10;
+                                            }})};
+
+  ASSERT_EQ(calls, 2);
+  ASSERT_EQ(progress.pages_warmed, 10U);
+  ASSERT_FALSE(progress.budget_exhausted);
+}
+
+TEST_F(cache_warmer_tests, background_warmer_warms_objects)
+{
+  sqlite_wrapper::cache_warmer warmer{temp_db_file_name.string(), {.objects = {"Test"}}};
+
+  const auto progress{warmer.wait()};
+
+  ASSERT_TRUE(warmer.is_done());
+  ASSERT_EQ(progress.objects_warmed, 1U);
+  ASSERT_GT(progress.pages_warmed, 10U);
+  ASSERT_EQ(warmer.get_progress().bytes_warmed, progress.bytes_warmed);
+}
+
+TEST_F(cache_warmer_tests, background_warmer_reports_errors)
+{
+  sqlite_wrapper::cache_warmer warmer{temp_db_file_name.string(), {.objects = {"TestView"}}};
+
+  ASSERT_THROWS_WITH_MSG([&warmer] { (void)warmer.wait(); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("\"TestView\" is not a table or index of schema \"main\""));
+}
+
+TEST_F(cache_warmer_tests, invalid_options_fail)
+{
+  ASSERT_THROWS_WITH_MSG([this] { (void)sqlite_wrapper::warm(m_database.get(), {.budget = 0}); },
+                         sqlite_wrapper::sqlite_error, StartsWith("invalid warm_options, budget must be > 0"));
+  ASSERT_THROWS_WITH_MSG([this] { (void)sqlite_wrapper::warm(m_database.get(), {.progress_pages = 0}); },
+                         sqlite_wrapper::sqlite_error, StartsWith("invalid warm_options, progress_pages must be > 0"));
+  ASSERT_THROWS_WITH_MSG([this] { (void)sqlite_wrapper::warm(m_database.get(), {.schema = "unknown"}); },
+                         sqlite_wrapper::sqlite_error, StartsWith("unknown schema \"unknown\""));
+  ASSERT_THROWS_WITH_MSG([] { const sqlite_wrapper::cache_warmer warmer(temp_db_file_name.string(), {.budget = 0}); },
+                         sqlite_wrapper::sqlite_error, StartsWith("invalid warm_options, budget must be > 0"));
+}
@@ -0,0 +1,44 @@
+#include "sqlite_wrapper/compile_options.h"
+#include "sqlite_wrapper/format.h"
+
+#include <sqlite3.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+using ::testing::Contains;
+using ::testing::IsEmpty;
+using ::testing::Not;
+
+TEST(sqlite_wrapper_compile_options_tests, get_sqlite_version_success)
+{
+  ASSERT_EQ(sqlite_wrapper::get_sqlite_version(), SQLITE_VERSION);
+}
+
+TEST(sqlite_wrapper_compile_options_tests, get_compile_options_success)
+{
+  const auto options{sqlite_wrapper::get_compile_options()};
+
+  ASSERT_THAT(options, Not(IsEmpty()));
+
+  for (const auto& option : options)
+  {
+    EXPECT_TRUE(sqlite_wrapper::is_compile_option_used(option)) << option;
+    EXPECT_TRUE(sqlite_wrapper::is_compile_option_used("SQLITE_" + option)) << option;
+  }
+
+  ASSERT_THAT(options,
+              Contains(sqlite_wrapper::format("THREADSAFE={}",
+                                              sqlite_wrapper::to_underlying(sqlite_wrapper::get_threading_mode()))));
+  ASSERT_FALSE(sqlite_wrapper::is_compile_option_used("NOT_A_SQLITE_OPTION"));
+}
+
+TEST(sqlite_wrapper_compile_options_tests, threading_mode_formating)
+{
+  ASSERT_EQ(sqlite_wrapper::format("{}", sqlite_wrapper::threading_mode::single_thread), "single_thread");
+  ASSERT_EQ(sqlite_wrapper::format("{}", sqlite_wrapper::threading_mode::serialized), "serialized");
+  ASSERT_EQ(sqlite_wrapper::format("{}", sqlite_wrapper::threading_mode::multi_thread), "multi_thread");
+  // NOLINTNEXTLINE(*.EnumCastOutOfRange)
+  ASSERT_EQ(sqlite_wrapper::format("{}", static_cast<sqlite_wrapper::threading_mode>(999)), "<unknown (999)>");
+}
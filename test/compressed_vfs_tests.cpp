@@ -0,0 +1,228 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/compressed_vfs.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <tuple>
+
+using ::testing::StartsWith;
+using ::testing::Test;
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+namespace
+{
+  const std::filesystem::path temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                "sqlite_wrapper_compressed_vfs_test.db"};
+
+  constexpr std::int64_t row_count{10'000};
+
+  void remove_database_files()
+  {
+    std::filesystem::remove(temp_db_file_name);
+    std::filesystem::remove(temp_db_file_name.string() + "-journal");
+    std::filesystem::remove(temp_db_file_name.string() + "-wal");
+    std::filesystem::remove(temp_db_file_name.string() + "-shm");
+  }
+
+  [[nodiscard]] auto count_rows(const sqlite_wrapper::db_with_location& database) -> std::int64_t
+  {
+    return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database, "SELECT COUNT(*) FROM Test"));
+  }
+
+  [[nodiscard]] auto check_integrity(const sqlite_wrapper::db_with_location& database) -> std::string
+  {
+    return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::string>>(database, "PRAGMA integrity_check"));
+  }
+
+  /**
+   * Creates a database of the compressing VFS with row_count rows of compressible text.
+   */
+  [[nodiscard]] auto create_database(sqlite_wrapper::journal_mode journal) -> sqlite_wrapper::database
+  {
+    auto database{
+        sqlite_wrapper::open(temp_db_file_name.string(), {.journal = journal, .vfs = sqlite_wrapper::compressed_vfs_name})};
+
+    sqlite_wrapper::execute_no_data(database.get(), "CREATE TABLE Test (Id INTEGER PRIMARY KEY, Data TEXT)");
+    sqlite_wrapper::execute_no_data(database.get(), "BEGIN");
+
+    for (std::int64_t id{0}; id < row_count; ++id)
+    {
+      sqlite_wrapper::execute_no_data(
+          database.get(), "INSERT INTO Test VALUES (?1, printf('row %d with some text that repeats itself', ?1))", id);
+    }
+
+    sqlite_wrapper::execute_no_data(database.get(), "COMMIT");
+
+    return database;
+  }
+
+  class compressed_vfs_tests : public TestWithParam<sqlite_wrapper::journal_mode>
+  {
+   protected:
+    void SetUp() override
+    {
+      remove_database_files();
+
+      sqlite_wrapper::register_compressed_vfs();
+    }
+
+    void TearDown() override
+    {
+      remove_database_files();
+    }
+  };
+
+  class compressed_read_only_vfs_tests : public Test
+  {
+   protected:
+    void SetUp() override
+    {
+      remove_database_files();
+
+      sqlite_wrapper::register_compressed_vfs();
+
+      std::ignore = create_database(sqlite_wrapper::journal_mode::delete_file);
+    }
+
+    void TearDown() override
+    {
+      remove_database_files();
+    }
+  };
+}  // unnamed namespace
+
+INSTANTIATE_TEST_SUITE_P(journal_modes, compressed_vfs_tests,
+                         Values(sqlite_wrapper::journal_mode::delete_file, sqlite_wrapper::journal_mode::wal));
+
+TEST_P(compressed_vfs_tests, changes_are_seen_by_other_connections)
+{
+  const auto database{create_database(GetParam())};
+  const auto other{sqlite_wrapper::open(temp_db_file_name.string(), {.vfs = sqlite_wrapper::compressed_vfs_name})};
+
+  ASSERT_EQ(count_rows(other.get()), row_count);
+
+  sqlite_wrapper::execute_no_data(other.get(), "DELETE FROM Test WHERE Id % 2 = 0");
+
+  ASSERT_EQ(count_rows(database.get()), row_count / 2);
+
+  // pages grow and no longer fit into their old places
+  sqlite_wrapper::execute_no_data(database.get(), "UPDATE Test SET Data = Data || randomblob(20) WHERE Id % 3 = 0");
+  sqlite_wrapper::execute_no_data(other.get(), "INSERT INTO Test VALUES (?1, NULL)", row_count);
+
+  ASSERT_EQ(count_rows(database.get()), (row_count / 2) + 1);
+  ASSERT_EQ(check_integrity(database.get()), "ok");
+  ASSERT_EQ(check_integrity(other.get()), "ok");
+}
+
+TEST_P(compressed_vfs_tests, reopened_database_is_unchanged)
+{
+  {
+    const auto database{create_database(GetParam())};
+
+    sqlite_wrapper::execute_no_data(database.get(), "DELETE FROM Test WHERE Id >= ?1", row_count / 2);
+  }
+
+  const auto database{sqlite_wrapper::open(temp_db_file_name.string(), {.vfs = sqlite_wrapper::compressed_vfs_name})};
+
+  ASSERT_EQ(count_rows(database.get()), row_count / 2);
+  ASSERT_EQ(check_integrity(database.get()), "ok");
+
+  sqlite_wrapper::execute_no_data(database.get(), "VACUUM");
+
+  ASSERT_EQ(count_rows(database.get()), row_count / 2);
+  ASSERT_EQ(check_integrity(database.get()), "ok");
+}
+
+TEST_P(compressed_vfs_tests, file_is_smaller_than_database)
+{
+  {
+    const auto database{create_database(GetParam())};
+
+    if (GetParam() == sqlite_wrapper::journal_mode::wal)
+    {
+      std::ignore = sqlite_wrapper::execute_one_row<std::tuple<std::int64_t, std::int64_t, std::int64_t>>(
+          database.get(), "PRAGMA wal_checkpoint(TRUNCATE)");
+    }
+  }
+
+  const auto stats{sqlite_wrapper::get_compression_stats(temp_db_file_name.string())};
+
+  ASSERT_GT(stats.logical_size, 0U);
+  ASSERT_LT(stats.physical_size, stats.logical_size);
+  ASSERT_GT(stats.ratio(), 1.2);
+}
+
+TEST_F(compressed_read_only_vfs_tests, image_is_read)
+{
+  const auto database{
+      sqlite_wrapper::open(temp_db_file_name.string(), {.vfs = sqlite_wrapper::compressed_read_only_vfs_name})};
+
+  ASSERT_EQ(count_rows(database.get()), row_count);
+  ASSERT_EQ(check_integrity(database.get()), "ok");
+}
+
+TEST_F(compressed_read_only_vfs_tests, writes_fail)
+{
+  const auto database{
+      sqlite_wrapper::open(temp_db_file_name.string(), {.vfs = sqlite_wrapper::compressed_read_only_vfs_name})};
+
+  ASSERT_THROWS_WITH_MSG([&] { sqlite_wrapper::execute_no_data(database.get(), "DELETE FROM Test"); },
+                         sqlite_wrapper::sqlite_error,
+                         StartsWith("failed to step, failed with: attempt to write a readonly database"));
+  ASSERT_EQ(count_rows(database.get()), row_count);
+}
+
+TEST(compressed_vfs_file_tests, plain_database_fails)
+{
+  remove_database_files();
+  sqlite_wrapper::register_compressed_vfs();
+
+  {
+    const auto database{sqlite_wrapper::open(temp_db_file_name.string())};
+
+    sqlite_wrapper::execute_no_data(database.get(), "CREATE TABLE Test (Id INTEGER PRIMARY KEY)");
+  }
+
+  ASSERT_THROWS_WITH_MSG(
+      [] { (void)sqlite_wrapper::open(temp_db_file_name.string(), {.vfs = sqlite_wrapper::compressed_vfs_name}); },
+      sqlite_wrapper::sqlite_error, StartsWith("sqlite3_open() failed to open database"));
+  ASSERT_THROWS_WITH_MSG([] { (void)sqlite_wrapper::get_compression_stats(temp_db_file_name.string()); },
+                         sqlite_wrapper::sqlite_error,
+                         StartsWith("\"" + temp_db_file_name.string() + "\" is not a database file"));
+
+  remove_database_files();
+}
+
+TEST_F(compressed_read_only_vfs_tests, corrupt_header_fails)
+{
+  {
+    // page_size of the header, see compressed_vfs.cpp
+    std::fstream file{temp_db_file_name, std::ios::binary | std::ios::in | std::ios::out};
+    file.seekp(24);
+    file.write("\0\0\0\0", 4);
+  }
+
+  ASSERT_THROWS_WITH_MSG(
+      [] { (void)sqlite_wrapper::open(temp_db_file_name.string(), {.vfs = sqlite_wrapper::compressed_read_only_vfs_name}); },
+      sqlite_wrapper::sqlite_error, StartsWith("sqlite3_open() failed to open database"));
+  ASSERT_THROWS_WITH_MSG([] { (void)sqlite_wrapper::get_compression_stats(temp_db_file_name.string()); },
+                         sqlite_wrapper::sqlite_error,
+                         StartsWith("\"" + temp_db_file_name.string() + "\" is not a database file"));
+}
+
+TEST(compressed_vfs_file_tests, invalid_options_fail)
+{
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::register_compressed_vfs({.compression_level = 100}); },
+                         sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid compressed_vfs_options, compression_level 100 must be from"));
+}
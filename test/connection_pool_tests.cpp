@@ -0,0 +1,214 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/connection_pool.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace std::string_view_literals;
+
+using ::testing::AllOf;
+using ::testing::HasSubstr;
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class connection_pool_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+   protected:
+    void SetUp() override
+    {
+      remove_database_files();
+    }
+
+    void TearDown() override
+    {
+      remove_database_files();
+    }
+
+    static void remove_database_files()
+    {
+      std::filesystem::remove(temp_db_file_name);
+      std::filesystem::remove(temp_db_file_name.string() + "-wal");
+      std::filesystem::remove(temp_db_file_name.string() + "-shm");
+    }
+  };
+
+  const std::filesystem::path connection_pool_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                       "sqlite_wrapper_connection_pool_test.db"};
+}  // unnamed namespace
+
+TEST_F(connection_pool_tests, opens_database_in_wal_mode)
+{
+  sqlite_wrapper::connection_pool pool{temp_db_file_name.string(), {.reader_count = 2}};
+
+  const auto writer{pool.checkout_writer()};
+  ASSERT_TRUE(writer.is_writer());
+  ASSERT_EQ(std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::string>>(writer.get(), "PRAGMA journal_mode")), "wal");
+
+  const auto reader{pool.checkout_reader()};
+  ASSERT_FALSE(reader.is_writer());
+  ASSERT_EQ(std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::string>>(reader.get(), "PRAGMA journal_mode")), "wal");
+}
+
+TEST_F(connection_pool_tests, readers_are_read_only)
+{
+  sqlite_wrapper::connection_pool pool{temp_db_file_name.string(), {.reader_count = 1}};
+
+  sqlite_wrapper::execute_no_data(pool.checkout_writer().get(), "CREATE TABLE Test (Id INTEGER PRIMARY KEY)");
+
+  const auto reader{pool.checkout_reader()};
+
+  ASSERT_THROW(sqlite_wrapper::execute_no_data(reader.get(), "INSERT INTO Test VALUES (1)"), sqlite_wrapper::sqlite_error);
+  ASSERT_TRUE(sqlite_wrapper::execute<std::tuple<std::int64_t>>(reader.get(), "SELECT Id FROM Test").empty());
+}
+
+TEST_F(connection_pool_tests, checkout_times_out)
+{
+  sqlite_wrapper::connection_pool pool{temp_db_file_name.string(), {.reader_count = 1}};
+
+  {
+    const auto reader{pool.checkout_reader()};
+    const auto writer{pool.checkout_writer()};
+
+    ASSERT_FALSE(pool.try_checkout_reader(1ms).has_value());
+    ASSERT_FALSE(pool.try_checkout_writer().has_value());
+
+    ASSERT_THROWS_WITH_MSG(
+        [&] { (void)pool.checkout_reader(1ms); }, sqlite_wrapper::sqlite_error,
+        AllOf(StartsWith("timeout after 1 ms waiting for a reader of database"), HasSubstr(temp_db_file_name.string())));
+
+    try
+    {
+      (void)pool.checkout_writer(1ms);
+      FAIL() << "expected sqlite_error";
+    }
+    catch (const sqlite_wrapper::sqlite_error& e)
+    {
+      ASSERT_EQ(e.code(), sqlite_wrapper::sqlite_errc::busy);
+    }
+
+    const auto metrics{pool.get_metrics()};
+    ASSERT_EQ(metrics.timeouts, 4U);
+    ASSERT_EQ(metrics.readers_in_use, 1U);
+    ASSERT_TRUE(metrics.writer_in_use);
+  }
+
+  ASSERT_TRUE(pool.try_checkout_reader().has_value());
+  ASSERT_TRUE(pool.try_checkout_writer().has_value());
+}
+
+TEST_F(connection_pool_tests, pooled_connection_is_returned_when_moved_from_guard_is_destroyed)
+{
+  sqlite_wrapper::connection_pool pool{temp_db_file_name.string(), {.reader_count = 1}};
+
+  std::optional<sqlite_wrapper::pooled_connection> moved_to;
+
+  {
+    auto reader{pool.checkout_reader()};
+    auto* const handle{reader.get()};
+
+    moved_to.emplace(std::move(reader));
+
+    ASSERT_EQ(reader.get(), nullptr);  // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+    ASSERT_EQ(moved_to->get(), handle);
+  }
+
+  ASSERT_FALSE(pool.try_checkout_reader().has_value());
+
+  moved_to.reset();
+
+  ASSERT_TRUE(pool.try_checkout_reader().has_value());
+}
+
+TEST_F(connection_pool_tests, concurrent_readers_and_writer)
+{
+  constexpr std::size_t reader_count{4};
+  constexpr std::int64_t row_count{200};
+
+  sqlite_wrapper::connection_pool pool{temp_db_file_name.string(), {.reader_count = reader_count}};
+
+  sqlite_wrapper::execute_no_data(pool.checkout_writer().get(), "CREATE TABLE Test (Id INTEGER PRIMARY KEY)");
+
+  std::atomic<bool> done{false};
+  std::atomic<std::size_t> failed_reads{0};
+  std::vector<std::jthread> readers;
+
+  for (std::size_t i{0}; i < (reader_count * 2); ++i)
+  {
+    readers.emplace_back(
+        [&]
+        {
+          std::int64_t last_count{0};
+
+          while (!done)
+          {
+            const auto reader{pool.checkout_reader()};
+            const auto [count] =
+                sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(reader.get(), "SELECT COUNT(*) FROM Test");
+
+            // readers see a consistent and growing snapshot
+            if (count < last_count)
+            {
+              ++failed_reads;
+            }
+            last_count = count;
+          }
+        });
+  }
+
+  for (std::int64_t id{1}; id <= row_count; ++id)
+  {
+    sqlite_wrapper::execute_no_data(pool.checkout_writer().get(), "INSERT INTO Test VALUES (?)", id);
+  }
+
+  done = true;
+  readers.clear();
+
+  ASSERT_EQ(failed_reads, 0U);
+
+  const auto [count] =
+      sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(pool.checkout_reader().get(), "SELECT COUNT(*) FROM Test");
+  ASSERT_EQ(count, row_count);
+
+  const auto metrics{pool.get_metrics()};
+  ASSERT_EQ(metrics.reader_count, reader_count);
+  ASSERT_EQ(metrics.readers_in_use, 0U);
+  ASSERT_FALSE(metrics.writer_in_use);
+  ASSERT_EQ(metrics.writer_checkouts, static_cast<std::uint64_t>(row_count) + 1);
+  ASSERT_GT(metrics.reader_checkouts, 0U);
+  ASSERT_GT(metrics.reader_utilization(), 0.0);
+  ASSERT_LE(metrics.reader_utilization(), 1.0);
+  ASSERT_GT(metrics.writer_utilization(), 0.0);
+  ASSERT_LE(metrics.writer_utilization(), 1.0);
+}
+
+TEST_F(connection_pool_tests, in_memory_database_fails)
+{
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::connection_pool pool{":memory:"}; }, sqlite_wrapper::sqlite_error,
+                         StartsWith("failed to set journal mode wal, journal mode is memory"));
+}
+
+TEST_F(connection_pool_tests, zero_readers_fails)
+{
+  ASSERT_THROW((sqlite_wrapper::connection_pool{temp_db_file_name.string(), {.reader_count = 0}}), sqlite_wrapper::sqlite_error);
+}
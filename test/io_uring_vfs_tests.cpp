@@ -0,0 +1,161 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/io_uring_vfs.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <tuple>
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class io_uring_vfs_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+   protected:
+    void SetUp() override
+    {
+      if (!sqlite_wrapper::is_io_uring_supported())
+      {
+        GTEST_SKIP() << "io_uring is not supported";
+      }
+
+      remove_database_files();
+    }
+
+    void TearDown() override
+    {
+      remove_database_files();
+    }
+
+    static void remove_database_files()
+    {
+      std::filesystem::remove(temp_db_file_name);
+      std::filesystem::remove(temp_db_file_name.string() + "-journal");
+      std::filesystem::remove(temp_db_file_name.string() + "-wal");
+      std::filesystem::remove(temp_db_file_name.string() + "-shm");
+    }
+
+    [[nodiscard]] static auto open(std::optional<sqlite_wrapper::journal_mode> journal) -> sqlite_wrapper::database
+    {
+      return sqlite_wrapper::open(temp_db_file_name.string(), {.journal = journal, .vfs = sqlite_wrapper::io_uring_vfs_name});
+    }
+
+    [[nodiscard]] static auto count_rows(const sqlite_wrapper::db_with_location& database) -> std::int64_t
+    {
+      return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database, "SELECT COUNT(*) FROM Test"));
+    }
+
+    [[nodiscard]] static auto check_integrity(const sqlite_wrapper::db_with_location& database) -> std::string
+    {
+      return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::string>>(database, "PRAGMA integrity_check"));
+    }
+
+    // inserts rows with pages worth of data, in one transaction and in one transaction per row
+    static void write_rows(const sqlite_wrapper::db_with_location& database)
+    {
+      sqlite_wrapper::execute_no_data(database, "CREATE TABLE Test (Id INTEGER PRIMARY KEY, Data BLOB)");
+
+      sqlite_wrapper::execute_no_data(database, "BEGIN");
+
+      for (int id{0}; id < 1000; ++id)
+      {
+        sqlite_wrapper::execute_no_data(database, "INSERT INTO Test VALUES (?1, randomblob(500))", id);
+      }
+
+      sqlite_wrapper::execute_no_data(database, "COMMIT");
+
+      for (int id{1000}; id < 1100; ++id)
+      {
+        sqlite_wrapper::execute_no_data(database, "INSERT INTO Test VALUES (?1, randomblob(500))", id);
+      }
+    }
+
+    static void write_and_read(std::optional<sqlite_wrapper::journal_mode> journal)
+    {
+      {
+        const auto database{open(journal)};
+
+        write_rows(database.get());
+
+        // a connection with the default VFS sees all commits
+        const auto other{sqlite_wrapper::open(temp_db_file_name.string(), {.flags = sqlite_wrapper::open_flags::open_only})};
+
+        ASSERT_EQ(count_rows(other.get()), 1100);
+
+        sqlite_wrapper::execute_no_data(database.get(), "DELETE FROM Test WHERE Id % 2 = 0");
+
+        ASSERT_EQ(count_rows(other.get()), 550);
+
+        sqlite_wrapper::execute_no_data(other.get(), "INSERT INTO Test VALUES (5000, NULL)");
+
+        ASSERT_EQ(count_rows(database.get()), 551);
+        ASSERT_EQ(check_integrity(database.get()), "ok");
+      }
+
+      const auto database{open(std::nullopt)};
+
+      ASSERT_EQ(count_rows(database.get()), 551);
+      ASSERT_EQ(check_integrity(database.get()), "ok");
+    }
+  };
+
+  const std::filesystem::path io_uring_vfs_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                    "sqlite_wrapper_io_uring_vfs_test.db"};
+}  // unnamed namespace
+
+TEST_F(io_uring_vfs_tests, wal_database)
+{
+  sqlite_wrapper::register_io_uring_vfs();
+
+  write_and_read(sqlite_wrapper::journal_mode::wal);
+}
+
+TEST_F(io_uring_vfs_tests, rollback_journal_database)
+{
+  sqlite_wrapper::register_io_uring_vfs();
+
+  write_and_read(sqlite_wrapper::journal_mode::delete_file);
+}
+
+TEST_F(io_uring_vfs_tests, small_batches)
+{
+  sqlite_wrapper::register_io_uring_vfs({.max_batch_size = 4096});
+
+  write_and_read(sqlite_wrapper::journal_mode::wal);
+
+  sqlite_wrapper::register_io_uring_vfs();
+}
+
+TEST_F(io_uring_vfs_tests, direct_io)
+{
+  sqlite_wrapper::register_io_uring_vfs({.direct_io = true});
+
+  write_and_read(sqlite_wrapper::journal_mode::wal);
+  remove_database_files();
+  write_and_read(sqlite_wrapper::journal_mode::delete_file);
+
+  sqlite_wrapper::register_io_uring_vfs();
+}
+
+TEST_F(io_uring_vfs_tests, invalid_options_fail)
+{
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::register_io_uring_vfs({.queue_depth = 0}); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid io_uring_vfs_options, queue_depth must be from 1 to 4096"));
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::register_io_uring_vfs({.queue_depth = 4097}); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid io_uring_vfs_options, queue_depth must be from 1 to 4096"));
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::register_io_uring_vfs({.max_batch_size = 0}); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid io_uring_vfs_options, max_batch_size must be > 0"));
+}
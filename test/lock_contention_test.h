@@ -0,0 +1,56 @@
+#pragma once
+
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace sqlite_wrapper
+{
+  /**
+   * Fixture with two connections to a new database file, m_lock_holder takes the locks that m_database has to wait for.
+   */
+  class lock_contention_test : public ::testing::Test
+  {
+    static auto remove_database_files(std::filesystem::path file_name) -> std::filesystem::path
+    {
+      std::filesystem::remove(file_name);
+      std::filesystem::remove(file_name.string() + "-journal");
+
+      return file_name;
+    }
+
+   protected:
+    /**
+     * @param file_name name of the database file in the temp directory
+     * @param create_table statement that creates the tables of the tests
+     */
+    lock_contention_test(std::string_view file_name, std::string create_table)
+        : m_create_table{std::move(create_table)},
+          m_file_name{remove_database_files(std::filesystem::temp_directory_path() / file_name)}
+    {
+    }
+
+    void SetUp() override
+    {
+      sqlite_wrapper::execute_no_data(m_lock_holder.get(), m_create_table);
+    }
+
+    void TearDown() override
+    {
+      m_lock_holder.reset();
+      m_database.reset();
+
+      remove_database_files(m_file_name);
+    }
+
+    std::string m_create_table;
+    std::filesystem::path m_file_name;  ///< initialized before the connections, which open it
+    sqlite_wrapper::database m_lock_holder{sqlite_wrapper::open(m_file_name.string())};
+    sqlite_wrapper::database m_database{sqlite_wrapper::open(m_file_name.string())};
+  };
+}  // namespace sqlite_wrapper
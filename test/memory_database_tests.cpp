@@ -0,0 +1,143 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/memory_database.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <tuple>
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class memory_database_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+   protected:
+    void SetUp() override
+    {
+      std::filesystem::remove(temp_db_file_name);
+    }
+
+    void TearDown() override
+    {
+      std::filesystem::remove(temp_db_file_name);
+    }
+
+    [[nodiscard]] static auto count_rows(const sqlite_wrapper::db_with_location& database) -> std::int64_t
+    {
+      return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database, "SELECT COUNT(*) FROM Test"));
+    }
+
+    [[nodiscard]] static auto has_table(const sqlite_wrapper::db_with_location& database) -> bool
+    {
+      return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(
+                 database, "SELECT COUNT(*) FROM sqlite_schema WHERE name = 'Test'")) == 1;
+    }
+  };
+
+  const std::filesystem::path memory_database_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                       "sqlite_wrapper_memory_database_test.db"};
+}  // unnamed namespace
+
+TEST_F(memory_database_tests, private_databases_are_distinct)
+{
+  const auto first{sqlite_wrapper::open_memory()};
+  const auto second{sqlite_wrapper::open_memory()};
+  const auto first_named{sqlite_wrapper::open_memory("private")};
+  const auto second_named{sqlite_wrapper::open_memory("private")};
+
+  sqlite_wrapper::execute_no_data(first.get(), "CREATE TABLE Test (Id INTEGER)");
+  sqlite_wrapper::execute_no_data(first_named.get(), "CREATE TABLE Test (Id INTEGER)");
+
+  ASSERT_FALSE(has_table(second.get()));
+  ASSERT_FALSE(has_table(second_named.get()));
+}
+
+TEST_F(memory_database_tests, shared_database_is_visible_to_all_connections_with_same_name)
+{
+  {
+    const auto first{sqlite_wrapper::open_memory("shared", true)};
+    const auto second{sqlite_wrapper::open_memory("shared", true)};
+    const auto other{sqlite_wrapper::open_memory("other", true)};
+
+    sqlite_wrapper::execute_no_data(first.get(), "CREATE TABLE Test (Id INTEGER)");
+    sqlite_wrapper::execute_no_data(first.get(), "INSERT INTO Test VALUES (1)");
+
+    ASSERT_EQ(count_rows(second.get()), 1);
+    ASSERT_FALSE(has_table(other.get()));
+  }
+
+  // the database is gone with its last connection
+  const auto database{sqlite_wrapper::open_memory("shared", true)};
+
+  ASSERT_FALSE(has_table(database.get()));
+}
+
+TEST_F(memory_database_tests, invalid_names_fail)
+{
+  ASSERT_THROWS_WITH_MSG([] { std::ignore = sqlite_wrapper::open_memory("a/b"); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid in-memory database name \"a/b\", must not contain '/', '?' or '#'"));
+  ASSERT_THROWS_WITH_MSG([] { std::ignore = sqlite_wrapper::open_memory("a?b", true); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid in-memory database name \"a?b\""));
+  ASSERT_THROWS_WITH_MSG([] { std::ignore = sqlite_wrapper::open_memory({}, true); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("shared in-memory database needs a name"));
+}
+
+TEST_F(memory_database_tests, wal_journal_mode_fails)
+{
+  ASSERT_THROWS_WITH_MSG(
+      [] { std::ignore = sqlite_wrapper::open_memory({}, false, {.journal = sqlite_wrapper::journal_mode::wal}); },
+      sqlite_wrapper::sqlite_error, StartsWith("invalid open_options, in-memory databases do not support journal_mode::wal"));
+}
+
+TEST_F(memory_database_tests, open_memory_from_file_preloads_content)
+{
+  {
+    const auto file_database{sqlite_wrapper::open(temp_db_file_name.string())};
+
+    sqlite_wrapper::execute_no_data(file_database.get(), "CREATE TABLE Test (Id INTEGER)");
+    sqlite_wrapper::execute_no_data(file_database.get(), "INSERT INTO Test VALUES (1), (2), (3)");
+  }
+
+  const auto database{sqlite_wrapper::open_memory_from_file(temp_db_file_name.string(), "preloaded", true)};
+
+  ASSERT_EQ(count_rows(database.get()), 3);
+
+  // changes of the in-memory copy do not reach the file
+  sqlite_wrapper::execute_no_data(database.get(), "DELETE FROM Test");
+
+  ASSERT_EQ(count_rows(database.get()), 0);
+  ASSERT_EQ(count_rows(sqlite_wrapper::open(temp_db_file_name.string()).get()), 3);
+}
+
+TEST_F(memory_database_tests, copy_database_replaces_destination)
+{
+  const auto source{sqlite_wrapper::open_memory()};
+  const auto destination{sqlite_wrapper::open_memory()};
+
+  sqlite_wrapper::execute_no_data(source.get(), "CREATE TABLE Test (Id INTEGER)");
+  sqlite_wrapper::execute_no_data(source.get(), "INSERT INTO Test VALUES (1)");
+  sqlite_wrapper::execute_no_data(destination.get(), "CREATE TABLE Other (Id INTEGER)");
+
+  sqlite_wrapper::copy_database(source.get(), destination.get());
+
+  ASSERT_EQ(count_rows(destination.get()), 1);
+  ASSERT_EQ(std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(
+                destination.get(), "SELECT COUNT(*) FROM sqlite_schema WHERE name = 'Other'")),
+            0);
+}
+
+TEST_F(memory_database_tests, open_memory_from_missing_file_fails)
+{
+  ASSERT_THROW(std::ignore = sqlite_wrapper::open_memory_from_file(temp_db_file_name.string()), sqlite_wrapper::sqlite_error);
+}
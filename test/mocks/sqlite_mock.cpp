@@ -27,6 +27,11 @@ auto sqlite3_errstr(int error) -> const char*
   return get_global_mock<sqlite3_mock>()->sqlite3_errstr(error);
 }
 
+auto sqlite3_extended_errcode(sqlite3* pDb) -> int
+{
+  return get_global_mock<sqlite3_mock>()->sqlite3_extended_errcode(pDb);
+}
+
 auto sqlite3_prepare_v2(sqlite3* pDb, const char* zSql, int nByte, sqlite3_stmt** ppStmt, const char** pzTail) -> int
 {
   return get_global_mock<sqlite3_mock>()->sqlite3_prepare_v2(pDb, zSql, nByte, ppStmt, pzTail);
@@ -0,0 +1,240 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/format.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <tuple>
+
+using namespace std::chrono_literals;
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class open_options_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+   protected:
+    void SetUp() override
+    {
+      remove_database_files();
+    }
+
+    void TearDown() override
+    {
+      remove_database_files();
+    }
+
+    static void remove_database_files()
+    {
+      std::filesystem::remove(temp_db_file_name);
+      std::filesystem::remove(temp_db_file_name.string() + "-wal");
+      std::filesystem::remove(temp_db_file_name.string() + "-shm");
+    }
+
+    [[nodiscard]] static auto get_pragma(const sqlite_wrapper::db_with_location& database, const std::string& pragma)
+        -> std::int64_t
+    {
+      return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database, "PRAGMA " + pragma));
+    }
+
+    [[nodiscard]] static auto get_journal_mode(const sqlite_wrapper::db_with_location& database) -> std::string
+    {
+      return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::string>>(database, "PRAGMA journal_mode"));
+    }
+  };
+
+  const std::filesystem::path open_options_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                    "sqlite_wrapper_open_options_test.db"};
+}  // unnamed namespace
+
+TEST_F(open_options_tests, journal_mode_formatting)
+{
+  ASSERT_EQ(sqlite_wrapper::format("{}", sqlite_wrapper::journal_mode::delete_file), "delete");
+  ASSERT_EQ(sqlite_wrapper::format("{}", sqlite_wrapper::journal_mode::wal), "wal");
+  ASSERT_EQ(sqlite_wrapper::format("{}", sqlite_wrapper::journal_mode::off), "off");
+  ASSERT_EQ(sqlite_wrapper::format("{}", static_cast<sqlite_wrapper::journal_mode>(999)), "<unknown (999)>");
+}
+
+TEST_F(open_options_tests, default_options_keep_sqlite_defaults)
+{
+  const auto database{sqlite_wrapper::open(temp_db_file_name.string(), sqlite_wrapper::open_options{})};
+
+  ASSERT_EQ(get_journal_mode(database.get()), "delete");
+  ASSERT_EQ(get_pragma(database.get(), "busy_timeout"), 0);
+}
+
+TEST_F(open_options_tests, read_mostly_preset_is_applied)
+{
+  auto options{sqlite_wrapper::open_options::read_mostly()};
+  options.page_size = 8192;
+  options.lookaside = sqlite_wrapper::lookaside_config{.slot_size = 256, .slot_count = 128};
+
+  const auto database{sqlite_wrapper::open(temp_db_file_name.string(), options)};
+
+  ASSERT_EQ(get_journal_mode(database.get()), "wal");
+  ASSERT_EQ(get_pragma(database.get(), "page_size"), 8192);
+  ASSERT_EQ(get_pragma(database.get(), "synchronous"), 1);
+  ASSERT_EQ(get_pragma(database.get(), "cache_size"), *options.cache_size);
+  ASSERT_EQ(get_pragma(database.get(), "temp_store"), 2);
+  ASSERT_EQ(get_pragma(database.get(), "busy_timeout"), options.busy_timeout->count());
+}
+
+TEST_F(open_options_tests, durable_oltp_and_bulk_load_presets_are_applied)
+{
+  {
+    const auto database{sqlite_wrapper::open(temp_db_file_name.string(), sqlite_wrapper::open_options::durable_oltp())};
+
+    ASSERT_EQ(get_journal_mode(database.get()), "wal");
+    ASSERT_EQ(get_pragma(database.get(), "synchronous"), 2);
+  }
+
+  remove_database_files();
+
+  {
+    const auto database{sqlite_wrapper::open(temp_db_file_name.string(), sqlite_wrapper::open_options::bulk_load())};
+
+    ASSERT_EQ(get_journal_mode(database.get()), "off");
+    ASSERT_EQ(get_pragma(database.get(), "synchronous"), 0);
+  }
+}
+
+TEST_F(open_options_tests, read_only_connection_can_not_write)
+{
+  sqlite_wrapper::execute_no_data(sqlite_wrapper::open(temp_db_file_name.string()).get(), "CREATE TABLE Test (Id INTEGER)");
+
+  const auto database{sqlite_wrapper::open(temp_db_file_name.string(),
+                                           {.flags = sqlite_wrapper::open_flags::open_only, .read_only = true})};
+
+  try
+  {
+    sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (1)");
+    FAIL() << "expected sqlite_error";
+  }
+  catch (const sqlite_wrapper::sqlite_error& e)
+  {
+    ASSERT_EQ(e.code(), sqlite_wrapper::sqlite_errc::readonly);
+  }
+}
+
+TEST_F(open_options_tests, immutable_connection_reads_without_locking)
+{
+  const auto writer{sqlite_wrapper::open(temp_db_file_name.string())};
+
+  sqlite_wrapper::execute_no_data(writer.get(), "CREATE TABLE Test (Id INTEGER)");
+  sqlite_wrapper::execute_no_data(writer.get(), "INSERT INTO Test VALUES (1)");
+
+  const auto database{sqlite_wrapper::open_immutable(temp_db_file_name.string())};
+
+  ASSERT_EQ(get_pragma(database.get(), "mmap_size"), static_cast<std::int64_t>(std::filesystem::file_size(temp_db_file_name)));
+
+  // a shared lock could not be taken while the writer holds an exclusive lock
+  sqlite_wrapper::execute_no_data(writer.get(), "BEGIN EXCLUSIVE");
+  sqlite_wrapper::execute_no_data(writer.get(), "INSERT INTO Test VALUES (2)");
+
+  ASSERT_EQ(std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database.get(), "SELECT COUNT(*) FROM Test")),
+            1);
+
+  sqlite_wrapper::execute_no_data(writer.get(), "ROLLBACK");
+
+  try
+  {
+    sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (3)");
+    FAIL() << "expected sqlite_error";
+  }
+  catch (const sqlite_wrapper::sqlite_error& e)
+  {
+    ASSERT_EQ(e.code(), sqlite_wrapper::sqlite_errc::readonly);
+  }
+}
+
+TEST_F(open_options_tests, immutable_file_name_is_encoded)
+{
+  const auto file_name{std::filesystem::temp_directory_path() / "sqlite_wrapper_open_options_test %41?#.db"};
+
+  sqlite_wrapper::execute_no_data(sqlite_wrapper::open(file_name.string()).get(), "CREATE TABLE Test (Id INTEGER)");
+
+  {
+    const auto database{sqlite_wrapper::open_immutable(file_name.string(), {.mmap_size = 0})};
+
+    ASSERT_EQ(get_pragma(database.get(), "mmap_size"), 0);
+    ASSERT_EQ(std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database.get(), "SELECT COUNT(*) FROM Test")),
+              0);
+  }
+
+  std::filesystem::remove(file_name);
+}
+
+TEST_F(open_options_tests, immutable_file_name_with_reserved_characters_and_leading_slashes_is_encoded)
+{
+  const auto file_name{std::filesystem::temp_directory_path() / "sqlite_wrapper_open_options_test;a=b&c+d@e$f,g!'()*:[].db"};
+
+  sqlite_wrapper::execute_no_data(sqlite_wrapper::open(file_name.string()).get(), "CREATE TABLE Test (Id INTEGER)");
+
+  {
+    // a POSIX path may start with "//", which must not be taken as the authority of the URI
+    const auto database{sqlite_wrapper::open_immutable("/" + file_name.string())};
+
+    ASSERT_EQ(std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database.get(), "SELECT COUNT(*) FROM Test")),
+              0);
+  }
+
+  std::filesystem::remove(file_name);
+}
+
+TEST_F(open_options_tests, immutable_open_of_missing_file_fails)
+{
+  ASSERT_THROWS_WITH_MSG([] { (void)sqlite_wrapper::open_immutable(temp_db_file_name.string()); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("failed to get size of database file"));
+  ASSERT_FALSE(std::filesystem::exists(temp_db_file_name));
+}
+
+TEST_F(open_options_tests, journal_mode_that_does_not_take_effect_fails)
+{
+  ASSERT_THROWS_WITH_MSG([] { (void)sqlite_wrapper::open(":memory:", sqlite_wrapper::open_options::durable_oltp()); },
+                         sqlite_wrapper::sqlite_error, StartsWith("failed to set journal mode wal, journal mode is memory"));
+}
+
+TEST_F(open_options_tests, invalid_options_fail)
+{
+  const auto expect_invalid{[](const sqlite_wrapper::open_options& options, const std::string& message)
+                            {
+                              ASSERT_THROWS_WITH_MSG([&] { sqlite_wrapper::validate(options); }, sqlite_wrapper::sqlite_error,
+                                                     StartsWith("invalid open_options, " + message));
+                              ASSERT_THROWS_WITH_MSG([&] { (void)sqlite_wrapper::open(temp_db_file_name.string(), options); },
+                                                     sqlite_wrapper::sqlite_error,
+                                                     StartsWith("invalid open_options, " + message));
+                            }};
+
+  expect_invalid({.read_only = true}, "read_only requires open_flags::open_only");
+  expect_invalid({.flags = sqlite_wrapper::open_flags::open_only, .read_only = true, .journal = sqlite_wrapper::journal_mode::wal},
+                 "journal mode and page size can not be changed on a read_only connection");
+  expect_invalid({.memory = true, .journal = sqlite_wrapper::journal_mode::wal},
+                 "in-memory databases do not support journal_mode::wal");
+  expect_invalid({.mmap_size = -1}, "mmap_size -1 must not be negative");
+  expect_invalid({.busy_timeout = -1ms}, "busy_timeout -1 ms must not be negative");
+  expect_invalid({.page_size = 1000}, "page_size 1000 must be a power of two from 512 to 65536");
+  expect_invalid({.page_size = 256}, "page_size 256 must be a power of two from 512 to 65536");
+  expect_invalid({.lookaside = sqlite_wrapper::lookaside_config{.slot_size = 100, .slot_count = 1}},
+                 "lookaside slot size 100 must be a multiple of 8");
+  expect_invalid({.flags = static_cast<sqlite_wrapper::open_flags>(999)}, "invalid open_flags value");
+  expect_invalid({.vfs = "unknown_vfs"}, "VFS \"unknown_vfs\" is not registered");
+
+  ASSERT_FALSE(std::filesystem::exists(temp_db_file_name));
+
+  ASSERT_NO_THROW(sqlite_wrapper::validate(sqlite_wrapper::open_options::bulk_load()));
+  ASSERT_NO_THROW(sqlite_wrapper::validate(sqlite_wrapper::open_options::read_mostly()));
+  ASSERT_NO_THROW(sqlite_wrapper::validate(sqlite_wrapper::open_options::durable_oltp()));
+}
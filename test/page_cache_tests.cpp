@@ -0,0 +1,186 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/page_cache.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <tuple>
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class page_cache_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+   protected:
+    void SetUp() override
+    {
+      ASSERT_EQ(::sqlite3_shutdown(), SQLITE_OK);
+      sqlite_wrapper::reset_page_cache_metrics();
+
+      std::filesystem::remove(temp_db_file_name);
+    }
+
+    void TearDown() override
+    {
+      // later tests use the page cache of SQLite again
+      const auto result{::sqlite3_shutdown()};
+      sqlite_wrapper::configure_page_cache({.kind = sqlite_wrapper::page_cache_kind::sqlite_default});
+
+      std::filesystem::remove(temp_db_file_name);
+
+      ASSERT_EQ(result, SQLITE_OK);
+    }
+
+    static void run_queries(int cache_size)
+    {
+      const auto database{sqlite_wrapper::open(temp_db_file_name.string())};
+
+      sqlite_wrapper::execute_no_data(database.get(), "PRAGMA cache_size = " + std::to_string(cache_size));
+      sqlite_wrapper::execute_no_data(database.get(), "CREATE TABLE Test (Id INTEGER PRIMARY KEY, Data TEXT)");
+      sqlite_wrapper::execute_no_data(database.get(), "CREATE INDEX TestData ON Test (Data)");
+      sqlite_wrapper::execute_no_data(database.get(), "BEGIN");
+
+      for (std::int64_t id{0}; id < 10'000; ++id)
+      {
+        sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (?1, printf('%d %d', ?1, random()))", id);
+      }
+
+      sqlite_wrapper::execute_no_data(database.get(), "COMMIT");
+      sqlite_wrapper::execute_no_data(database.get(), "DELETE FROM Test WHERE Id % 2 = 0");
+      sqlite_wrapper::execute_no_data(database.get(), "VACUUM");
+
+      const auto [count] = sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(
+          database.get(), "SELECT count(*) FROM Test WHERE Data > ?1", "");
+      const auto [result] = sqlite_wrapper::execute_one_row<std::tuple<std::string>>(database.get(), "PRAGMA integrity_check");
+
+      ASSERT_EQ(count, 5'000);
+      ASSERT_EQ(result, "ok");
+    }
+  };
+
+  const std::filesystem::path page_cache_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                  "sqlite_wrapper_page_cache_test.db"};
+}  // unnamed namespace
+
+TEST_F(page_cache_tests, slabs_serve_sqlite)
+{
+  sqlite_wrapper::configure_page_cache();
+
+  run_queries(100);
+
+  const auto metrics{sqlite_wrapper::get_page_cache_metrics()};
+
+  ASSERT_GT(metrics.hits, 0U);
+  ASSERT_GT(metrics.creations, 0U);
+  ASSERT_GT(metrics.evictions, 0U);
+  ASSERT_GT(metrics.slabs, 0U);
+  ASSERT_EQ(metrics.over_budget_slabs, 0U);
+  ASSERT_EQ(metrics.bytes_reserved, 0);
+}
+
+TEST_F(page_cache_tests, pages_are_reused_at_budget)
+{
+  constexpr std::size_t slab_size{sqlite_wrapper::page_cache_options::slab_alignment};
+
+  sqlite_wrapper::configure_page_cache(
+      {.budget = 4 * slab_size, .slab_size = slab_size, .huge_pages = sqlite_wrapper::huge_pages::none});
+
+  run_queries(1'000'000);
+
+  const auto metrics{sqlite_wrapper::get_page_cache_metrics()};
+
+  ASSERT_GT(metrics.evictions, 0U);
+  ASSERT_EQ(metrics.huge_page_slabs, 0U);
+  ASSERT_EQ(metrics.bytes_reserved, 0);
+}
+
+TEST_F(page_cache_tests, memory_database_keeps_pages_beyond_budget)
+{
+  constexpr std::size_t slab_size{sqlite_wrapper::page_cache_options::slab_alignment};
+
+  sqlite_wrapper::configure_page_cache({.budget = slab_size, .slab_size = slab_size});
+
+  const auto database{sqlite_wrapper::open(":memory:")};
+
+  sqlite_wrapper::execute_no_data(database.get(), "CREATE TABLE Test (Id INTEGER PRIMARY KEY, Data TEXT)");
+  sqlite_wrapper::execute_no_data(database.get(), "BEGIN");
+
+  for (std::int64_t id{0}; id < 10'000; ++id)
+  {
+    sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (?1, printf('%d %d', ?1, random()))", id);
+  }
+
+  sqlite_wrapper::execute_no_data(database.get(), "COMMIT");
+
+  // the pages of an in-memory database are neither reused at the budget nor released
+  ASSERT_EQ(::sqlite3_db_release_memory(database.get()), SQLITE_OK);
+
+  const auto [count] = sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(
+      database.get(), "SELECT count(*) FROM Test WHERE Data > ?1", "");
+  const auto [result] = sqlite_wrapper::execute_one_row<std::tuple<std::string>>(database.get(), "PRAGMA integrity_check");
+
+  ASSERT_EQ(count, 10'000);
+  ASSERT_EQ(result, "ok");
+
+  const auto metrics{sqlite_wrapper::get_page_cache_metrics()};
+
+  ASSERT_EQ(metrics.evictions, 0U);
+  ASSERT_GT(metrics.over_budget_slabs, 0U);
+}
+
+TEST_F(page_cache_tests, small_caches_take_small_slabs)
+{
+  sqlite_wrapper::configure_page_cache();
+
+  const auto database{sqlite_wrapper::open(":memory:")};
+
+  sqlite_wrapper::execute_no_data(database.get(), "CREATE TABLE Test (Id INTEGER PRIMARY KEY)");
+  sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (1)");
+
+  const auto metrics{sqlite_wrapper::get_page_cache_metrics()};
+
+  ASSERT_EQ(metrics.slabs, 1U);
+  ASSERT_EQ(metrics.bytes_reserved, static_cast<std::int64_t>(sqlite_wrapper::page_cache_options::slab_alignment));
+}
+
+TEST_F(page_cache_tests, sqlite_default_is_not_counted)
+{
+  sqlite_wrapper::configure_page_cache({.kind = sqlite_wrapper::page_cache_kind::sqlite_default});
+
+  run_queries(100);
+
+  ASSERT_EQ(sqlite_wrapper::get_page_cache_metrics().fetches, 0U);
+}
+
+TEST_F(page_cache_tests, configuring_initialized_sqlite_fails)
+{
+  const auto database{sqlite_wrapper::open(":memory:")};
+
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::configure_page_cache(); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("configure_page_cache() must be called before SQLite is initialized"));
+}
+
+TEST_F(page_cache_tests, invalid_options_fail)
+{
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::configure_page_cache({.budget = 0}); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid page_cache_options, budget must be > 0"));
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::configure_page_cache({.slab_size = 1000}); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid page_cache_options, slab_size 1000 must be a multiple of 65536 and > 0"));
+  ASSERT_THROWS_WITH_MSG(
+      [] { sqlite_wrapper::configure_page_cache({.huge_pages = static_cast<sqlite_wrapper::huge_pages>(42)}); },
+      sqlite_wrapper::sqlite_error, StartsWith("invalid page_cache_options, unknown huge pages 42"));
+}
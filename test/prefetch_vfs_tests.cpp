@@ -0,0 +1,169 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/prefetch_vfs.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <tuple>
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class prefetch_vfs_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+    static constexpr int row_count{10'000};
+
+   protected:
+    void SetUp() override
+    {
+      remove_database_files();
+
+      sqlite_wrapper::register_prefetch_vfs();
+
+      const auto database{sqlite_wrapper::open(temp_db_file_name.string())};
+
+      sqlite_wrapper::execute_no_data(database.get(), "CREATE TABLE Test (Id INTEGER PRIMARY KEY, Data BLOB)");
+      sqlite_wrapper::execute_no_data(database.get(), "BEGIN");
+
+      for (int id{0}; id < row_count; ++id)
+      {
+        sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (?1, randomblob(500))", id);
+      }
+
+      sqlite_wrapper::execute_no_data(database.get(), "COMMIT");
+
+      sqlite_wrapper::reset_prefetch_vfs_metrics();
+    }
+
+    void TearDown() override
+    {
+      remove_database_files();
+    }
+
+    static void remove_database_files()
+    {
+      std::filesystem::remove(temp_db_file_name);
+      std::filesystem::remove(temp_db_file_name.string() + "-journal");
+    }
+
+    [[nodiscard]] static auto open() -> sqlite_wrapper::database
+    {
+      // a small page cache, so all pages are read from the file
+      return sqlite_wrapper::open(temp_db_file_name.string(), {.cache_size = -64, .vfs = sqlite_wrapper::prefetch_vfs_name});
+    }
+  };
+
+  const std::filesystem::path prefetch_vfs_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                    "sqlite_wrapper_prefetch_vfs_test.db"};
+}  // unnamed namespace
+
+TEST_F(prefetch_vfs_tests, scan_is_prefetched)
+{
+#ifndef __linux__
+  GTEST_SKIP() << "prefetching is only done on Linux";
+#endif
+
+  const auto database{open()};
+
+  const auto [size] =
+      sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database.get(), "SELECT SUM(LENGTH(Data)) FROM Test");
+
+  ASSERT_EQ(size, row_count * 500);
+
+  const auto metrics{sqlite_wrapper::get_prefetch_vfs_metrics()};
+
+  ASSERT_GT(metrics.reads, 1000U);
+  ASSERT_GT(metrics.sequential_reads, metrics.reads / 2);
+  ASSERT_GT(metrics.prefetches, 1U);
+  ASSERT_GT(metrics.prefetched_bytes, sqlite_wrapper::prefetch_vfs_options::default_min_window);
+  ASSERT_EQ(metrics.hits + metrics.misses, metrics.reads);
+  ASSERT_GT(metrics.hit_ratio(), 0.9);
+}
+
+TEST_F(prefetch_vfs_tests, scan_below_previous_scan_is_prefetched)
+{
+#ifndef __linux__
+  GTEST_SKIP() << "prefetching is only done on Linux";
+#endif
+
+  {
+    const auto database{sqlite_wrapper::open(temp_db_file_name.string())};
+
+    // behind the pages of table Test in the file
+    sqlite_wrapper::execute_no_data(database.get(), "CREATE TABLE Other AS SELECT * FROM Test");
+  }
+
+  const auto database{open()};
+
+  for (const auto* const sql : {"SELECT SUM(LENGTH(Data)) FROM Other", "SELECT SUM(LENGTH(Data)) FROM Test"})
+  {
+    sqlite_wrapper::reset_prefetch_vfs_metrics();
+
+    const auto [size] = sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database.get(), sql);
+
+    ASSERT_EQ(size, row_count * 500);
+
+    const auto metrics{sqlite_wrapper::get_prefetch_vfs_metrics()};
+
+    ASSERT_GT(metrics.prefetches, 1U) << sql;
+    ASSERT_GT(metrics.hit_ratio(), 0.9) << sql;
+  }
+}
+
+TEST_F(prefetch_vfs_tests, random_reads_are_not_prefetched)
+{
+  const auto database{open()};
+
+  for (int i{0}; i < 200; ++i)
+  {
+    // NOLINTNEXTLINE(readability-magic-numbers) large prime to jump around
+    const auto id{(i * 7919) % row_count};
+
+    std::ignore = sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(
+        database.get(), "SELECT LENGTH(Data) FROM Test WHERE Id = ?1", id);
+  }
+
+  const auto metrics{sqlite_wrapper::get_prefetch_vfs_metrics()};
+
+  ASSERT_GT(metrics.reads, 200U);
+  ASSERT_EQ(metrics.prefetches, 0U);
+  ASSERT_EQ(metrics.hits, 0U);
+}
+
+TEST_F(prefetch_vfs_tests, writes_are_seen_by_other_connections)
+{
+  const auto database{open()};
+  const auto other{sqlite_wrapper::open(temp_db_file_name.string())};
+
+  sqlite_wrapper::execute_no_data(database.get(), "DELETE FROM Test WHERE Id % 2 = 0");
+
+  ASSERT_EQ(std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(other.get(), "SELECT COUNT(*) FROM Test")),
+            row_count / 2);
+
+  sqlite_wrapper::execute_no_data(other.get(), "INSERT INTO Test VALUES (?1, NULL)", row_count);
+
+  ASSERT_EQ(std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database.get(), "SELECT COUNT(*) FROM Test")),
+            (row_count / 2) + 1);
+}
+
+TEST_F(prefetch_vfs_tests, invalid_options_fail)
+{
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::register_prefetch_vfs({.trigger_reads = 0}); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid prefetch_vfs_options, trigger_reads must be > 0"));
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::register_prefetch_vfs({.min_window = 0}); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid prefetch_vfs_options, min_window 0 must be > 0 and <= max_window"));
+  ASSERT_THROWS_WITH_MSG([] { sqlite_wrapper::register_prefetch_vfs({.min_window = 2, .max_window = 1}); },
+                         sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid prefetch_vfs_options, min_window 2 must be > 0 and <= max_window 1"));
+}
@@ -0,0 +1,124 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/memory_database.h"
+#include "sqlite_wrapper/serialize.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <tuple>
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class serialize_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+   protected:
+    void SetUp() override
+    {
+      std::filesystem::remove(temp_db_file_name);
+    }
+
+    void TearDown() override
+    {
+      std::filesystem::remove(temp_db_file_name);
+    }
+
+    [[nodiscard]] static auto count_rows(const sqlite_wrapper::db_with_location& database) -> std::int64_t
+    {
+      return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database, "SELECT COUNT(*) FROM Test"));
+    }
+
+    [[nodiscard]] static auto create_image() -> sqlite_wrapper::byte_vector
+    {
+      const auto database{sqlite_wrapper::open(temp_db_file_name.string())};
+
+      sqlite_wrapper::execute_no_data(database.get(), "CREATE TABLE Test (Id INTEGER)");
+      sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (1), (2)");
+
+      return sqlite_wrapper::serialize(database.get());
+    }
+  };
+
+  const std::filesystem::path serialize_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                 "sqlite_wrapper_serialize_test.db"};
+}  // unnamed namespace
+
+TEST_F(serialize_tests, serialize_empty_database)
+{
+  const auto database{sqlite_wrapper::open_memory()};
+
+  ASSERT_TRUE(sqlite_wrapper::serialize(database.get()).empty());
+}
+
+TEST_F(serialize_tests, serialize_file_database_returns_file_content)
+{
+  const auto image{create_image()};
+
+  ASSERT_EQ(image.size(), std::filesystem::file_size(temp_db_file_name));
+}
+
+TEST_F(serialize_tests, deserialize_copy_is_writable)
+{
+  const auto image{create_image()};
+  const auto database{sqlite_wrapper::open_memory()};
+
+  sqlite_wrapper::deserialize(database.get(), image);
+
+  ASSERT_EQ(count_rows(database.get()), 2);
+
+  sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (3)");
+
+  ASSERT_EQ(count_rows(database.get()), 3);
+
+  const auto copy{sqlite_wrapper::open_memory()};
+
+  sqlite_wrapper::deserialize(copy.get(), sqlite_wrapper::serialize(database.get()));
+
+  ASSERT_EQ(count_rows(copy.get()), 3);
+}
+
+TEST_F(serialize_tests, deserialize_read_only_copy_is_not_writable)
+{
+  const auto database{sqlite_wrapper::open_memory()};
+
+  sqlite_wrapper::deserialize(database.get(), create_image(), sqlite_wrapper::deserialize_mode::read_only_copy);
+
+  ASSERT_EQ(count_rows(database.get()), 2);
+  ASSERT_THROWS_WITH_MSG([&database] { sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (3)"); },
+                         sqlite_wrapper::sqlite_error, StartsWith("failed to step, failed with: attempt to write a readonly"));
+}
+
+TEST_F(serialize_tests, deserialize_read_only_view_uses_image_in_place)
+{
+  const auto image{create_image()};
+  const auto database{sqlite_wrapper::open_memory()};
+
+  sqlite_wrapper::deserialize(database.get(), image, sqlite_wrapper::deserialize_mode::read_only_view);
+
+  ASSERT_EQ(count_rows(database.get()), 2);
+  ASSERT_THROWS_WITH_MSG([&database] { sqlite_wrapper::execute_no_data(database.get(), "INSERT INTO Test VALUES (3)"); },
+                         sqlite_wrapper::sqlite_error, StartsWith("failed to step, failed with: attempt to write a readonly"));
+  ASSERT_EQ(sqlite_wrapper::serialize(database.get()), image);
+}
+
+TEST_F(serialize_tests, unknown_schema_fails)
+{
+  const auto database{sqlite_wrapper::open_memory()};
+
+  ASSERT_THROWS_WITH_MSG([&database] { std::ignore = sqlite_wrapper::serialize(database.get(), "unknown"); },
+                         sqlite_wrapper::sqlite_error,
+                         StartsWith("sqlite3_serialize() failed to serialize database \"unknown\""));
+  ASSERT_THROWS_WITH_MSG(
+      [&database] { sqlite_wrapper::deserialize(database.get(), {}, sqlite_wrapper::deserialize_mode::copy, "unknown"); },
+      sqlite_wrapper::sqlite_error, StartsWith("sqlite3_deserialize() failed to deserialize database \"unknown\""));
+}
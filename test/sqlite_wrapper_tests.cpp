@@ -22,6 +22,7 @@
 #include <source_location>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -355,6 +356,10 @@ TEST_F(sqlite_wrapper_tests, test_open_fails)
             sqlite_wrapper::stack_trace_contains_function_in("test_open_fails", std::source_location::current().file_name())));
 }
 
+// with SQLITE_WRAPPER_STRIP_LOCATION with_location is a zero-overhead passthrough, open() records its location anyway
+static_assert(sqlite_wrapper::are_locations_recorded() ||
+              (sizeof(sqlite_wrapper::stmt_with_location) == sizeof(::sqlite3_stmt*)));
+
 TEST_F(sqlite_wrapper_tests, test_open_failes_get_location)
 {
   std::source_location location{};
@@ -447,3 +452,157 @@ TEST_F(sqlite_wrapper_tests, test_simple_select_query_tuple_like_type)
     ASSERT_EQ(std::get<0>(*(row_iter++)), column_int) << "Returned row data does not match inserted row!";
   }
 }
+
+static_assert(sqlite_wrapper::to_underlying(sqlite_wrapper::sqlite_errc::busy_snapshot) == SQLITE_BUSY_SNAPSHOT);
+static_assert(sqlite_wrapper::to_underlying(sqlite_wrapper::sqlite_errc::locked_sharedcache) == SQLITE_LOCKED_SHAREDCACHE);
+static_assert(sqlite_wrapper::to_underlying(sqlite_wrapper::sqlite_errc::constraint_datatype) == SQLITE_CONSTRAINT_DATATYPE);
+static_assert(sqlite_wrapper::to_underlying(sqlite_wrapper::sqlite_errc::done) == SQLITE_DONE);
+
+TEST_F(sqlite_wrapper_tests, test_sqlite_errc_as_error_code)
+{
+  const std::error_code error{sqlite_wrapper::sqlite_errc::busy};
+
+  ASSERT_STREQ(error.category().name(), "sqlite");
+  ASSERT_EQ(error.value(), SQLITE_BUSY);
+  ASSERT_THAT(error.message(), StrEq("database is locked"));
+  ASSERT_EQ(sqlite_wrapper::get_error_string(sqlite_wrapper::sqlite_errc::constraint_unique), "constraint failed");
+}
+
+TEST_F(sqlite_wrapper_tests, test_try_execute_no_data_returns_extended_error_codes)
+{
+  const auto database{set_up_test_database()};
+
+  constexpr auto insert_sql{R"(INSERT INTO "Test" ("Id", "Int", "String", "Double", "Blob") VALUES (?, ?, ?, ?, ?))"sv};
+  const sqlite_wrapper::byte_vector blob{std::byte{1}};
+
+  ASSERT_TRUE(sqlite_wrapper::try_execute_no_data(database.get(), insert_sql, 1, 2, "three", 4.0, blob).has_value());
+
+  const auto primary_key_result{sqlite_wrapper::try_execute_no_data(database.get(), insert_sql, 1, 2, "three", 4.0, blob)};
+  ASSERT_FALSE(primary_key_result.has_value());
+  ASSERT_EQ(primary_key_result.error(), sqlite_wrapper::sqlite_errc::constraint_primarykey);
+
+  const auto not_null_result{sqlite_wrapper::try_execute_no_data(database.get(), insert_sql, 2, nullptr, "three", 4.0, blob)};
+  ASSERT_FALSE(not_null_result.has_value());
+  ASSERT_EQ(not_null_result.error(), sqlite_wrapper::sqlite_errc::constraint_notnull);
+
+  const auto range_result{sqlite_wrapper::try_execute_no_data(database.get(), insert_sql, 2, 2, "three", 4.0, blob, 6)};
+  ASSERT_FALSE(range_result.has_value());
+  ASSERT_EQ(range_result.error(), sqlite_wrapper::sqlite_errc::range);
+
+  const auto syntax_result{sqlite_wrapper::try_execute_no_data(database.get(), "NOT SQL")};
+  ASSERT_FALSE(syntax_result.has_value());
+  ASSERT_EQ(syntax_result.error(), sqlite_wrapper::sqlite_errc::error);
+
+  const auto data_row_result{sqlite_wrapper::try_execute_no_data(database.get(), select_all_from_test_table)};
+  ASSERT_FALSE(data_row_result.has_value());
+  ASSERT_EQ(data_row_result.error(), sqlite_wrapper::sqlite_errc::row);
+}
+
+TEST_F(sqlite_wrapper_tests, test_try_execute)
+{
+  const auto database{set_up_test_database()};
+  const auto rows{fill_test_database(database.get())};
+
+  const auto result{sqlite_wrapper::try_execute<row_type>(
+      database.get(),
+      R"(SELECT "Int", "String", "Double", "Blob", "OptInt", "OptString", "OptDouble", "OptBlob" FROM "Test")"sv)};
+
+  ASSERT_TRUE(result.has_value());
+  ASSERT_EQ(*result, rows);
+
+  const auto limited_result{sqlite_wrapper::try_execute<std::tuple<std::int64_t>>(
+      database.get(), sqlite_wrapper::row_limit{1}, R"(SELECT "Id" FROM "Test" WHERE "Id" > ?)"sv, 1)};
+
+  ASSERT_TRUE(limited_result.has_value());
+  ASSERT_EQ(*limited_result, std::vector<std::tuple<std::int64_t>>{{2}});
+
+  const auto failed_result{sqlite_wrapper::try_execute<std::tuple<std::int64_t>>(database.get(), "SELECT * FROM NotATable")};
+
+  ASSERT_FALSE(failed_result.has_value());
+  ASSERT_EQ(failed_result.error(), sqlite_wrapper::sqlite_errc::error);
+}
+
+TEST_F(sqlite_wrapper_tests, test_sqlite_error_codes_and_lazy_message)
+{
+  const auto database{set_up_test_database()};
+
+  constexpr auto insert_sql{R"(INSERT INTO "Test" ("Id", "Int", "String", "Double", "Blob") VALUES (?, ?, ?, ?, ?))"sv};
+  const sqlite_wrapper::byte_vector blob{std::byte{1}};
+
+  sqlite_wrapper::execute_no_data(database.get(), insert_sql, 1, 2, "three", 4.0, blob);
+
+  try
+  {
+    sqlite_wrapper::execute_no_data(database.get(), insert_sql, 1, 2, "three", 4.0, blob);
+    FAIL() << "expected sqlite_error";
+  }
+  catch (const sqlite_wrapper::sqlite_error& e)
+  {
+    ASSERT_EQ(e.code(), sqlite_wrapper::sqlite_errc::constraint);
+    ASSERT_EQ(e.extended_code(), sqlite_wrapper::sqlite_errc::constraint_primarykey);
+
+    // the error state of the connection changes, the message must still show the original error
+    ASSERT_FALSE(sqlite_wrapper::try_execute_no_data(database.get(), "NOT SQL").has_value());
+
+    const auto* what{e.what()};
+    ASSERT_THAT(what, AllOf(StartsWith("failed to step, failed with: UNIQUE constraint failed"), HasSubstr(insert_sql)));
+    ASSERT_EQ(what, e.what());
+  }
+}
+
+TEST_F(sqlite_wrapper_tests, test_moved_from_sqlite_error_keeps_message)
+{
+  sqlite_wrapper::sqlite_error error{"failed operation", SQLITE_BUSY};
+
+  auto moved{std::move(error)};
+
+  // NOLINTBEGIN(bugprone-use-after-move,hicpp-invalid-access-moved) what() must stay valid
+  ASSERT_THAT(error.what(), StartsWith("failed operation, failed with: database is locked"));
+  ASSERT_STREQ(moved.what(), error.what());
+
+  sqlite_wrapper::sqlite_error assigned{"other operation", SQLITE_MISUSE};
+  assigned = std::move(moved);
+
+  ASSERT_STREQ(moved.what(), assigned.what());
+  // NOLINTEND(bugprone-use-after-move,hicpp-invalid-access-moved)
+}
+
+TEST_F(sqlite_wrapper_tests, test_scoped_stack_trace_capture)
+{
+  ASSERT_EQ(sqlite_wrapper::is_stack_trace_capture_enabled(), sqlite_wrapper::are_stack_traces_supported());
+
+  {
+    const sqlite_wrapper::scoped_stack_trace_capture no_stack_traces{false};
+
+    ASSERT_FALSE(sqlite_wrapper::is_stack_trace_capture_enabled());
+
+    try
+    {
+      (void)sqlite_wrapper::open(temp_db_file_name.string(), sqlite_wrapper::open_flags::open_only);
+      FAIL() << "expected sqlite_error";
+    }
+    catch (const sqlite_wrapper::sqlite_error& e)
+    {
+      ASSERT_TRUE(e.stack_trace().empty());
+      ASSERT_EQ(e.code(), sqlite_wrapper::sqlite_errc::cantopen);
+    }
+  }
+
+  ASSERT_EQ(sqlite_wrapper::is_stack_trace_capture_enabled(), sqlite_wrapper::are_stack_traces_supported());
+}
+
+TEST_F(sqlite_wrapper_tests, test_execute_one_row)
+{
+  const auto database{set_up_test_database()};
+  const auto rows{fill_test_database(database.get(), 2, random_data_generator::default_string_and_blob_size_limit)};
+
+  const auto [id, int_val] = sqlite_wrapper::execute_one_row<std::tuple<std::int64_t, std::int64_t>>(
+      database.get(), R"(SELECT "Id", "Int" FROM "Test" WHERE "Id" = ?)"sv, 2);
+
+  ASSERT_EQ(id, 2);
+  ASSERT_EQ(int_val, std::get<0>(rows[1]));
+
+  ASSERT_THROWS_WITH_MSG(
+      [&] { (void)sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database.get(), R"(SELECT "Id" FROM "Test")"sv); },
+      sqlite_wrapper::sqlite_error, StartsWith("expected exactly one row but found more"));
+}
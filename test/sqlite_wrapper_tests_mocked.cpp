@@ -477,10 +477,13 @@ namespace
         .WillOnce(Return(error_message))
         .RetiresOnSaturation();
 
-    EXPECT_CALL(*get_mock(), sqlite3_errstr(sqlite_error))
+    EXPECT_CALL(*get_mock(), sqlite3_extended_errcode(database.value))
         .InSequence(sequence)
-        .WillOnce(Return(sqlite_errstr))
+        .WillOnce(Return(sqlite_error))
         .RetiresOnSaturation();
+
+    // the message is formatted lazily by what(), i.e. after the statement might already be finalized
+    EXPECT_CALL(*get_mock(), sqlite3_errstr(sqlite_error)).WillOnce(Return(sqlite_errstr)).RetiresOnSaturation();
   }
 
   auto to_byte_vector(std::string_view str) -> sqlite_wrapper::byte_vector
@@ -758,6 +761,7 @@ TEST_F(sqlite_wrapper_mocked_tests, create_prepared_statement_fails)
       .WillOnce(Return(SQLITE_MISUSE));
 
   EXPECT_CALL(*get_mock(), sqlite3_errmsg(&database)).WillOnce(Return(sqlite_error_message));
+  EXPECT_CALL(*get_mock(), sqlite3_extended_errcode(&database)).WillOnce(Return(SQLITE_MISUSE));
   EXPECT_CALL(*get_mock(), sqlite3_errstr(SQLITE_MISUSE)).WillOnce(Return(sqlite_errstr));
 
   ASSERT_THROWS_WITH_MSG_AND_STACK(
@@ -1213,3 +1217,212 @@ TEST_F(sqlite_wrapper_mocked_tests, execute_with_and_wo_limits_success)
     ASSERT_EQ(result_rows[i], expected_rows[i]);
   }
 }
+
+TEST_F(sqlite_wrapper_mocked_tests, try_step_success)
+{
+  ::sqlite3_stmt statement{};
+
+  const Sequence sequence{};
+
+  EXPECT_CALL(*get_mock(), sqlite3_step(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_ROW)).RetiresOnSaturation();
+  EXPECT_CALL(*get_mock(), sqlite3_step(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_DONE)).RetiresOnSaturation();
+
+  const auto first{sqlite_wrapper::try_step(&statement)};
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(*first);
+
+  const auto second{sqlite_wrapper::try_step(&statement)};
+  ASSERT_TRUE(second.has_value());
+  ASSERT_FALSE(*second);
+}
+
+TEST_F(sqlite_wrapper_mocked_tests, try_step_fails_with_extended_error_code)
+{
+  ::sqlite3 database{};
+  ::sqlite3_stmt statement{};
+
+  const Sequence sequence{};
+
+  EXPECT_CALL(*get_mock(), sqlite3_step(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_BUSY));
+  EXPECT_CALL(*get_mock(), sqlite3_db_handle(&statement)).InSequence(sequence).WillOnce(Return(&database));
+  EXPECT_CALL(*get_mock(), sqlite3_extended_errcode(&database)).InSequence(sequence).WillOnce(Return(SQLITE_BUSY_SNAPSHOT));
+
+  const auto result{sqlite_wrapper::try_step(&statement)};
+
+  ASSERT_FALSE(result.has_value());
+  ASSERT_EQ(result.error(), sqlite_wrapper::sqlite_errc::busy_snapshot);
+  ASSERT_EQ(sqlite_wrapper::primary_code(result.error()), sqlite_wrapper::sqlite_errc::busy);
+}
+
+TEST_F(sqlite_wrapper_mocked_tests, try_step_fails_with_unrelated_extended_error_code)
+{
+  ::sqlite3 database{};
+  ::sqlite3_stmt statement{};
+
+  const Sequence sequence{};
+
+  EXPECT_CALL(*get_mock(), sqlite3_step(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_MISUSE));
+  EXPECT_CALL(*get_mock(), sqlite3_db_handle(&statement)).InSequence(sequence).WillOnce(Return(&database));
+  EXPECT_CALL(*get_mock(), sqlite3_extended_errcode(&database)).InSequence(sequence).WillOnce(Return(SQLITE_BUSY_SNAPSHOT));
+
+  const auto result{sqlite_wrapper::try_step(&statement)};
+
+  ASSERT_FALSE(result.has_value());
+  ASSERT_EQ(result.error(), sqlite_wrapper::sqlite_errc::misuse);
+}
+
+TEST_F(sqlite_wrapper_mocked_tests, try_create_prepared_statement_fails)
+{
+  ::sqlite3 database{};
+
+  EXPECT_CALL(*get_mock(),
+              sqlite3_prepare_v2(&database, StrEq(dummy_sql), static_cast<int>(dummy_sql.size()), NotNull(), IsNull()))
+      .WillOnce(Return(SQLITE_BUSY));
+  EXPECT_CALL(*get_mock(), sqlite3_extended_errcode(&database)).WillOnce(Return(SQLITE_BUSY_RECOVERY));
+
+  const auto result{sqlite_wrapper::try_create_prepared_statement(&database, dummy_sql, 4711)};
+
+  ASSERT_FALSE(result.has_value());
+  ASSERT_EQ(result.error(), sqlite_wrapper::sqlite_errc::busy_recovery);
+}
+
+TEST_F(sqlite_wrapper_mocked_tests, try_create_prepared_statement_fails_with_nullptr)
+{
+  ::sqlite3 database{};
+
+  EXPECT_CALL(*get_mock(),
+              sqlite3_prepare_v2(&database, StrEq(dummy_sql), static_cast<int>(dummy_sql.size()), NotNull(), IsNull()))
+      .WillOnce(DoAll(SetArgPointee<3>(nullptr), Return(SQLITE_OK)));
+
+  const auto result{sqlite_wrapper::try_create_prepared_statement(&database, dummy_sql)};
+
+  ASSERT_FALSE(result.has_value());
+  ASSERT_EQ(result.error(), sqlite_wrapper::sqlite_errc::misuse);
+}
+
+TEST_F(sqlite_wrapper_mocked_tests, try_create_prepared_statement_binding_fails)
+{
+  ::sqlite3 database{};
+  ::sqlite3_stmt statement{};
+  const Sequence sequence{};
+
+  EXPECT_CALL(*get_mock(),
+              sqlite3_prepare_v2(&database, StrEq(dummy_sql), static_cast<int>(dummy_sql.size()), NotNull(), IsNull()))
+      .InSequence(sequence)
+      .WillOnce(DoAll(SetArgPointee<3>(&statement), Return(SQLITE_OK)));
+
+  expect_int64_bind(4711)(&statement, 1, sequence, SQLITE_OK);
+  expect_double_bind(1.23)(&statement, 2, sequence, SQLITE_RANGE);
+
+  // binding stops at the first error, the third parameter is never bound
+  EXPECT_CALL(*get_mock(), sqlite3_finalize(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_OK));
+
+  const auto result{sqlite_wrapper::try_create_prepared_statement(&database, dummy_sql, 4711, 1.23, "not bound")};
+
+  ASSERT_FALSE(result.has_value());
+  ASSERT_EQ(result.error(), sqlite_wrapper::sqlite_errc::range);
+}
+
+TEST_F(sqlite_wrapper_mocked_tests, try_execute_no_data_success)
+{
+  constexpr auto int_val{4711};
+
+  ::sqlite3 database{};
+  ::sqlite3_stmt statement{};
+  const Sequence sequence{};
+
+  expect_statement(&database, statement, sequence, dummy_sql, {expect_int64_bind(int_val)});
+
+  EXPECT_CALL(*get_mock(), sqlite3_step(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_DONE));
+  EXPECT_CALL(*get_mock(), sqlite3_finalize(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_OK));
+
+  ASSERT_TRUE(sqlite_wrapper::try_execute_no_data(&database, dummy_sql, int_val).has_value());
+}
+
+TEST_F(sqlite_wrapper_mocked_tests, try_execute_no_data_fails)
+{
+  ::sqlite3 database{};
+  ::sqlite3_stmt statement{};
+  const Sequence sequence{};
+
+  expect_statement(&database, statement, sequence, dummy_sql, {});
+
+  EXPECT_CALL(*get_mock(), sqlite3_step(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_CONSTRAINT));
+  EXPECT_CALL(*get_mock(), sqlite3_db_handle(&statement)).InSequence(sequence).WillOnce(Return(&database));
+  EXPECT_CALL(*get_mock(), sqlite3_extended_errcode(&database))
+      .InSequence(sequence)
+      .WillOnce(Return(SQLITE_CONSTRAINT_UNIQUE));
+  EXPECT_CALL(*get_mock(), sqlite3_finalize(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_CONSTRAINT));
+
+  const auto result{sqlite_wrapper::try_execute_no_data(&database, dummy_sql)};
+
+  ASSERT_FALSE(result.has_value());
+  ASSERT_EQ(result.error(), sqlite_wrapper::sqlite_errc::constraint_unique);
+}
+
+TEST_F(sqlite_wrapper_mocked_tests, try_execute_no_data_fails_with_data_row)
+{
+  ::sqlite3 database{};
+  ::sqlite3_stmt statement{};
+  const Sequence sequence{};
+
+  expect_statement(&database, statement, sequence, dummy_sql, {});
+
+  EXPECT_CALL(*get_mock(), sqlite3_step(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_ROW));
+  EXPECT_CALL(*get_mock(), sqlite3_finalize(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_OK));
+
+  const auto result{sqlite_wrapper::try_execute_no_data(&database, dummy_sql)};
+
+  ASSERT_FALSE(result.has_value());
+  ASSERT_EQ(result.error(), sqlite_wrapper::sqlite_errc::row);
+}
+
+TEST_F(sqlite_wrapper_mocked_tests, try_execute_success)
+{
+  using row_type = std::tuple<std::int64_t, std::string>;
+
+  const std::vector<row_type> expected_rows{{4711, "hello world 1"}, {4712, "hello world 2"}};
+
+  ::sqlite3 database{};
+  ::sqlite3_stmt statement{};
+  const Sequence sequence{};
+
+  expect_statement(&database, statement, sequence, dummy_sql, {});
+
+  for (const auto& row : expected_rows)
+  {
+    EXPECT_CALL(*get_mock(), sqlite3_step(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_ROW)).RetiresOnSaturation();
+    expect_row(&statement, row, sequence);
+  }
+
+  EXPECT_CALL(*get_mock(), sqlite3_step(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_DONE)).RetiresOnSaturation();
+  EXPECT_CALL(*get_mock(), sqlite3_finalize(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_OK));
+
+  const auto result{sqlite_wrapper::try_execute<row_type>(&database, dummy_sql)};
+
+  ASSERT_TRUE(result.has_value());
+  ASSERT_EQ(*result, expected_rows);
+}
+
+TEST_F(sqlite_wrapper_mocked_tests, try_execute_fails)
+{
+  using row_type = std::tuple<std::int64_t>;
+
+  ::sqlite3 database{};
+  ::sqlite3_stmt statement{};
+  const Sequence sequence{};
+
+  expect_statement(&database, statement, sequence, dummy_sql, {});
+
+  EXPECT_CALL(*get_mock(), sqlite3_step(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_ROW)).RetiresOnSaturation();
+  expect_row(&statement, row_type{4711}, sequence);
+  EXPECT_CALL(*get_mock(), sqlite3_step(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_LOCKED)).RetiresOnSaturation();
+  EXPECT_CALL(*get_mock(), sqlite3_db_handle(&statement)).InSequence(sequence).WillOnce(Return(&database));
+  EXPECT_CALL(*get_mock(), sqlite3_extended_errcode(&database)).InSequence(sequence).WillOnce(Return(SQLITE_LOCKED));
+  EXPECT_CALL(*get_mock(), sqlite3_finalize(&statement)).InSequence(sequence).WillOnce(Return(SQLITE_LOCKED));
+
+  const auto result{sqlite_wrapper::try_execute<row_type>(&database, dummy_sql)};
+
+  ASSERT_FALSE(result.has_value());
+  ASSERT_EQ(result.error(), sqlite_wrapper::sqlite_errc::locked);
+}
@@ -1,3 +1,5 @@
+#include "sqlite_wrapper/sqlite_error.h"
+
 #include <gtest/gtest.h>
 
 extern "C"
@@ -37,5 +39,8 @@ auto main(int argc, char** argv) -> int
   // GTest takes ownership and frees object NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
   testing::UnitTest::GetInstance()->listeners().Append(new ThrowListener);
 
+  // the tests check the stack traces of exceptions, all tests run in the main thread
+  sqlite_wrapper::set_stack_trace_capture(true);
+
   return RUN_ALL_TESTS();
 }
@@ -0,0 +1,126 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+#include "sqlite_wrapper/thread_bound_database.h"
+
+#include <sqlite3.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <tuple>
+
+using ::testing::StartsWith;
+
+namespace
+{
+  constexpr auto* in_memory_database{":memory:"};
+
+  [[nodiscard]] auto select_one(const sqlite_wrapper::thread_bound_database& database) -> std::int64_t
+  {
+    return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(database.get(), "SELECT 1"));
+  }
+}  // unnamed namespace
+
+TEST(thread_bound_database_tests, is_opened_without_mutex)
+{
+  const auto database{sqlite_wrapper::open_thread_bound(in_memory_database)};
+
+  ASSERT_EQ(database.owner(), std::this_thread::get_id());
+  ASSERT_EQ(select_one(database), 1);
+
+  // sqlite3_db_mutex() returns nullptr for connections without mutex, it always does if SQLite has no mutexes at all
+  ASSERT_EQ(::sqlite3_db_mutex(database.get()), nullptr);
+}
+
+TEST(thread_bound_database_tests, use_by_other_thread_fails)
+{
+  if constexpr (!sqlite_wrapper::are_thread_ownership_checks_enabled())
+  {
+    GTEST_SKIP() << "thread ownership checks are disabled";
+  }
+
+  const auto database{sqlite_wrapper::open_thread_bound(in_memory_database)};
+
+  bool failed{false};
+
+  std::jthread{[&]
+               {
+                 try
+                 {
+                   (void)select_one(database);
+                 }
+                 catch (const sqlite_wrapper::sqlite_error& e)
+                 {
+                   failed = (e.code() == sqlite_wrapper::sqlite_errc::misuse);
+                 }
+               }}
+      .join();
+
+  ASSERT_TRUE(failed);
+}
+
+TEST(thread_bound_database_tests, transfer_ownership)
+{
+  auto database{sqlite_wrapper::open_thread_bound(in_memory_database)};
+
+  std::int64_t result{};
+  std::jthread worker{[&]
+                      {
+                        // wait until the connection was handed over
+                        while (database.owner() != std::this_thread::get_id())
+                        {
+                          std::this_thread::yield();
+                        }
+
+                        result = select_one(database);
+                        database.transfer_ownership(std::thread::id{});
+                      }};
+
+  database.transfer_ownership(worker.get_id());
+  worker.join();
+
+  ASSERT_EQ(result, 1);
+  ASSERT_EQ(database.owner(), std::thread::id{});
+
+  // an unowned connection can be taken by any thread
+  database.transfer_ownership();
+  ASSERT_EQ(database.owner(), std::this_thread::get_id());
+  ASSERT_EQ(select_one(database), 1);
+}
+
+TEST(thread_bound_database_tests, transfer_ownership_by_other_thread_fails)
+{
+  auto database{sqlite_wrapper::open_thread_bound(in_memory_database)};
+
+  bool failed{false};
+
+  std::jthread{[&]
+               {
+                 try
+                 {
+                   database.transfer_ownership();
+                 }
+                 catch (const sqlite_wrapper::sqlite_error& e)
+                 {
+                   failed = (e.code() == sqlite_wrapper::sqlite_errc::misuse);
+                 }
+               }}
+      .join();
+
+  ASSERT_TRUE(failed);
+  ASSERT_EQ(database.owner(), std::this_thread::get_id());
+}
+
+TEST(thread_bound_database_tests, release)
+{
+  auto database{sqlite_wrapper::open_thread_bound(in_memory_database)};
+  auto* const handle{database.get()};
+
+  const auto released{database.release()};
+
+  ASSERT_EQ(released.get(), handle);
+  ASSERT_EQ(database.owner(), std::thread::id{});
+}
@@ -0,0 +1,137 @@
+#include "assert_throws_with_msg.h"
+#include "lock_contention_test.h"
+
+#include "sqlite_wrapper/error_code.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+#include "sqlite_wrapper/transaction.h"
+#include "sqlite_wrapper/transaction_retry.h"
+
+#include <sqlite3.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+using ::testing::StartsWith;
+
+namespace
+{
+  class transaction_retry_tests : public sqlite_wrapper::lock_contention_test
+  {
+   protected:
+    transaction_retry_tests()
+        : lock_contention_test{"sqlite_wrapper_transaction_retry_test.db", "CREATE TABLE Test (Id INTEGER PRIMARY KEY)"}
+    {
+    }
+  };
+}  // unnamed namespace
+
+TEST(transaction_retry, transient_errors)
+{
+  static_assert(sqlite_wrapper::is_transient_error(sqlite_wrapper::sqlite_errc::busy));
+  static_assert(sqlite_wrapper::is_transient_error(sqlite_wrapper::sqlite_errc::busy_snapshot));
+  static_assert(sqlite_wrapper::is_transient_error(sqlite_wrapper::sqlite_errc::locked));
+  static_assert(sqlite_wrapper::is_transient_error(sqlite_wrapper::sqlite_errc::locked_sharedcache));
+  static_assert(!sqlite_wrapper::is_transient_error(sqlite_wrapper::sqlite_errc::constraint));
+  static_assert(!sqlite_wrapper::is_transient_error(sqlite_wrapper::sqlite_errc::ok));
+}
+
+TEST_F(transaction_retry_tests, retries_until_lock_is_released)
+{
+  sqlite_wrapper::retry_metrics metrics;
+
+  sqlite_wrapper::execute_no_data(m_lock_holder.get(), "BEGIN EXCLUSIVE");
+
+  std::jthread lock_holder{[&]
+                           {
+                             std::this_thread::sleep_for(20ms);
+                             sqlite_wrapper::execute_no_data(m_lock_holder.get(), "COMMIT");
+                           }};
+
+  const auto result{sqlite_wrapper::run_in_transaction(
+      m_database.get(),
+      [](::sqlite3* database)
+      {
+        sqlite_wrapper::execute_no_data(database, "INSERT INTO Test VALUES (1)");
+        return 42;
+      },
+      {.max_attempts = 100}, &metrics)};
+
+  ASSERT_EQ(result, 42);
+  ASSERT_EQ(metrics.transactions, 1U);
+  ASSERT_GT(metrics.retries, 0U);
+  ASSERT_EQ(metrics.attempts, metrics.retries + 1);
+  ASSERT_EQ(metrics.give_ups, 0U);
+  ASSERT_GT(metrics.backoff_time.count(), 0);
+}
+
+TEST_F(transaction_retry_tests, gives_up_after_max_attempts)
+{
+  sqlite_wrapper::retry_metrics metrics;
+  sqlite_wrapper::transaction_statements statements{m_database.get()};
+
+  sqlite_wrapper::execute_no_data(m_lock_holder.get(), "BEGIN EXCLUSIVE");
+
+  try
+  {
+    sqlite_wrapper::run_in_transaction(statements, [](::sqlite3*) {}, {.max_attempts = 3}, &metrics);
+    FAIL() << "expected sqlite_error";
+  }
+  catch (const sqlite_wrapper::sqlite_error& e)
+  {
+    ASSERT_EQ(e.code(), sqlite_wrapper::sqlite_errc::busy);
+  }
+
+  ASSERT_EQ(metrics.attempts, 3U);
+  ASSERT_EQ(metrics.retries, 2U);
+  ASSERT_EQ(metrics.give_ups, 1U);
+}
+
+TEST_F(transaction_retry_tests, last_attempt_counts_as_wasted_time)
+{
+  sqlite_wrapper::retry_metrics metrics;
+  sqlite_wrapper::transaction_statements statements{m_database.get()};
+
+  sqlite_wrapper::execute_no_data(m_lock_holder.get(), "BEGIN EXCLUSIVE");
+
+  ASSERT_THROW(sqlite_wrapper::run_in_transaction(statements, [](::sqlite3*) {}, {.max_attempts = 1}, &metrics),
+               sqlite_wrapper::sqlite_error);
+
+  ASSERT_EQ(metrics.retries, 0U);
+  ASSERT_EQ(metrics.give_ups, 1U);
+  ASSERT_GT(metrics.wasted_time.count(), 0);
+}
+
+TEST_F(transaction_retry_tests, other_errors_are_not_retried)
+{
+  sqlite_wrapper::retry_metrics metrics;
+  sqlite_wrapper::transaction_statements statements{m_database.get()};
+
+  const auto insert{[](::sqlite3* database) { sqlite_wrapper::execute_no_data(database, "INSERT INTO Test VALUES (1)"); }};
+
+  sqlite_wrapper::run_in_transaction(statements, insert, {}, &metrics);
+
+  ASSERT_THROWS_WITH_MSG([&] { sqlite_wrapper::run_in_transaction(statements, insert, {}, &metrics); },
+                         sqlite_wrapper::sqlite_error, StartsWith("failed to step, failed with: UNIQUE constraint failed"));
+  ASSERT_THROW(sqlite_wrapper::run_in_transaction(statements, [](::sqlite3*) { throw std::runtime_error("failed"); }, {},
+                                                  &metrics),
+               std::runtime_error);
+
+  ASSERT_EQ(metrics.transactions, 3U);
+  ASSERT_EQ(metrics.attempts, 3U);
+  ASSERT_EQ(metrics.retries, 0U);
+  ASSERT_EQ(::sqlite3_get_autocommit(m_database.get()), 1);
+}
+
+TEST_F(transaction_retry_tests, invalid_policy_fails)
+{
+  ASSERT_THROWS_WITH_MSG([this] { sqlite_wrapper::run_in_transaction(m_database.get(), [](::sqlite3*) {}, {.max_attempts = 0}); },
+                         sqlite_wrapper::sqlite_error, StartsWith("invalid retry_policy, max_attempts must be > 0"));
+  ASSERT_THROWS_WITH_MSG([this] { sqlite_wrapper::run_in_transaction(m_database.get(), [](::sqlite3*) {}, {.multiplier = 0.5}); },
+                         sqlite_wrapper::sqlite_error, StartsWith("invalid retry_policy, multiplier must be >= 1.0"));
+}
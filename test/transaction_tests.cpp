@@ -0,0 +1,186 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+#include "sqlite_wrapper/transaction.h"
+
+#include <sqlite3.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <tuple>
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class transaction_tests : public Test
+  {
+   protected:
+    void SetUp() override
+    {
+      sqlite_wrapper::execute_no_data(m_database.get(), "CREATE TABLE Test (Id INTEGER)");
+    }
+
+    [[nodiscard]] auto count_rows() const -> std::int64_t
+    {
+      return std::get<0>(
+          sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(m_database.get(), "SELECT COUNT(*) FROM Test"));
+    }
+
+    void insert(std::int64_t id) const
+    {
+      sqlite_wrapper::execute_no_data(m_database.get(), "INSERT INTO Test VALUES (?)", id);
+    }
+
+    [[nodiscard]] auto count_prepared_statements() const -> int
+    {
+      int count{0};
+
+      for (auto* stmt{::sqlite3_next_stmt(m_database.get(), nullptr)}; stmt != nullptr;
+           stmt = ::sqlite3_next_stmt(m_database.get(), stmt))
+      {
+        ++count;
+      }
+
+      return count;
+    }
+
+    sqlite_wrapper::database m_database{sqlite_wrapper::open(":memory:")};
+    sqlite_wrapper::transaction_statements m_statements{m_database.get()};
+  };
+}  // unnamed namespace
+
+TEST_F(transaction_tests, committed_transaction_is_kept)
+{
+  {
+    sqlite_wrapper::transaction transaction{m_statements};
+
+    insert(1);
+
+    ASSERT_TRUE(transaction.is_active());
+    transaction.commit();
+    ASSERT_FALSE(transaction.is_active());
+  }
+
+  ASSERT_EQ(count_rows(), 1);
+}
+
+TEST_F(transaction_tests, transaction_is_rolled_back_if_not_committed)
+{
+  {
+    const sqlite_wrapper::transaction transaction{m_statements, sqlite_wrapper::transaction_mode::immediate};
+
+    ASSERT_EQ(::sqlite3_txn_state(m_database.get(), nullptr), SQLITE_TXN_WRITE);
+
+    insert(1);
+  }
+
+  ASSERT_EQ(count_rows(), 0);
+  ASSERT_EQ(::sqlite3_get_autocommit(m_database.get()), 1);
+
+  {
+    sqlite_wrapper::transaction transaction{m_statements, sqlite_wrapper::transaction_mode::exclusive};
+
+    insert(1);
+    transaction.rollback();
+
+    ASSERT_THROWS_WITH_MSG([&transaction] { transaction.commit(); }, sqlite_wrapper::sqlite_error,
+                           StartsWith("transaction is not active"));
+  }
+
+  ASSERT_EQ(count_rows(), 0);
+}
+
+TEST_F(transaction_tests, nested_transaction_fails)
+{
+  const sqlite_wrapper::transaction transaction{m_statements};
+
+  ASSERT_THROWS_WITH_MSG([this] { const sqlite_wrapper::transaction nested{m_statements}; }, sqlite_wrapper::sqlite_error,
+                         StartsWith("failed to step, failed with: cannot start a transaction within a transaction"));
+}
+
+TEST_F(transaction_tests, nested_savepoints_roll_back_independently)
+{
+  sqlite_wrapper::transaction transaction{m_statements};
+
+  insert(1);
+
+  {
+    sqlite_wrapper::savepoint outer{m_statements};
+
+    insert(2);
+
+    {
+      const sqlite_wrapper::savepoint inner{m_statements};
+
+      insert(3);
+
+      ASSERT_EQ(m_statements.savepoint_depth(), 2U);
+      ASSERT_THROWS_WITH_MSG([&outer] { outer.release(); }, sqlite_wrapper::sqlite_error,
+                             StartsWith("savepoint at depth 1 is not the innermost savepoint, the depth is 2"));
+    }
+
+    ASSERT_EQ(count_rows(), 2);
+    outer.release();
+  }
+
+  {
+    sqlite_wrapper::savepoint rolled_back{m_statements};
+
+    insert(4);
+    rolled_back.rollback();
+
+    ASSERT_THROWS_WITH_MSG([&rolled_back] { rolled_back.release(); }, sqlite_wrapper::sqlite_error,
+                           StartsWith("savepoint is not active"));
+  }
+
+  transaction.commit();
+
+  ASSERT_EQ(count_rows(), 2);
+  ASSERT_EQ(m_statements.savepoint_depth(), 0U);
+}
+
+TEST_F(transaction_tests, savepoint_outside_of_transaction_starts_one)
+{
+  {
+    sqlite_wrapper::savepoint savepoint{m_statements};
+
+    insert(1);
+
+    ASSERT_EQ(::sqlite3_get_autocommit(m_database.get()), 0);
+    savepoint.release();
+  }
+
+  ASSERT_EQ(::sqlite3_get_autocommit(m_database.get()), 1);
+  ASSERT_EQ(count_rows(), 1);
+}
+
+TEST_F(transaction_tests, statements_are_prepared_once)
+{
+  {
+    sqlite_wrapper::transaction transaction{m_statements};
+    sqlite_wrapper::savepoint savepoint{m_statements};
+
+    savepoint.release();
+    transaction.commit();
+  }
+
+  const auto prepared_statements{count_prepared_statements()};
+
+  for (int i{0}; i < 10; ++i)
+  {
+    sqlite_wrapper::transaction transaction{m_statements};
+    sqlite_wrapper::savepoint savepoint{m_statements};
+
+    insert(i);
+
+    savepoint.release();
+    transaction.commit();
+  }
+
+  ASSERT_EQ(count_prepared_statements(), prepared_statements);
+  ASSERT_EQ(count_rows(), 10);
+}
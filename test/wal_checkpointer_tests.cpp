@@ -0,0 +1,175 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/memory_database.h"
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+#include "sqlite_wrapper/wal_checkpointer.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+#include <tuple>
+
+using namespace std::chrono_literals;
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class wal_checkpointer_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+   protected:
+    void SetUp() override
+    {
+      remove_database_files();
+
+      m_database = sqlite_wrapper::open(temp_db_file_name.string(),
+                                        {.journal = sqlite_wrapper::journal_mode::wal, .busy_timeout = 5000ms});
+      sqlite_wrapper::execute_no_data(m_database.get(), "CREATE TABLE Test (Id INTEGER)");
+    }
+
+    void TearDown() override
+    {
+      m_database.reset();
+      remove_database_files();
+    }
+
+    static void remove_database_files()
+    {
+      std::filesystem::remove(temp_db_file_name);
+      std::filesystem::remove(temp_db_file_name.string() + "-wal");
+      std::filesystem::remove(temp_db_file_name.string() + "-shm");
+    }
+
+    void insert_rows(int count)
+    {
+      for (int id{0}; id < count; ++id)
+      {
+        sqlite_wrapper::execute_no_data(m_database.get(), "INSERT INTO Test VALUES (?1)", id);
+      }
+    }
+
+    // waits up to a second for the background thread
+    static auto wait_for(const std::function<bool()>& condition) -> bool
+    {
+      for (int i{0}; (i < 100) && !condition(); ++i)
+      {
+        std::this_thread::sleep_for(10ms);
+      }
+
+      return condition();
+    }
+
+    [[nodiscard]] auto get_autocheckpoint() const -> std::int64_t
+    {
+      return std::get<0>(
+          sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(m_database.get(), "PRAGMA wal_autocheckpoint"));
+    }
+
+    sqlite_wrapper::database m_database;
+  };
+
+  const std::filesystem::path wal_checkpointer_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                        "sqlite_wrapper_wal_checkpointer_test.db"};
+}  // unnamed namespace
+
+TEST_F(wal_checkpointer_tests, commits_trigger_passive_checkpoints)
+{
+  sqlite_wrapper::wal_checkpointer checkpointer{m_database.get(), {.passive_frames = 10}};
+
+  insert_rows(5);
+
+  ASSERT_EQ(checkpointer.get_metrics().passive_checkpoints, 0U);
+
+  insert_rows(5);
+
+  ASSERT_TRUE(wait_for([&checkpointer] { return checkpointer.get_metrics().checkpointed_frames >= 10; }));
+
+  const auto metrics{checkpointer.get_metrics()};
+
+  ASSERT_EQ(metrics.commits, 10U);
+  ASSERT_GE(metrics.passive_checkpoints, 1U);
+  ASSERT_EQ(metrics.restart_checkpoints, 0U);
+  ASSERT_EQ(metrics.failed_checkpoints, 0U);
+  ASSERT_GE(metrics.wal_frames, 10);
+  ASSERT_GE(metrics.max_wal_frames, metrics.wal_frames);
+}
+
+TEST_F(wal_checkpointer_tests, request_checkpoint_runs_checkpoint)
+{
+  sqlite_wrapper::wal_checkpointer checkpointer{m_database.get()};
+
+  insert_rows(5);
+
+  checkpointer.request_checkpoint();
+
+  ASSERT_TRUE(wait_for([&checkpointer] { return checkpointer.get_metrics().passive_checkpoints == 1U; }));
+  ASSERT_EQ(checkpointer.get_metrics().checkpointed_frames, checkpointer.get_metrics().wal_frames);
+}
+
+TEST_F(wal_checkpointer_tests, long_reader_escalates_to_restart)
+{
+  sqlite_wrapper::wal_checkpointer checkpointer{
+      m_database.get(), {.passive_frames = 1, .restart_frames = 10, .truncate_frames = 0, .busy_timeout = 10ms}};
+
+  const auto reader{sqlite_wrapper::open(temp_db_file_name.string(), {.flags = sqlite_wrapper::open_flags::open_only})};
+
+  sqlite_wrapper::execute_no_data(reader.get(), "BEGIN");
+  std::ignore = sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(reader.get(), "SELECT COUNT(*) FROM Test");
+
+  insert_rows(20);
+
+  ASSERT_TRUE(wait_for([&checkpointer] { return checkpointer.get_metrics().busy_checkpoints > 0U; }));
+  ASSERT_GT(checkpointer.get_metrics().restart_checkpoints, 0U);
+  ASSERT_EQ(checkpointer.get_metrics().truncate_checkpoints, 0U);
+
+  sqlite_wrapper::execute_no_data(reader.get(), "COMMIT");
+}
+
+TEST_F(wal_checkpointer_tests, automatic_checkpoints_are_restored)
+{
+  {
+    const sqlite_wrapper::wal_checkpointer checkpointer{m_database.get()};
+  }
+
+  ASSERT_EQ(get_autocheckpoint(), 1000);
+
+  std::ignore = sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(m_database.get(), "PRAGMA wal_autocheckpoint = 0");
+
+  {
+    const sqlite_wrapper::wal_checkpointer checkpointer{m_database.get()};
+  }
+
+  ASSERT_EQ(get_autocheckpoint(), 0);
+}
+
+TEST_F(wal_checkpointer_tests, invalid_database_fails)
+{
+  const auto memory{sqlite_wrapper::open_memory()};
+
+  ASSERT_THROWS_WITH_MSG([&memory] { const sqlite_wrapper::wal_checkpointer checkpointer(memory.get()); },
+                         sqlite_wrapper::sqlite_error, StartsWith("wal_checkpointer needs a database file"));
+
+  std::ignore = sqlite_wrapper::execute_one_row<std::tuple<std::string>>(m_database.get(), "PRAGMA journal_mode = DELETE");
+
+  ASSERT_THROWS_WITH_MSG([this] { const sqlite_wrapper::wal_checkpointer checkpointer(m_database.get()); },
+                         sqlite_wrapper::sqlite_error, StartsWith("wal_checkpointer needs a database in WAL mode"));
+}
+
+TEST_F(wal_checkpointer_tests, invalid_options_fail)
+{
+  ASSERT_THROWS_WITH_MSG([this] { const sqlite_wrapper::wal_checkpointer checkpointer(m_database.get(), {.passive_frames = 0}); },
+                         sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid wal_checkpointer_options, passive_frames must be > 0"));
+}
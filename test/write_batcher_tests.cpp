@@ -0,0 +1,156 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/open_options.h"
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+#include "sqlite_wrapper/write_batcher.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <thread>
+#include <tuple>
+
+using namespace std::chrono_literals;
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class write_batcher_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+   protected:
+    void SetUp() override
+    {
+      remove_database_files();
+
+      m_database = sqlite_wrapper::open(temp_db_file_name.string(), {.journal = sqlite_wrapper::journal_mode::wal});
+      sqlite_wrapper::execute_no_data(m_database.get(), "CREATE TABLE Test (Id INTEGER PRIMARY KEY)");
+    }
+
+    void TearDown() override
+    {
+      m_database.reset();
+      remove_database_files();
+    }
+
+    static void remove_database_files()
+    {
+      std::filesystem::remove(temp_db_file_name);
+      std::filesystem::remove(temp_db_file_name.string() + "-wal");
+      std::filesystem::remove(temp_db_file_name.string() + "-shm");
+    }
+
+    // counts the committed rows through a second connection
+    [[nodiscard]] static auto count_committed_rows() -> std::int64_t
+    {
+      return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(
+          sqlite_wrapper::open(temp_db_file_name.string()).get(), "SELECT COUNT(*) FROM Test"));
+    }
+
+    sqlite_wrapper::database m_database;
+  };
+
+  const std::filesystem::path write_batcher_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                     "sqlite_wrapper_write_batcher_test.db"};
+}  // unnamed namespace
+
+TEST_F(write_batcher_tests, commits_after_max_statements_and_on_flush)
+{
+  sqlite_wrapper::write_batcher batcher{m_database.get(), {.max_statements = 10, .max_delay = 0ms}};
+
+  for (std::int64_t id{0}; id < 25; ++id)
+  {
+    batcher.execute_no_data("INSERT INTO Test VALUES (?)", id);
+  }
+
+  ASSERT_EQ(batcher.pending_statements(), 5U);
+  ASSERT_EQ(count_committed_rows(), 20);
+
+  batcher.flush();
+
+  ASSERT_EQ(batcher.pending_statements(), 0U);
+  ASSERT_EQ(count_committed_rows(), 25);
+
+  const auto metrics{batcher.get_metrics()};
+
+  ASSERT_EQ(metrics.statements, 25U);
+  ASSERT_EQ(metrics.commits, 3U);
+}
+
+TEST_F(write_batcher_tests, commits_after_max_delay)
+{
+  sqlite_wrapper::write_batcher batcher{m_database.get(), {.max_delay = 20ms}};
+
+  batcher.execute_no_data("INSERT INTO Test VALUES (1)");
+
+  ASSERT_EQ(count_committed_rows(), 0);
+
+  for (int i{0}; (i < 100) && (batcher.pending_statements() > 0); ++i)
+  {
+    std::this_thread::sleep_for(10ms);
+  }
+
+  ASSERT_EQ(batcher.pending_statements(), 0U);
+  ASSERT_EQ(count_committed_rows(), 1);
+}
+
+TEST_F(write_batcher_tests, destructor_commits_open_batch)
+{
+  {
+    sqlite_wrapper::write_batcher batcher{m_database.get()};
+
+    batcher.execute_no_data("INSERT INTO Test VALUES (1)");
+  }
+
+  ASSERT_EQ(count_committed_rows(), 1);
+}
+
+TEST_F(write_batcher_tests, failed_statement_keeps_batch)
+{
+  sqlite_wrapper::write_batcher batcher{m_database.get(), {.max_delay = 0ms}};
+
+  batcher.execute_no_data("INSERT INTO Test VALUES (1)");
+
+  ASSERT_THROWS_WITH_MSG([&batcher] { batcher.execute_no_data("INSERT INTO Test VALUES (1)"); }, sqlite_wrapper::sqlite_error,
+                         StartsWith("failed to step, failed with: UNIQUE constraint failed"));
+  ASSERT_EQ(batcher.pending_statements(), 1U);
+
+  batcher.flush();
+
+  ASSERT_EQ(count_committed_rows(), 1);
+}
+
+TEST_F(write_batcher_tests, statements_in_explicit_transaction_are_not_batched)
+{
+  sqlite_wrapper::write_batcher batcher{m_database.get(), {.max_delay = 0ms}};
+
+  sqlite_wrapper::execute_no_data(m_database.get(), "BEGIN");
+  batcher.execute_no_data("INSERT INTO Test VALUES (1)");
+
+  ASSERT_EQ(batcher.pending_statements(), 0U);
+
+  sqlite_wrapper::execute_no_data(m_database.get(), "COMMIT");
+
+  ASSERT_EQ(count_committed_rows(), 1);
+}
+
+TEST_F(write_batcher_tests, invalid_options_fail)
+{
+  ASSERT_THROWS_WITH_MSG([this] { const sqlite_wrapper::write_batcher batcher(m_database.get(), {.max_statements = 0}); },
+                         sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid write_batcher_options, max_statements must be > 0"));
+
+  const auto no_mutex_database{sqlite_wrapper::open(temp_db_file_name.string(), {.no_mutex = true})};
+
+  ASSERT_THROWS_WITH_MSG([&no_mutex_database] { const sqlite_wrapper::write_batcher batcher(no_mutex_database.get()); },
+                         sqlite_wrapper::sqlite_error,
+                         StartsWith("write_batcher with max_delay needs a connection with mutex"));
+}
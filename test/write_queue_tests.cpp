@@ -0,0 +1,177 @@
+#include "assert_throws_with_msg.h"
+
+#include "sqlite_wrapper/sqlite_error.h"
+#include "sqlite_wrapper/sqlite_wrapper.h"
+#include "sqlite_wrapper/write_queue.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+using ::testing::StartsWith;
+using ::testing::Test;
+
+namespace
+{
+  class write_queue_tests : public Test
+  {
+   public:
+    static const std::filesystem::path temp_db_file_name;
+
+   protected:
+    void SetUp() override
+    {
+      remove_database_files();
+
+      sqlite_wrapper::execute_no_data(sqlite_wrapper::open(temp_db_file_name.string()).get(),
+                                      "CREATE TABLE Test (Id INTEGER PRIMARY KEY, Name TEXT)");
+    }
+
+    void TearDown() override
+    {
+      remove_database_files();
+    }
+
+    static void remove_database_files()
+    {
+      std::filesystem::remove(temp_db_file_name);
+      std::filesystem::remove(temp_db_file_name.string() + "-wal");
+      std::filesystem::remove(temp_db_file_name.string() + "-shm");
+    }
+
+    [[nodiscard]] static auto count_rows() -> std::int64_t
+    {
+      return std::get<0>(sqlite_wrapper::execute_one_row<std::tuple<std::int64_t>>(
+          sqlite_wrapper::open(temp_db_file_name.string()).get(), "SELECT COUNT(*) FROM Test"));
+    }
+  };
+
+  const std::filesystem::path write_queue_tests::temp_db_file_name{std::filesystem::temp_directory_path() /
+                                                                   "sqlite_wrapper_write_queue_test.db"};
+}  // unnamed namespace
+
+TEST_F(write_queue_tests, writes_of_concurrent_producers_are_committed_in_groups)
+{
+  constexpr std::size_t producer_count{8};
+  constexpr std::size_t writes_per_producer{250};
+  constexpr std::size_t max_batch_size{32};
+
+  sqlite_wrapper::write_queue queue{temp_db_file_name.string(), {.max_batch_size = max_batch_size, .max_batch_delay = 1ms}};
+
+  std::vector<std::vector<std::future<void>>> futures(producer_count);
+
+  {
+    std::vector<std::jthread> producers;
+
+    for (auto& producer_futures : futures)
+    {
+      producers.emplace_back(
+          [&]
+          {
+            for (std::size_t i{0}; i < writes_per_producer; ++i)
+            {
+              producer_futures.push_back(queue.submit("INSERT INTO Test (Name) VALUES (?)", std::string{"name"}));
+            }
+          });
+    }
+  }
+
+  for (auto& producer_futures : futures)
+  {
+    for (auto& future : producer_futures)
+    {
+      ASSERT_NO_THROW(future.get());
+    }
+  }
+
+  const auto metrics{queue.get_metrics()};
+
+  ASSERT_EQ(metrics.submitted, producer_count * writes_per_producer);
+  ASSERT_EQ(metrics.succeeded, producer_count * writes_per_producer);
+  ASSERT_EQ(metrics.failed, 0U);
+  ASSERT_LE(metrics.largest_batch, max_batch_size);
+  ASSERT_LT(metrics.transactions, metrics.succeeded);
+  ASSERT_EQ(count_rows(), static_cast<std::int64_t>(producer_count * writes_per_producer));
+}
+
+TEST_F(write_queue_tests, failed_write_does_not_affect_other_writes)
+{
+  sqlite_wrapper::write_queue queue{temp_db_file_name.string(), {.max_batch_delay = 10ms}};
+
+  auto first{queue.submit("INSERT INTO Test (Id, Name) VALUES (?, ?)", 1, "first")};
+  auto duplicate{queue.submit("INSERT INTO Test (Id, Name) VALUES (?, ?)", 1, "duplicate")};
+  auto throwing{queue.submit(
+      [](::sqlite3* database)
+      {
+        sqlite_wrapper::execute_no_data(database, "INSERT INTO Test (Name) VALUES ('rolled back')");
+        throw std::runtime_error("write failed");
+      })};
+  auto last{queue.submit([](::sqlite3* database)
+                         { sqlite_wrapper::execute_no_data(database, "INSERT INTO Test (Id, Name) VALUES (2, 'last')"); })};
+
+  ASSERT_NO_THROW(first.get());
+  ASSERT_THROWS_WITH_MSG([&duplicate] { duplicate.get(); }, sqlite_wrapper::sqlite_error, StartsWith("failed to step"));
+  ASSERT_THROWS_WITH_MSG([&throwing] { throwing.get(); }, std::runtime_error, StartsWith("write failed"));
+  ASSERT_NO_THROW(last.get());
+
+  const auto metrics{queue.get_metrics()};
+
+  ASSERT_EQ(metrics.succeeded, 2U);
+  ASSERT_EQ(metrics.failed, 2U);
+  ASSERT_EQ(count_rows(), 2);
+}
+
+TEST_F(write_queue_tests, failed_begin_does_not_affect_later_writes)
+{
+  sqlite_wrapper::write_queue queue{temp_db_file_name.string(), {.connection_options = {}}};
+
+  {
+    const auto locker{sqlite_wrapper::open(temp_db_file_name.string())};
+
+    sqlite_wrapper::execute_no_data(locker.get(), "BEGIN EXCLUSIVE");
+
+    auto locked{queue.submit("INSERT INTO Test (Id) VALUES (1)")};
+
+    ASSERT_THROW(locked.get(), sqlite_wrapper::sqlite_error);
+  }
+
+  auto unlocked{queue.submit("INSERT INTO Test (Id) VALUES (2)")};
+
+  ASSERT_NO_THROW(unlocked.get());
+  ASSERT_EQ(count_rows(), 1);
+}
+
+TEST_F(write_queue_tests, destructor_executes_pending_writes)
+{
+  constexpr std::int64_t write_count{100};
+
+  {
+    sqlite_wrapper::write_queue queue{temp_db_file_name.string()};
+
+    for (std::int64_t i{0}; i < write_count; ++i)
+    {
+      std::ignore = queue.submit("INSERT INTO Test (Id) VALUES (?)", i);
+    }
+  }
+
+  ASSERT_EQ(count_rows(), write_count);
+}
+
+TEST_F(write_queue_tests, invalid_batch_size_fails)
+{
+  ASSERT_THROWS_WITH_MSG([] { const sqlite_wrapper::write_queue queue(temp_db_file_name.string(), {.max_batch_size = 0}); },
+                         sqlite_wrapper::sqlite_error,
+                         StartsWith("invalid write_queue_options for database \"" + temp_db_file_name.string() +
+                                    "\", max_batch_size must be > 0"));
+}